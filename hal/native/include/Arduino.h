@@ -0,0 +1,138 @@
+#ifndef HAL_NATIVE_ARDUINO_H
+#define HAL_NATIVE_ARDUINO_H
+
+/**
+ * Host build of the Arduino core surface used by the firmware
+ *
+ * Only what the natively built sources need: String, Serial (stdout),
+ * timing (see hal_native.h for the manual clock), GPIO levels held in
+ * memory, and an ESP object with plausible heap figures.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <algorithm>
+#include "WString.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#define HIGH           0x1
+#define LOW            0x0
+#define INPUT          0x01
+#define OUTPUT         0x03
+#define INPUT_PULLUP   0x05
+#define INPUT_PULLDOWN 0x09
+
+#define PI       3.1415926535897932384626433832795
+#define DEC      10
+#define HEX      16
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+void* ps_malloc(size_t size);
+
+// Wall clock: the firmware sets the time with settimeofday(), which must
+// not touch the host clock, so these calls go to a process-local clock
+// (see HalNative::setWallClock)
+time_t hal_time(time_t* out);
+int hal_gettimeofday(struct timeval* tv, void* tz);
+int hal_settimeofday(const struct timeval* tv, const void* tz);
+#define time(out)              hal_time(out)
+#define gettimeofday(tv, tz)   hal_gettimeofday(tv, tz)
+#define settimeofday(tv, tz)   hal_settimeofday(tv, tz)
+
+// LEDC (Arduino API); duty is recorded per channel, see HalNative::ledcDuty()
+uint32_t ledcSetup(uint8_t channel, uint32_t frequency, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+// ============================================
+// Print / Serial
+// ============================================
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    size_t println() { return write("\r\n"); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+/**
+ * Serial port on stdout; input comes from HalNative::serialInput()
+ */
+class HostSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available();
+    int read();
+    int availableForWrite() { return 128; }
+    void flush() { fflush(stdout); }
+    String readStringUntil(char terminator);
+    operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+// ============================================
+// ESP object
+// ============================================
+
+class EspClass {
+public:
+    uint32_t getCycleCount();       // Nanosecond-based stand-in for CCOUNT (240 cycles per us)
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize() { return 320 * 1024; }
+    uint32_t getPsramSize() { return 4 * 1024 * 1024; }
+    uint32_t getFreePsram() { return getPsramSize(); }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // HAL_NATIVE_ARDUINO_H
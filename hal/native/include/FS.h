@@ -0,0 +1,75 @@
+#ifndef HAL_NATIVE_FS_H
+#define HAL_NATIVE_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+/**
+ * Filesystem API backed by a host directory (see HalNative::setFsRoot)
+ *
+ * Behaves like SPIFFS: paths are flat names that may contain '/', parent
+ * directories are created on write, and opening a "directory" lists
+ * every file below that prefix.
+ */
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class FileImpl;
+
+class File {
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : _impl(impl) {}
+
+    operator bool() const;
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size);
+    int read();
+    size_t read(uint8_t* buffer, size_t size);
+    int available();
+    int peek();
+    void flush();
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char* path() const;
+    const char* name() const;  // Filename without directory
+    bool isDirectory() const;
+    File openNextFile(const char* mode = "r");
+
+private:
+    std::shared_ptr<FileImpl> _impl;
+};
+
+class FS {
+public:
+    virtual ~FS() {}
+    File open(const char* path, const char* mode = "r", bool create = false);
+    File open(const String& path, const char* mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // HAL_NATIVE_FS_H
@@ -0,0 +1,56 @@
+#ifndef HAL_NATIVE_PREFERENCES_H
+#define HAL_NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+#include "nvs.h"
+
+/**
+ * Preferences on top of the in-memory NVS (see nvs.h)
+ */
+class Preferences {
+public:
+    Preferences() : _handle(0), _open(false), _readOnly(false) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value) { return putValue(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return putValue(key, &value, sizeof(value)); }
+    size_t putInt(const char* key, int32_t value) { return putValue(key, &value, sizeof(value)); }
+    size_t putULong(const char* key, uint32_t value) { return putValue(key, &value, sizeof(value)); }
+    size_t putULong64(const char* key, uint64_t value) { return putValue(key, &value, sizeof(value)); }
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    size_t putBytes(const char* key, const void* value, size_t length) { return putValue(key, value, length); }
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return getValue(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+    uint64_t getULong64(const char* key, uint64_t defaultValue = 0) { return getValue(key, defaultValue); }
+    bool getBool(const char* key, bool defaultValue = false) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+
+private:
+    nvs_handle_t _handle;
+    bool _open;
+    bool _readOnly;
+
+    size_t putValue(const char* key, const void* value, size_t length);
+
+    template <typename T>
+    T getValue(const char* key, T defaultValue) {
+        T value;
+        return (getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T)) == sizeof(T)) ? value : defaultValue;
+    }
+};
+
+#endif // HAL_NATIVE_PREFERENCES_H
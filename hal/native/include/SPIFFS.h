@@ -0,0 +1,22 @@
+#ifndef HAL_NATIVE_SPIFFS_H
+#define HAL_NATIVE_SPIFFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = nullptr);
+    void end() {}
+    bool format();
+    size_t totalBytes();  // HalNative::setFsCapacity, 1.5 MB by default
+    size_t usedBytes();   // Sum of file sizes under the root
+};
+
+} // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif // HAL_NATIVE_SPIFFS_H
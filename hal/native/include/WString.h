@@ -0,0 +1,105 @@
+#ifndef HAL_NATIVE_WSTRING_H
+#define HAL_NATIVE_WSTRING_H
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+/**
+ * String - host stand-in for the Arduino String class
+ *
+ * Backed by std::string; implements the subset of the Arduino API the
+ * firmware uses, with the same semantics (indices are unsigned, -1 means
+ * not found, out-of-range substrings are empty).
+ */
+class String {
+public:
+    String() {}
+    String(const char* text) : _s(text ? text : "") {}
+    String(const std::string& text) : _s(text) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int value, unsigned char base = 10) : _s(format((long)value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : _s(formatUnsigned(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : _s(format(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : _s(formatUnsigned(value, base)) {}
+    explicit String(unsigned char value, unsigned char base = 10) : _s(formatUnsigned(value, base)) {}
+    explicit String(unsigned short value, unsigned char base = 10) : _s(formatUnsigned(value, base)) {}
+    explicit String(float value, unsigned int decimals = 2) : _s(formatFloat(value, decimals)) {}
+    explicit String(double value, unsigned int decimals = 2) : _s(formatFloat(value, decimals)) {}
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _s[index]; }
+
+    bool concat(const String& other) { _s += other._s; return true; }
+    bool concat(const char* text) { if (text) _s += text; return true; }
+    bool concat(const char* text, unsigned int length) { if (text) _s.append(text, length); return true; }
+    bool concat(char c) { _s += c; return true; }
+
+    String& operator+=(const String& other) { _s += other._s; return *this; }
+    String& operator+=(const char* text) { if (text) _s += text; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int value) { _s += format(value, 10); return *this; }
+    String& operator+=(unsigned int value) { _s += formatUnsigned(value, 10); return *this; }
+    String& operator+=(long value) { _s += format(value, 10); return *this; }
+    String& operator+=(unsigned long value) { _s += formatUnsigned(value, 10); return *this; }
+
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator==(const char* text) const { return _s == (text ? text : ""); }
+    bool operator!=(const String& other) const { return _s != other._s; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+    bool operator<(const String& other) const { return _s < other._s; }
+    bool equals(const String& other) const { return _s == other._s; }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return _s.size() >= suffix._s.size() && _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return found(_s.find(c, from)); }
+    int indexOf(const String& text, unsigned int from = 0) const { return found(_s.find(text._s, from)); }
+    int lastIndexOf(char c) const { return found(_s.rfind(c)); }
+    int lastIndexOf(const String& text) const { return found(_s.rfind(text._s)); }
+
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        if (from >= _s.size()) return String();
+        return String(_s.substr(from, to - from));
+    }
+
+    void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+    void replace(char find, char with) { for (char& c : _s) if (c == find) c = with; }
+    void replace(const String& find, const String& with);
+    void toLowerCase() { for (char& c : _s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : _s) c = (char)toupper((unsigned char)c); }
+    void trim();
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return (float)atof(_s.c_str()); }
+    void toCharArray(char* buffer, unsigned int size, unsigned int from = 0) const;
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b._s); }
+    friend String operator+(const String& a, char b) { return String(a._s + b); }
+
+private:
+    std::string _s;
+
+    static int found(size_t position) { return position == std::string::npos ? -1 : (int)position; }
+    static std::string format(long value, unsigned char base);
+    static std::string formatUnsigned(unsigned long value, unsigned char base);
+    static std::string formatFloat(double value, unsigned int decimals);
+};
+
+#endif // HAL_NATIVE_WSTRING_H
@@ -0,0 +1,11 @@
+#ifndef HAL_NATIVE_ESP32_ROM_CRC_H
+#define HAL_NATIVE_ESP32_ROM_CRC_H
+
+#include <stdint.h>
+
+/**
+ * CRC-32 (IEEE, reflected), continuing from crc like the ROM routine
+ */
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif // HAL_NATIVE_ESP32_ROM_CRC_H
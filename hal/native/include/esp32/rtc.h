@@ -0,0 +1,11 @@
+#ifndef HAL_NATIVE_ESP32_RTC_H
+#define HAL_NATIVE_ESP32_RTC_H
+
+#include <stdint.h>
+
+/**
+ * RTC timer microseconds (same source as esp_timer_get_time on the host)
+ */
+uint64_t esp_rtc_get_time_us(void);
+
+#endif // HAL_NATIVE_ESP32_RTC_H
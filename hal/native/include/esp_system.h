@@ -0,0 +1,37 @@
+#ifndef HAL_NATIVE_ESP_SYSTEM_H
+#define HAL_NATIVE_ESP_SYSTEM_H
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_RST_UNKNOWN = 0,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO
+} esp_reset_reason_t;
+
+typedef void (*shutdown_handler_t)(void);
+
+/**
+ * ESP_RST_POWERON unless set with HalNative::setResetReason()
+ */
+esp_reset_reason_t esp_reset_reason(void);
+
+/**
+ * Handlers run from esp_restart() and HalNative::runShutdownHandlers()
+ */
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler);
+
+/**
+ * Runs the shutdown handlers, then exits the process
+ */
+void esp_restart(void);
+
+#endif // HAL_NATIVE_ESP_SYSTEM_H
@@ -0,0 +1,20 @@
+#ifndef HAL_NATIVE_ESP_TASK_WDT_H
+#define HAL_NATIVE_ESP_TASK_WDT_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define CONFIG_ESP_TASK_WDT_TIMEOUT_S 5  // As in the Arduino core's sdkconfig
+
+/**
+ * Task watchdog: nothing ever times out on the host; the configuration
+ * and feeds are recorded for HalNative::taskWdtTimeout()/taskWdtFeeds()
+ */
+esp_err_t esp_task_wdt_init(uint32_t timeout, bool panic);
+esp_err_t esp_task_wdt_add(TaskHandle_t handle);
+esp_err_t esp_task_wdt_delete(TaskHandle_t handle);
+esp_err_t esp_task_wdt_reset(void);
+
+#endif // HAL_NATIVE_ESP_TASK_WDT_H
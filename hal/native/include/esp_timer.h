@@ -0,0 +1,11 @@
+#ifndef HAL_NATIVE_ESP_TIMER_H
+#define HAL_NATIVE_ESP_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * Microseconds since start (follows the manual clock when enabled)
+ */
+int64_t esp_timer_get_time(void);
+
+#endif // HAL_NATIVE_ESP_TIMER_H
@@ -0,0 +1,40 @@
+#ifndef HAL_NATIVE_FREERTOS_H
+#define HAL_NATIVE_FREERTOS_H
+
+/**
+ * Host FreeRTOS subset: tasks are detached threads, semaphores are
+ * mutexes, critical sections take one process-wide lock, ticks are
+ * milliseconds
+ */
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define pdPASS          1
+#define pdFAIL          0
+#define portMAX_DELAY   0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMAX_TASK_NAME_LEN 16
+
+typedef struct {
+    volatile int owner;
+    volatile int count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)      vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)  vPortExitCritical(mux)
+
+#endif // HAL_NATIVE_FREERTOS_H
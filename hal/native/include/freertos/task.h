@@ -0,0 +1,32 @@
+#ifndef HAL_NATIVE_FREERTOS_TASK_H
+#define HAL_NATIVE_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+typedef struct HalTask* TaskHandle_t;
+
+/**
+ * Start a detached thread; stack size and priority are ignored
+ */
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+
+/**
+ * Only vTaskDelete(NULL) is supported: the calling thread exits
+ */
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char* pcTaskGetName(TaskHandle_t task);
+
+/**
+ * Host threads have no fixed stack; reports a constant
+ */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#endif // HAL_NATIVE_FREERTOS_TASK_H
@@ -0,0 +1,60 @@
+#ifndef HAL_NATIVE_H
+#define HAL_NATIVE_H
+
+#include <Arduino.h>
+
+/**
+ * HalNative - controls for the host stand-ins, used by native tests and
+ * benchmarks
+ *
+ * Time runs on the host's monotonic clock unless the manual clock is
+ * enabled, in which case millis(), micros(), esp_timer_get_time() and
+ * delay() only move through advanceMicros().
+ */
+namespace HalNative {
+
+// ---- Time ----
+void useManualClock(bool manual);
+void advanceMicros(uint64_t us);
+void advanceMillis(uint32_t ms);
+void restartRtcTimer();  // As on power-on: esp_rtc_get_time_us() counts from 0 again
+
+/**
+ * Wall clock seen by time() and gettimeofday() through settimeofday();
+ * the host clock is never changed
+ */
+void setWallClock(time_t epoch);
+
+// ---- GPIO ----
+void setPin(uint8_t pin, int level);
+int pinLevel(uint8_t pin);
+uint8_t pinModeOf(uint8_t pin);
+
+// ---- LEDC ----
+uint32_t ledcDuty(uint8_t channel);
+uint32_t ledcFadeMs(uint8_t channel);  // Fade time of the last ledc_set_fade_with_time
+uint32_t ledcWrites(uint8_t channel);  // Duty updates since reset
+
+// ---- I2S (port 0) ----
+uint32_t i2sSampleRate();
+size_t i2sCapture(uint8_t* buffer, size_t size);  // Copies up to size bytes, returns the total written
+void i2sClear();
+
+// ---- Storage ----
+void resetNvs();
+void setFsRoot(const char* directory);  // Created if missing
+void setFsCapacity(size_t bytes);      // Writes growing past it come up short (1.5 MB by default)
+void clearFs();                         // Deletes everything under the root
+
+// ---- Serial ----
+void serialInput(const char* text);     // Queued for Serial.read()
+
+// ---- System ----
+void setResetReason(int reason);        // esp_reset_reason_t
+uint32_t taskWdtTimeout();              // Seconds, from the last esp_task_wdt_init()
+uint32_t taskWdtFeeds();                // esp_task_wdt_reset() calls
+void runShutdownHandlers();
+
+} // namespace HalNative
+
+#endif // HAL_NATIVE_H
@@ -0,0 +1,36 @@
+#ifndef HAL_NATIVE_NVS_H
+#define HAL_NATIVE_NVS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+ * NVS in process memory, shared with Preferences (same namespaces and
+ * keys). Cleared with HalNative::resetNvs().
+ */
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode_t;
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* value);
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* value);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value);
+
+/**
+ * @param value Output buffer, or NULL to query the length (including terminator)
+ */
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* value, size_t* length);
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value);
+
+#endif // HAL_NATIVE_NVS_H
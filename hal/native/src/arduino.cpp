@@ -0,0 +1,483 @@
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include <esp32/rtc.h>
+#include <esp32/rom/crc.h>
+#include "hal_native.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The wrappers below need the host's own clock functions
+#undef time
+#undef gettimeofday
+#undef settimeofday
+
+// ============================================
+// Time
+// ============================================
+
+static const auto START = std::chrono::steady_clock::now();
+static std::atomic<bool> manualClock(false);
+static std::atomic<uint64_t> manualMicros(0);
+static std::atomic<uint64_t> rtcBaseUs(0);  // Monotonic time the RTC timer last restarted
+
+static std::mutex wallMutex;
+static bool wallSet = false;
+static int64_t wallBaseUs = 0;   // Wall clock (epoch us) at wallMonoUs
+static uint64_t wallMonoUs = 0;
+
+static uint64_t monotonicMicros() {
+    if (manualClock.load()) {
+        return manualMicros.load();
+    }
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - START).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(monotonicMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)monotonicMicros();
+}
+
+void delay(uint32_t ms) {
+    delayMicroseconds(ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    if (manualClock.load()) {
+        manualMicros.fetch_add(us);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+int64_t esp_timer_get_time(void) {
+    return (int64_t)monotonicMicros();
+}
+
+uint64_t esp_rtc_get_time_us(void) {
+    return monotonicMicros() - rtcBaseUs.load();
+}
+
+int hal_gettimeofday(struct timeval* tv, void* tz) {
+    (void)tz;
+    std::lock_guard<std::mutex> lock(wallMutex);
+    if (!wallSet) {
+        return gettimeofday(tv, nullptr);
+    }
+    int64_t us = wallBaseUs + (int64_t)(monotonicMicros() - wallMonoUs);
+    tv->tv_sec = (time_t)(us / 1000000);
+    tv->tv_usec = (suseconds_t)(us % 1000000);
+    return 0;
+}
+
+int hal_settimeofday(const struct timeval* tv, const void* tz) {
+    (void)tz;
+    if (tv) {
+        std::lock_guard<std::mutex> lock(wallMutex);
+        wallSet = true;
+        wallBaseUs = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+        wallMonoUs = monotonicMicros();
+    }
+    return 0;
+}
+
+time_t hal_time(time_t* out) {
+    struct timeval tv;
+    hal_gettimeofday(&tv, nullptr);
+    if (out) {
+        *out = tv.tv_sec;
+    }
+    return tv.tv_sec;
+}
+
+// ============================================
+// GPIO / LEDC
+// ============================================
+
+static const uint8_t PIN_COUNT = 64;
+static const uint8_t LEDC_CHANNELS = 16;
+
+static std::atomic<int> pinLevels[PIN_COUNT];
+static std::atomic<uint8_t> pinModes[PIN_COUNT];
+
+struct LedcChannel {
+    uint32_t duty;
+    uint32_t fadeTarget;
+    uint32_t fadeMs;
+    uint32_t writes;
+};
+
+static std::mutex ledcMutex;
+static LedcChannel ledcChannels[LEDC_CHANNELS];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= PIN_COUNT) {
+        return;
+    }
+    pinModes[pin] = mode;
+    // Pull-ups idle high, like an unpressed active-low button
+    if (mode == INPUT_PULLUP) {
+        pinLevels[pin] = HIGH;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < PIN_COUNT ? pinLevels[pin].load() : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < PIN_COUNT) {
+        pinLevels[pin] = level ? HIGH : LOW;
+    }
+}
+
+static void setDuty(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNELS) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    ledcChannels[channel].duty = duty;
+    ledcChannels[channel].writes++;
+}
+
+uint32_t ledcSetup(uint8_t channel, uint32_t frequency, uint8_t resolutionBits) {
+    (void)channel;
+    (void)resolutionBits;
+    return frequency;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    (void)pin;
+    (void)channel;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    setDuty(channel, duty);
+}
+
+esp_err_t ledc_fade_func_install(int intrAllocFlags) {
+    (void)intrAllocFlags;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint) {
+    (void)mode;
+    (void)hpoint;
+    if (channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    setDuty(channel, duty);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t mode, ledc_channel_t channel, uint32_t targetDuty, int maxFadeTimeMs) {
+    (void)mode;
+    if (channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    ledcChannels[channel].fadeTarget = targetDuty;
+    ledcChannels[channel].fadeMs = (uint32_t)maxFadeTimeMs;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t mode, ledc_channel_t channel, ledc_fade_mode_t fadeMode) {
+    (void)mode;
+    (void)fadeMode;
+    if (channel >= LEDC_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t target;
+    {
+        std::lock_guard<std::mutex> lock(ledcMutex);
+        target = ledcChannels[channel].fadeTarget;
+    }
+    setDuty(channel, target);
+    return ESP_OK;
+}
+
+// ============================================
+// Memory
+// ============================================
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+// ============================================
+// Print / Serial
+// ============================================
+
+HostSerial Serial;
+
+static std::mutex serialMutex;
+static std::deque<char> serialRx;
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) {
+        n++;
+    }
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    if (base == DEC) {
+        return printf("%ld", value);
+    }
+    return write(String(value, (unsigned char)base).c_str());
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return write(String(value, (unsigned char)base).c_str());
+}
+
+size_t Print::print(double value, int digits) {
+    return printf("%.*f", digits, value);
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, len);
+    }
+    std::vector<char> heapBuffer(len + 1);
+    va_start(args, format);
+    vsnprintf(heapBuffer.data(), heapBuffer.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)heapBuffer.data(), len);
+}
+
+size_t HostSerial::write(uint8_t c) {
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+int HostSerial::available() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    return (int)serialRx.size();
+}
+
+int HostSerial::read() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if (serialRx.empty()) {
+        return -1;
+    }
+    char c = serialRx.front();
+    serialRx.pop_front();
+    return (uint8_t)c;
+}
+
+String HostSerial::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+// ============================================
+// ESP / system
+// ============================================
+
+EspClass ESP;
+
+static std::atomic<int> resetReason(ESP_RST_POWERON);
+static std::atomic<uint32_t> taskWdtTimeoutS(0);
+static std::atomic<uint32_t> taskWdtFeedCount(0);
+static std::mutex shutdownMutex;
+static std::vector<shutdown_handler_t> shutdownHandlers;
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(monotonicMicros() * 240);
+}
+
+// Fixed figures in the range of a running firmware, so gauges and
+// low-memory checks see plausible values
+uint32_t EspClass::getFreeHeap() {
+    return 180 * 1024;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return 160 * 1024;
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return 110 * 1024;
+}
+
+void EspClass::restart() {
+    esp_restart();
+}
+
+esp_reset_reason_t esp_reset_reason(void) {
+    return (esp_reset_reason_t)resetReason.load();
+}
+
+esp_err_t esp_task_wdt_init(uint32_t timeout, bool panic) {
+    (void)panic;
+    taskWdtTimeoutS = timeout;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_add(TaskHandle_t handle) {
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_delete(TaskHandle_t handle) {
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset(void) {
+    taskWdtFeedCount++;
+    return ESP_OK;
+}
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) {
+    std::lock_guard<std::mutex> lock(shutdownMutex);
+    shutdownHandlers.push_back(handler);
+    return ESP_OK;
+}
+
+void esp_restart(void) {
+    HalNative::runShutdownHandlers();
+    fflush(stdout);
+    exit(0);
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                     return "ESP_OK";
+        case ESP_FAIL:                   return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:             return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:        return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:      return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_NOT_FOUND:          return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NVS_NOT_FOUND:      return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+    }
+    return "UNKNOWN ERROR";
+}
+
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================================
+// Test hooks
+// ============================================
+
+namespace HalNative {
+
+void useManualClock(bool manual) {
+    if (manual && !manualClock.load()) {
+        manualMicros = monotonicMicros();
+    }
+    manualClock = manual;
+}
+
+void advanceMicros(uint64_t us) {
+    manualMicros.fetch_add(us);
+}
+
+void advanceMillis(uint32_t ms) {
+    advanceMicros((uint64_t)ms * 1000);
+}
+
+void restartRtcTimer() {
+    rtcBaseUs = monotonicMicros();
+}
+
+void setWallClock(time_t epoch) {
+    struct timeval tv = { epoch, 0 };
+    hal_settimeofday(&tv, nullptr);
+}
+
+void setPin(uint8_t pin, int level) {
+    digitalWrite(pin, (uint8_t)level);
+}
+
+int pinLevel(uint8_t pin) {
+    return digitalRead(pin);
+}
+
+uint8_t pinModeOf(uint8_t pin) {
+    return pin < PIN_COUNT ? pinModes[pin].load() : 0;
+}
+
+uint32_t ledcDuty(uint8_t channel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    return channel < LEDC_CHANNELS ? ledcChannels[channel].duty : 0;
+}
+
+uint32_t ledcFadeMs(uint8_t channel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    return channel < LEDC_CHANNELS ? ledcChannels[channel].fadeMs : 0;
+}
+
+uint32_t ledcWrites(uint8_t channel) {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    return channel < LEDC_CHANNELS ? ledcChannels[channel].writes : 0;
+}
+
+void serialInput(const char* text) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    while (text && *text) {
+        serialRx.push_back(*text++);
+    }
+}
+
+void setResetReason(int reason) {
+    resetReason = reason;
+}
+
+uint32_t taskWdtTimeout() {
+    return taskWdtTimeoutS;
+}
+
+uint32_t taskWdtFeeds() {
+    return taskWdtFeedCount;
+}
+
+void runShutdownHandlers() {
+    std::vector<shutdown_handler_t> handlers;
+    {
+        std::lock_guard<std::mutex> lock(shutdownMutex);
+        handlers = shutdownHandlers;
+    }
+    for (shutdown_handler_t handler : handlers) {
+        handler();
+    }
+}
+
+} // namespace HalNative
@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <pthread.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ============================================
+// Tasks
+// ============================================
+
+struct HalTask {
+    char name[configMAX_TASK_NAME_LEN];
+};
+
+static HalTask mainTask = { "loopTask" };
+static thread_local HalTask* currentTask = &mainTask;
+
+struct TaskStart {
+    TaskFunction_t function;
+    void* parameters;
+    HalTask* task;
+};
+
+static BaseType_t startTask(TaskFunction_t function, const char* name, void* parameters, TaskHandle_t* handle) {
+    // Handles stay valid for the process lifetime, as code may compare them after the task ends
+    HalTask* task = new HalTask();
+    strncpy(task->name, name ? name : "", sizeof(task->name) - 1);
+    task->name[sizeof(task->name) - 1] = '\0';
+    if (handle) {
+        *handle = task;
+    }
+    TaskStart start = { function, parameters, task };
+    std::thread([start]() {
+        currentTask = start.task;
+        start.function(start.parameters);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* handle) {
+    (void)stackDepth;
+    (void)priority;
+    return startTask(function, name, parameters, handle);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)stackDepth;
+    (void)priority;
+    (void)core;
+    return startTask(function, name, parameters, handle);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL || task == currentTask) {
+        pthread_exit(nullptr);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return currentTask;
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+    return (task ? task : currentTask)->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 4096;
+}
+
+// ============================================
+// Critical sections
+// ============================================
+
+static std::recursive_mutex criticalMutex;
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    criticalMutex.lock();
+    mux->count++;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->count--;
+    criticalMutex.unlock();
+}
+
+// ============================================
+// Semaphores
+// ============================================
+
+// Both kinds are recursive on the host; the firmware never relies on a
+// plain mutex blocking its own holder
+struct HalSemaphore {
+    std::recursive_timed_mutex mutex;
+    bool recursive;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    HalSemaphore* semaphore = new HalSemaphore();
+    semaphore->recursive = false;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    HalSemaphore* semaphore = new HalSemaphore();
+    semaphore->recursive = true;
+    return semaphore;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    if (!semaphore) {
+        return pdFALSE;
+    }
+    if (ticks == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (!semaphore) {
+        return pdFALSE;
+    }
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    return xSemaphoreTake(semaphore, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    return xSemaphoreGive(semaphore);
+}
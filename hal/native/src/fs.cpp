@@ -0,0 +1,286 @@
+#include <SPIFFS.h>
+#include "hal_native.h"
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stdfs = std::filesystem;
+
+fs::SPIFFSFS SPIFFS;
+
+static std::mutex fsMutex;
+static std::string fsRoot = "native_fs";
+static size_t fsCapacity = 1536 * 1024;
+
+static stdfs::path hostPath(const char* path) {
+    std::string relative = path ? path : "";
+    while (!relative.empty() && relative[0] == '/') {
+        relative.erase(0, 1);
+    }
+    std::lock_guard<std::mutex> lock(fsMutex);
+    return stdfs::path(fsRoot) / relative;
+}
+
+namespace fs {
+
+class FileImpl {
+public:
+    FILE* fp = nullptr;
+    std::string path;                  // Firmware path, e.g. "/alarms/a.mp3"
+    bool directory = false;
+    std::vector<std::string> entries;  // Directory listing (firmware paths)
+    size_t next = 0;
+
+    ~FileImpl() {
+        if (fp) {
+            fclose(fp);
+        }
+    }
+};
+
+// ============================================
+// File
+// ============================================
+
+File::operator bool() const {
+    return _impl && (_impl->fp || _impl->directory);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!_impl || !_impl->fp) {
+        return 0;
+    }
+
+    // Growing past the capacity comes up short, as on a full SPIFFS
+    fflush(_impl->fp);
+    size_t fileSize = this->size();
+    size_t end = position() + size;
+    if (end > fileSize) {
+        size_t used = SPIFFS.usedBytes();
+        size_t capacity = SPIFFS.totalBytes();
+        size_t room = (used < capacity) ? capacity - used : 0;
+        size_t growth = end - fileSize;
+        if (growth > room) {
+            size = (growth - room >= size) ? 0 : size - (growth - room);
+        }
+    }
+    return fwrite(buffer, 1, size, _impl->fp);
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    return (_impl && _impl->fp) ? fread(buffer, 1, size, _impl->fp) : 0;
+}
+
+int File::available() {
+    if (!_impl || !_impl->fp) {
+        return 0;
+    }
+    return (int)(size() - position());
+}
+
+int File::peek() {
+    if (!_impl || !_impl->fp) {
+        return -1;
+    }
+    int c = fgetc(_impl->fp);
+    if (c != EOF) {
+        ungetc(c, _impl->fp);
+    }
+    return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+    if (_impl && _impl->fp) {
+        fflush(_impl->fp);
+    }
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+    if (!_impl || !_impl->fp) {
+        return false;
+    }
+    int whence = (mode == SeekCur) ? SEEK_CUR : (mode == SeekEnd) ? SEEK_END : SEEK_SET;
+    return fseek(_impl->fp, (long)position, whence) == 0;
+}
+
+size_t File::position() const {
+    return (_impl && _impl->fp) ? (size_t)ftell(_impl->fp) : 0;
+}
+
+size_t File::size() const {
+    if (!_impl || !_impl->fp) {
+        return 0;
+    }
+    long current = ftell(_impl->fp);
+    fseek(_impl->fp, 0, SEEK_END);
+    long end = ftell(_impl->fp);
+    fseek(_impl->fp, current, SEEK_SET);
+    return (size_t)end;
+}
+
+void File::close() {
+    _impl.reset();
+}
+
+const char* File::path() const {
+    return _impl ? _impl->path.c_str() : "";
+}
+
+const char* File::name() const {
+    if (!_impl) {
+        return "";
+    }
+    size_t slash = _impl->path.rfind('/');
+    return _impl->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+bool File::isDirectory() const {
+    return _impl && _impl->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!_impl || !_impl->directory || _impl->next >= _impl->entries.size()) {
+        return File();
+    }
+    return SPIFFS.open(_impl->entries[_impl->next++].c_str(), mode);
+}
+
+// ============================================
+// FS
+// ============================================
+
+File FS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    stdfs::path host = hostPath(path);
+    std::error_code error;
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path ? path : "";
+
+    if (stdfs::is_directory(host, error)) {
+        // SPIFFS is flat: a directory lists every file below its prefix
+        impl->directory = true;
+        std::string prefix = impl->path;
+        if (prefix.empty() || prefix.back() != '/') {
+            prefix += '/';
+        }
+        for (auto it = stdfs::recursive_directory_iterator(host, error);
+             !error && it != stdfs::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_regular_file(error)) {
+                impl->entries.push_back(prefix + stdfs::relative(it->path(), host, error).generic_string());
+            }
+        }
+        std::sort(impl->entries.begin(), impl->entries.end());
+        return File(impl);
+    }
+
+    bool writing = mode && (mode[0] == 'w' || mode[0] == 'a');
+    if (writing) {
+        stdfs::create_directories(host.parent_path(), error);
+    }
+    // Binary mode always; "r+" and "a" behave as on SPIFFS
+    std::string hostMode = std::string(mode ? mode : "r") + "b";
+    impl->fp = fopen(host.c_str(), hostMode.c_str());
+    return impl->fp ? File(impl) : File();
+}
+
+bool FS::exists(const char* path) {
+    std::error_code error;
+    return stdfs::exists(hostPath(path), error);
+}
+
+bool FS::remove(const char* path) {
+    std::error_code error;
+    return stdfs::is_regular_file(hostPath(path), error) && stdfs::remove(hostPath(path), error);
+}
+
+bool FS::rename(const char* from, const char* to) {
+    std::error_code error;
+    stdfs::path target = hostPath(to);
+    stdfs::create_directories(target.parent_path(), error);
+    stdfs::rename(hostPath(from), target, error);
+    return !error;
+}
+
+bool FS::mkdir(const char* path) {
+    std::error_code error;
+    stdfs::create_directories(hostPath(path), error);
+    return !error;
+}
+
+bool FS::rmdir(const char* path) {
+    std::error_code error;
+    return stdfs::remove(hostPath(path), error);
+}
+
+// ============================================
+// SPIFFS
+// ============================================
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    std::error_code error;
+    stdfs::create_directories(hostPath("/"), error);
+    return !error;
+}
+
+bool SPIFFSFS::format() {
+    HalNative::clearFs();
+    return true;
+}
+
+size_t SPIFFSFS::totalBytes() {
+    std::lock_guard<std::mutex> lock(fsMutex);
+    return fsCapacity;
+}
+
+size_t SPIFFSFS::usedBytes() {
+    std::error_code error;
+    size_t used = 0;
+    stdfs::path root = hostPath("/");
+    for (auto it = stdfs::recursive_directory_iterator(root, error);
+         !error && it != stdfs::recursive_directory_iterator(); it.increment(error)) {
+        if (it->is_regular_file(error)) {
+            used += (size_t)it->file_size(error);
+        }
+    }
+    return used;
+}
+
+} // namespace fs
+
+// ============================================
+// Test hooks
+// ============================================
+
+void HalNative::setFsRoot(const char* directory) {
+    {
+        std::lock_guard<std::mutex> lock(fsMutex);
+        fsRoot = directory;
+    }
+    std::error_code error;
+    stdfs::create_directories(directory, error);
+}
+
+void HalNative::setFsCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(fsMutex);
+    fsCapacity = bytes;
+}
+
+void HalNative::clearFs() {
+    std::error_code error;
+    stdfs::path root = hostPath("/");
+    for (auto it = stdfs::directory_iterator(root, error);
+         !error && it != stdfs::directory_iterator(); it.increment(error)) {
+        stdfs::remove_all(it->path(), error);
+    }
+}
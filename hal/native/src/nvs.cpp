@@ -0,0 +1,231 @@
+#include <Preferences.h>
+#include "hal_native.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Values are stored as raw bytes; strings keep their terminator
+typedef std::vector<uint8_t> Blob;
+typedef std::map<std::string, Blob> Namespace;
+
+static std::mutex nvsMutex;
+static std::map<std::string, Namespace> store;
+static std::map<nvs_handle_t, std::string> handles;
+static nvs_handle_t nextHandle = 1;
+
+static Namespace* lookup(nvs_handle_t handle) {
+    auto it = handles.find(handle);
+    return it == handles.end() ? nullptr : &store[it->second];
+}
+
+static esp_err_t setBlob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(handle);
+    if (!ns || !key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t* bytes = (const uint8_t*)value;
+    (*ns)[key] = Blob(bytes, bytes + length);
+    return ESP_OK;
+}
+
+static esp_err_t getBlob(nvs_handle_t handle, const char* key, void* value, size_t length) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(handle);
+    if (!ns || !key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto it = ns->find(key);
+    if (it == ns->end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.size() != length) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(value, it->second.data(), length);
+    return ESP_OK;
+}
+
+// ============================================
+// NVS
+// ============================================
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle) {
+    (void)mode;
+    if (!name || !handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    *handle = nextHandle++;
+    handles[*handle] = name;
+    store[name];
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    handles.erase(handle);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return lookup(handle) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(handle);
+    if (!ns || !key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* value) {
+    return getBlob(handle, key, value, sizeof(*value));
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value) {
+    return setBlob(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* value) {
+    return getBlob(handle, key, value, sizeof(*value));
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value) {
+    return setBlob(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* value, size_t* length) {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(handle);
+    if (!ns || !key || !length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto it = ns->find(key);
+    if (it == ns->end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    size_t needed = it->second.size();
+    if (value) {
+        if (*length < needed) {
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        memcpy(value, it->second.data(), needed);
+    }
+    *length = needed;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value) {
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return setBlob(handle, key, value, strlen(value) + 1);
+}
+
+// ============================================
+// Preferences
+// ============================================
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)partition;
+    end();
+    if (nvs_open(name, readOnly ? NVS_READONLY : NVS_READWRITE, &_handle) != ESP_OK) {
+        return false;
+    }
+    _open = true;
+    _readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end() {
+    if (_open) {
+        nvs_close(_handle);
+        _open = false;
+    }
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    lookup(_handle)->clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    return _open && !_readOnly && nvs_erase_key(_handle, key) == ESP_OK;
+}
+
+bool Preferences::isKey(const char* key) {
+    return getBytesLength(key) > 0;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    if (!_open || _readOnly || nvs_set_str(_handle, key, value) != ESP_OK) {
+        return 0;
+    }
+    return strlen(value);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t length = 0;
+    if (!_open || nvs_get_str(_handle, key, nullptr, &length) != ESP_OK) {
+        return defaultValue;
+    }
+    std::vector<char> buffer(length);
+    if (nvs_get_str(_handle, key, buffer.data(), &length) != ESP_OK) {
+        return defaultValue;
+    }
+    return String(buffer.data());
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    size_t length = maxLength;
+    if (!_open || !value || nvs_get_str(_handle, key, value, &length) != ESP_OK) {
+        return 0;
+    }
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!_open || !key) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(_handle);
+    auto it = ns->find(key);
+    return it == ns->end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    if (!_open || !key || !buffer) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    Namespace* ns = lookup(_handle);
+    auto it = ns->find(key);
+    if (it == ns->end() || it->second.size() > maxLength) {
+        return 0;
+    }
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::putValue(const char* key, const void* value, size_t length) {
+    if (!_open || _readOnly || setBlob(_handle, key, value, length) != ESP_OK) {
+        return 0;
+    }
+    return length;
+}
+
+void HalNative::resetNvs() {
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    for (auto& ns : store) {
+        ns.second.clear();
+    }
+}
@@ -0,0 +1,63 @@
+#include <WString.h>
+#include <stdio.h>
+
+void String::replace(const String& find, const String& with) {
+    if (find._s.empty()) {
+        return;
+    }
+    size_t position = 0;
+    while ((position = _s.find(find._s, position)) != std::string::npos) {
+        _s.replace(position, find._s.size(), with._s);
+        position += with._s.size();
+    }
+}
+
+void String::trim() {
+    size_t begin = 0;
+    size_t end = _s.size();
+    while (begin < end && isspace((unsigned char)_s[begin])) {
+        begin++;
+    }
+    while (end > begin && isspace((unsigned char)_s[end - 1])) {
+        end--;
+    }
+    _s = _s.substr(begin, end - begin);
+}
+
+void String::toCharArray(char* buffer, unsigned int size, unsigned int from) const {
+    if (!buffer || size == 0) {
+        return;
+    }
+    size_t n = 0;
+    if (from < _s.size()) {
+        n = _s.copy(buffer, size - 1, from);
+    }
+    buffer[n] = '\0';
+}
+
+std::string String::format(long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + formatUnsigned((unsigned long)(-(value + 1)) + 1, base);
+    }
+    return formatUnsigned((unsigned long)value, base);
+}
+
+std::string String::formatUnsigned(unsigned long value, unsigned char base) {
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    char digits[sizeof(unsigned long) * 8 + 1];
+    size_t i = sizeof(digits);
+    do {
+        unsigned d = (unsigned)(value % base);
+        digits[--i] = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+        value /= base;
+    } while (value > 0);
+    return std::string(digits + i, sizeof(digits) - i);
+}
+
+std::string String::formatFloat(double value, unsigned int decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    return buffer;
+}
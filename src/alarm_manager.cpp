@@ -1,13 +1,16 @@
 #include "alarm_manager.h"
+#include "trace.h"
 
 AlarmManager::AlarmManager()
     : _alarmRinging(false),
       _ringingAlarmId(255),
-      _lastCheckedMinute(255),
+      _lastCheckedMinute(-1),
       _snoozed(false),
       _snoozeHour(0),
       _snoozeMinute(0),
       _alarmCallback(nullptr) {
+    memset(_lastFired, 0, sizeof(_lastFired));
+    memset(_lastFiredMinute, 0xFF, sizeof(_lastFiredMinute));
 }
 
 bool AlarmManager::begin() {
@@ -81,8 +84,7 @@ bool AlarmManager::deleteAlarm(uint8_t id) {
             _alarms.erase(_alarms.begin() + i);
 
             // Remove from NVS
-            String key = getAlarmKey(id);
-            _prefs.remove(key.c_str());
+            _prefs.remove(getAlarmKey(id).c_str());
 
             Serial.print("AlarmManager: Deleted alarm ");
             Serial.println(id);
@@ -98,56 +100,23 @@ std::vector<AlarmData> AlarmManager::getAllAlarms() {
 
 void AlarmManager::checkAlarms(uint8_t hour, uint8_t minute, uint8_t dayOfWeek) {
     // Only check once per minute
-    if (minute == _lastCheckedMinute) {
+    int16_t minuteOfDay = hour * 60 + minute;
+    if (minuteOfDay == _lastCheckedMinute) {
         return;
     }
-    _lastCheckedMinute = minute;
 
-    // Check if snoozed alarm should trigger
-    if (_snoozed && hour == _snoozeHour && minute == _snoozeMinute) {
-        _alarmRinging = true;
-        _snoozed = false;
-
-        Serial.println("\n>>> ALARM: Snoozed alarm triggering!");
-
-        if (_alarmCallback) {
-            _alarmCallback(_ringingAlarmId);
-        }
-        return;
+    // Catch up on minutes the clock jumped over (DST start, long stall)
+    int16_t first = minuteOfDay;
+    if (_lastCheckedMinute >= 0 && minuteOfDay > _lastCheckedMinute + 1 &&
+        minuteOfDay - _lastCheckedMinute - 1 <= ALARM_CATCHUP_MAX_MIN) {
+        first = _lastCheckedMinute + 1;
+        Serial.printf("AlarmManager: Clock skipped %d min, checking missed alarms\n", minuteOfDay - first);
     }
+    _lastCheckedMinute = minuteOfDay;
 
-    // Check all enabled alarms
-    for (size_t i = 0; i < _alarms.size(); i++) {
-        auto& alarm = _alarms[i];
-        if (!alarm.enabled || alarm.permanentlyDisabled) continue;
-
-        if (shouldAlarmTrigger(alarm, hour, minute, dayOfWeek)) {
-            // Auto-disable one-shot alarms (daysOfWeek == 0) BEFORE ringing
-            if (alarm.daysOfWeek == 0) {
-                _alarms[i].enabled = false;
-                _alarms[i].permanentlyDisabled = true;
-                saveToNVS();
-                Serial.print(">>> One-time alarm ID=");
-                Serial.print(alarm.id);
-                Serial.println(" permanently disabled (will ring once)");
-            }
-
-            _alarmRinging = true;
-            _ringingAlarmId = alarm.id;
-
-            Serial.print("\n>>> ALARM TRIGGERED: ID=");
-            Serial.print(alarm.id);
-            Serial.print(" Time=");
-            Serial.print(alarm.hour);
-            Serial.print(":");
-            Serial.print(alarm.minute);
-            Serial.print(" Sound=");
-            Serial.println(alarm.sound);
-
-            if (_alarmCallback) {
-                _alarmCallback(alarm.id);
-            }
-
+    time_t now = time(nullptr);
+    for (int16_t m = first; m <= minuteOfDay; m++) {
+        if (triggerDue(m / 60, m % 60, dayOfWeek, now)) {
             break;  // Only one alarm at a time
         }
     }
@@ -199,12 +168,12 @@ uint8_t AlarmManager::getRingingAlarmId() {
     return _ringingAlarmId;
 }
 
-String AlarmManager::getRingingAlarmSound() {
+const char* AlarmManager::getRingingAlarmSound() {
     if (!_alarmRinging) return "";
 
     for (const auto& alarm : _alarms) {
         if (alarm.id == _ringingAlarmId) {
-            return alarm.sound;
+            return alarm.sound.c_str();
         }
     }
     return "tone1";  // Default fallback
@@ -227,6 +196,101 @@ bool AlarmManager::hasEnabledAlarm() {
     return false;
 }
 
+bool AlarmManager::triggerDue(uint8_t hour, uint8_t minute, uint8_t dayOfWeek, time_t now) {
+    // Check if snoozed alarm should trigger
+    if (_snoozed && hour == _snoozeHour && minute == _snoozeMinute) {
+        _alarmRinging = true;
+        _snoozed = false;
+
+        Serial.println("\n>>> ALARM: Snoozed alarm triggering!");
+
+        if (_alarmCallback) {
+            _alarmCallback(_ringingAlarmId);
+        }
+        return true;
+    }
+
+    // Check all enabled alarms
+    int16_t minuteOfDay = hour * 60 + minute;
+    for (size_t i = 0; i < _alarms.size(); i++) {
+        auto& alarm = _alarms[i];
+        if (!alarm.enabled || alarm.permanentlyDisabled) continue;
+
+        if (!shouldAlarmTrigger(alarm, hour, minute, dayOfWeek)) continue;
+
+        // Repeated hour at DST end: already rang at this local minute
+        if (alarm.id < MAX_ALARMS && _lastFiredMinute[alarm.id] == minuteOfDay &&
+            now - _lastFired[alarm.id] < ALARM_REFIRE_GUARD_S) {
+            continue;
+        }
+
+        // Auto-disable one-shot alarms (daysOfWeek == 0) BEFORE ringing
+        if (alarm.daysOfWeek == 0) {
+            _alarms[i].enabled = false;
+            _alarms[i].permanentlyDisabled = true;
+            saveToNVS();
+            Serial.print(">>> One-time alarm ID=");
+            Serial.print(alarm.id);
+            Serial.println(" permanently disabled (will ring once)");
+        }
+
+        if (alarm.id < MAX_ALARMS) {
+            _lastFired[alarm.id] = now;
+            _lastFiredMinute[alarm.id] = minuteOfDay;
+        }
+
+        _alarmRinging = true;
+        _ringingAlarmId = alarm.id;
+        Trace::instant(TRACE_ALARM_FIRED, alarm.id);
+
+        Serial.print("\n>>> ALARM TRIGGERED: ID=");
+        Serial.print(alarm.id);
+        Serial.print(" Time=");
+        Serial.print(alarm.hour);
+        Serial.print(":");
+        Serial.print(alarm.minute);
+        Serial.print(" Sound=");
+        Serial.println(alarm.sound.c_str());
+
+        if (_alarmCallback) {
+            _alarmCallback(alarm.id);
+        }
+        return true;
+    }
+    return false;
+}
+
+uint16_t AlarmManager::minutesUntilNextAlarm(uint8_t hour, uint8_t minute, uint8_t dayOfWeek) {
+    const int MINUTES_PER_DAY = 24 * 60;
+    int nowMinutes = hour * 60 + minute;
+    uint16_t best = NO_ALARM_DUE;
+
+    if (_snoozed) {
+        int delta = (_snoozeHour * 60 + _snoozeMinute - nowMinutes + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+        best = delta;
+    }
+
+    for (const auto& alarm : _alarms) {
+        if (!alarm.enabled || alarm.permanentlyDisabled) continue;
+
+        // Scan today through the same weekday next week
+        for (uint8_t d = 0; d <= 7; d++) {
+            int delta = d * MINUTES_PER_DAY + alarm.hour * 60 + alarm.minute - nowMinutes;
+            if (delta < 0) continue;  // Already passed today
+
+            uint8_t day = (dayOfWeek + d) % 7;
+            if (alarm.daysOfWeek == 0 || (alarm.daysOfWeek & (1 << day))) {
+                if (delta < best) {
+                    best = delta;
+                }
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
 // ============================================
 // Private Methods
 // ============================================
@@ -236,61 +300,58 @@ void AlarmManager::loadFromNVS() {
 
     // Try to load each possible alarm slot
     for (uint8_t id = 0; id < MAX_ALARMS; id++) {
-        String key = getAlarmKey(id);
+        FixedString<15> key = getAlarmKey(id);
 
         if (_prefs.isKey(key.c_str())) {
             // Load alarm data (format: "hour,minute,days,enabled,sound,label,snooze,perm_disabled,bottomRowLabel")
-            String data = _prefs.getString(key.c_str(), "");
+            char record[ALARM_RECORD_MAX];
+            size_t length = _prefs.getString(key.c_str(), record, sizeof(record));
 
-            if (data.length() > 0) {
+            if (length > 1) {  // Length includes the terminator
+                StringView data(record, strlen(record));
                 AlarmData alarm;
                 alarm.id = id;
 
-                // Parse comma-separated values
-                int idx1 = data.indexOf(',');
-                int idx2 = data.indexOf(',', idx1 + 1);
-                int idx3 = data.indexOf(',', idx2 + 1);
-                int idx4 = data.indexOf(',', idx3 + 1);
-                int idx5 = data.indexOf(',', idx4 + 1);
-                int idx6 = data.indexOf(',', idx5 + 1);
-                int idx7 = data.indexOf(',', idx6 + 1);
-                int idx8 = data.indexOf(',', idx7 + 1);
-
-                if (idx1 > 0 && idx2 > 0 && idx3 > 0 && idx4 > 0) {
-                    alarm.hour = data.substring(0, idx1).toInt();
-                    alarm.minute = data.substring(idx1 + 1, idx2).toInt();
-                    alarm.daysOfWeek = data.substring(idx2 + 1, idx3).toInt();
-                    alarm.enabled = data.substring(idx3 + 1, idx4).toInt() == 1;
+                // Split at the first 8 commas; the last field keeps any further commas
+                const uint8_t MAX_COMMAS = 8;
+                int idx[MAX_COMMAS];
+                uint8_t commas = 0;
+                for (int from = 0; commas < MAX_COMMAS; commas++) {
+                    idx[commas] = data.indexOf(',', from);
+                    if (idx[commas] < 0) {
+                        break;
+                    }
+                    from = idx[commas] + 1;
+                }
+
+                if (commas >= 4) {
+                    alarm.hour = data.substring(0, idx[0]).toUInt();
+                    alarm.minute = data.substring(idx[0] + 1, idx[1]).toUInt();
+                    alarm.daysOfWeek = data.substring(idx[1] + 1, idx[2]).toUInt();
+                    alarm.enabled = data.substring(idx[2] + 1, idx[3]).toUInt() == 1;
 
                     // Handle different formats
-                    if (idx5 > 0 && idx6 > 0 && idx7 > 0 && idx8 > 0) {
+                    if (commas >= 8) {
                         // Newest format with label, snooze, perm_disabled, and bottomRowLabel
-                        alarm.sound = data.substring(idx4 + 1, idx5);
-                        alarm.label = data.substring(idx5 + 1, idx6);
-                        alarm.snoozeEnabled = data.substring(idx6 + 1, idx7).toInt() == 1;
-                        alarm.permanentlyDisabled = data.substring(idx7 + 1, idx8).toInt() == 1;
-                        alarm.bottomRowLabel = data.substring(idx8 + 1);
-                    } else if (idx5 > 0 && idx6 > 0 && idx7 > 0) {
+                        alarm.sound = data.substring(idx[3] + 1, idx[4]);
+                        alarm.label = data.substring(idx[4] + 1, idx[5]);
+                        alarm.snoozeEnabled = data.substring(idx[5] + 1, idx[6]).toUInt() == 1;
+                        alarm.permanentlyDisabled = data.substring(idx[6] + 1, idx[7]).toUInt() == 1;
+                        alarm.bottomRowLabel = data.substring(idx[7] + 1);
+                    } else if (commas == 7) {
                         // Previous format with label, snooze, and perm_disabled (no bottomRowLabel)
-                        alarm.sound = data.substring(idx4 + 1, idx5);
-                        alarm.label = data.substring(idx5 + 1, idx6);
-                        alarm.snoozeEnabled = data.substring(idx6 + 1, idx7).toInt() == 1;
-                        alarm.permanentlyDisabled = data.substring(idx7 + 1).toInt() == 1;
-                        alarm.bottomRowLabel = "";  // Default empty
-                    } else if (idx5 > 0 && idx6 > 0) {
+                        alarm.sound = data.substring(idx[3] + 1, idx[4]);
+                        alarm.label = data.substring(idx[4] + 1, idx[5]);
+                        alarm.snoozeEnabled = data.substring(idx[5] + 1, idx[6]).toUInt() == 1;
+                        alarm.permanentlyDisabled = data.substring(idx[6] + 1).toUInt() == 1;
+                    } else if (commas == 6) {
                         // Old format with label and snooze
-                        alarm.sound = data.substring(idx4 + 1, idx5);
-                        alarm.label = data.substring(idx5 + 1, idx6);
-                        alarm.snoozeEnabled = data.substring(idx6 + 1).toInt() == 1;
-                        alarm.permanentlyDisabled = false;  // Default
-                        alarm.bottomRowLabel = "";  // Default empty
+                        alarm.sound = data.substring(idx[3] + 1, idx[4]);
+                        alarm.label = data.substring(idx[4] + 1, idx[5]);
+                        alarm.snoozeEnabled = data.substring(idx[5] + 1).toUInt() == 1;
                     } else {
-                        // Oldest format - just sound
-                        alarm.sound = data.substring(idx4 + 1);
-                        alarm.label = "Alarm";  // Default label
-                        alarm.snoozeEnabled = true;  // Default snooze enabled
-                        alarm.permanentlyDisabled = false;  // Default
-                        alarm.bottomRowLabel = "";  // Default empty
+                        // Oldest format - just sound (label, snooze etc. keep the AlarmData defaults)
+                        alarm.sound = data.substring(idx[3] + 1);
                     }
 
                     _alarms.push_back(alarm);
@@ -301,27 +362,26 @@ void AlarmManager::loadFromNVS() {
 }
 
 void AlarmManager::saveToNVS() {
+    TraceScope trace(TRACE_NVS_COMMIT, _alarms.size());
+
     // Save each alarm
     for (const auto& alarm : _alarms) {
-        String key = getAlarmKey(alarm.id);
-
         // Format: "hour,minute,days,enabled,sound,label,snooze,perm_disabled,bottomRowLabel"
-        String data = String(alarm.hour) + "," +
-                     String(alarm.minute) + "," +
-                     String(alarm.daysOfWeek) + "," +
-                     String(alarm.enabled ? 1 : 0) + "," +
-                     alarm.sound + "," +
-                     alarm.label + "," +
-                     String(alarm.snoozeEnabled ? 1 : 0) + "," +
-                     String(alarm.permanentlyDisabled ? 1 : 0) + "," +
-                     alarm.bottomRowLabel;
-
-        _prefs.putString(key.c_str(), data);
+        FixedString<ALARM_RECORD_MAX - 1> data;
+        data.appendf("%u,%u,%u,%u,%s,%s,%u,%u,%s",
+                     alarm.hour, alarm.minute, alarm.daysOfWeek, alarm.enabled ? 1 : 0,
+                     alarm.sound.c_str(), alarm.label.c_str(),
+                     alarm.snoozeEnabled ? 1 : 0, alarm.permanentlyDisabled ? 1 : 0,
+                     alarm.bottomRowLabel.c_str());
+
+        _prefs.putString(getAlarmKey(alarm.id).c_str(), data.c_str());
     }
 }
 
-String AlarmManager::getAlarmKey(uint8_t id) {
-    return "alarm_" + String(id);
+FixedString<15> AlarmManager::getAlarmKey(uint8_t id) {
+    FixedString<15> key;
+    key.appendf("alarm_%u", id);
+    return key;
 }
 
 bool AlarmManager::shouldAlarmTrigger(const AlarmData& alarm, uint8_t hour, uint8_t minute, uint8_t dayOfWeek) {
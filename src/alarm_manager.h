@@ -5,6 +5,8 @@
 #include <Preferences.h>
 #include <vector>
 #include "config.h"
+#include "fixed_string.h"
+#include "sound_catalog.h"
 
 /**
  * AlarmData - Single alarm configuration
@@ -14,14 +16,14 @@ struct AlarmData {
     uint8_t hour;         // Hour (0-23)
     uint8_t minute;       // Minute (0-59)
     uint8_t daysOfWeek;   // Bitmask: 0x01=Sun, 0x02=Mon, 0x04=Tue, 0x08=Wed, 0x10=Thu, 0x20=Fri, 0x40=Sat
-    String sound;         // Sound: "tone1", "tone2", "tone3", or MP3 filename
+    SoundName sound;      // Sound: "tone1", "tone2", "tone3", or MP3 filename
     bool enabled;         // Is alarm active?
-    String label;         // Custom alarm name/label
+    FixedString<ALARM_LABEL_MAX> label;  // Custom alarm name/label
     bool snoozeEnabled;   // Is snooze enabled for this alarm?
     bool permanentlyDisabled;  // One-shot alarms permanently disabled after firing
-    String bottomRowLabel;     // Custom bottom row text (replaces instructions when alarm rings)
+    FixedString<BOTTOM_LABEL_MAX> bottomRowLabel;  // Custom bottom row text (replaces instructions when alarm rings)
 
-    AlarmData() : id(0), hour(0), minute(0), daysOfWeek(0), sound("tone1"), enabled(false), label("Alarm"), snoozeEnabled(true), permanentlyDisabled(false), bottomRowLabel("") {}
+    AlarmData() : id(0), hour(0), minute(0), daysOfWeek(0), sound("tone1"), enabled(false), label("Alarm"), snoozeEnabled(true), permanentlyDisabled(false), bottomRowLabel() {}
 };
 
 /**
@@ -76,6 +78,10 @@ public:
 
     /**
      * Check if any alarms should trigger (call every second)
+     *
+     * Minutes skipped since the previous check (up to ALARM_CATCHUP_MAX_MIN,
+     * e.g. when DST starts) are checked too, and an alarm never rings twice
+     * for the same local minute when DST ends and the hour repeats.
      * @param hour Current hour (0-23)
      * @param minute Current minute (0-59)
      * @param dayOfWeek Day of week (0=Sun, 1=Mon, ..., 6=Sat)
@@ -106,9 +112,9 @@ public:
 
     /**
      * Get sound for current ringing alarm
-     * @return Sound string
+     * @return Sound name ("" if no alarm is ringing; valid until alarms change)
      */
-    String getRingingAlarmSound();
+    const char* getRingingAlarmSound();
 
     /**
      * Set callback for alarm trigger
@@ -128,6 +134,17 @@ public:
      */
     bool hasEnabledAlarm();
 
+    /**
+     * Minutes until the next enabled or snoozed alarm rings
+     * @param hour Current hour (0-23)
+     * @param minute Current minute (0-59)
+     * @param dayOfWeek Current day (0=Sunday, 6=Saturday)
+     * @return Minutes (0 = due this minute), or NO_ALARM_DUE if nothing is scheduled
+     */
+    uint16_t minutesUntilNextAlarm(uint8_t hour, uint8_t minute, uint8_t dayOfWeek);
+
+    static const uint16_t NO_ALARM_DUE = 0xFFFF;
+
 private:
     static const uint8_t SNOOZE_MINUTES = 5;
 
@@ -135,16 +152,23 @@ private:
     std::vector<AlarmData> _alarms;
     bool _alarmRinging;
     uint8_t _ringingAlarmId;
-    uint8_t _lastCheckedMinute;
+    int16_t _lastCheckedMinute;  // Minute of day of the last check (-1 = none)
     bool _snoozed;
     uint8_t _snoozeHour;
     uint8_t _snoozeMinute;
     AlarmCallback _alarmCallback;
+    time_t _lastFired[MAX_ALARMS];        // When each alarm ID last rang
+    int16_t _lastFiredMinute[MAX_ALARMS]; // Local minute of day it rang at
+
+    // NVS record: 4 numbers, 3 strings and 8 commas, plus room for records
+    // written before the labels were capped
+    static const size_t ALARM_RECORD_MAX = 256;
 
     void loadFromNVS();
     void saveToNVS();
-    String getAlarmKey(uint8_t id);
+    static FixedString<15> getAlarmKey(uint8_t id);  // NVS keys are at most 15 chars
     bool shouldAlarmTrigger(const AlarmData& alarm, uint8_t hour, uint8_t minute, uint8_t dayOfWeek);
+    bool triggerDue(uint8_t hour, uint8_t minute, uint8_t dayOfWeek, time_t now);
 };
 
 #endif // ALARM_MANAGER_H
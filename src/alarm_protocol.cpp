@@ -0,0 +1,103 @@
+#include "alarm_protocol.h"
+
+bool AlarmProtocol::parseAlarm(const char* json, AlarmData& alarm) {
+    const char* id = findValue(json, "id");
+    const char* hour = findValue(json, "hour");
+    const char* minute = findValue(json, "minute");
+    if (id == nullptr || hour == nullptr || minute == nullptr) {
+        return false;
+    }
+
+    alarm = AlarmData();
+    alarm.id = (uint8_t)atoi(id);
+    alarm.hour = (uint8_t)atoi(hour);
+    alarm.minute = (uint8_t)atoi(minute);
+
+    const char* days = findValue(json, "days");
+    if (days != nullptr) {
+        alarm.daysOfWeek = (uint8_t)atoi(days);
+    }
+
+    readString(json, "sound", alarm.sound);
+    readBool(json, "enabled", alarm.enabled);
+
+    // Optional for backward compatibility (defaults from AlarmData)
+    readString(json, "label", alarm.label);
+    readBool(json, "snooze", alarm.snoozeEnabled);
+    readBool(json, "perm_disabled", alarm.permanentlyDisabled);
+    readString(json, "bottomRowLabel", alarm.bottomRowLabel);
+    return true;
+}
+
+void AlarmProtocol::appendAlarm(const AlarmData& alarm, StringBuilder& out) {
+    out += "{\"id\":";
+    out.appendUInt(alarm.id);
+    out += ",\"hour\":";
+    out.appendUInt(alarm.hour);
+    out += ",\"minute\":";
+    out.appendUInt(alarm.minute);
+    out += ",\"days\":";
+    out.appendUInt(alarm.daysOfWeek);
+    out += ",\"sound\":\"";
+    out += alarm.sound;
+    out += "\",\"enabled\":";
+    out += alarm.enabled ? "true" : "false";
+    out += ",\"label\":\"";
+    out += alarm.label;
+    out += "\",\"snooze\":";
+    out += alarm.snoozeEnabled ? "true" : "false";
+    out += ",\"perm_disabled\":";
+    out += alarm.permanentlyDisabled ? "true" : "false";
+    out += ",\"bottomRowLabel\":\"";
+    out += alarm.bottomRowLabel;
+    out += "\"}";
+}
+
+bool AlarmProtocol::formatAlarmList(const std::vector<AlarmData>& alarms, StringBuilder& out) {
+    out.clear();
+    out += '[';
+    for (size_t i = 0; i < alarms.size(); i++) {
+        if (i > 0) out += ',';
+        appendAlarm(alarms[i], out);
+    }
+    out += ']';
+    return !out.truncated();
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+const char* AlarmProtocol::findValue(const char* json, const char* key) {
+    // Finds "key": and returns the character after the colon
+    size_t keyLen = strlen(key);
+    for (const char* p = strchr(json, '"'); p != nullptr; p = strchr(p + 1, '"')) {
+        if (strncmp(p + 1, key, keyLen) == 0 && p[1 + keyLen] == '"' && p[2 + keyLen] == ':') {
+            return p + keyLen + 3;
+        }
+    }
+    return nullptr;
+}
+
+bool AlarmProtocol::readString(const char* json, const char* key, StringBuilder& value) {
+    const char* start = findValue(json, key);
+    if (start == nullptr || *start != '"') {
+        return false;
+    }
+    start++;
+    const char* end = strchr(start, '"');
+    if (end == nullptr) {
+        end = start + strlen(start);
+    }
+    value.assign(StringView(start, end - start));  // Cut to the field's capacity
+    return true;
+}
+
+bool AlarmProtocol::readBool(const char* json, const char* key, bool& value) {
+    const char* start = findValue(json, key);
+    if (start == nullptr) {
+        return false;
+    }
+    value = strncmp(start, "true", 4) == 0;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef ALARM_PROTOCOL_H
+#define ALARM_PROTOCOL_H
+
+#include <Arduino.h>
+#include <vector>
+#include "alarm_manager.h"
+#include "fixed_string.h"
+
+/**
+ * AlarmProtocol - JSON encoding of alarms on the BLE alarm service
+ *
+ * Set Alarm:   {"id":0,"hour":7,"minute":30,"days":127,"sound":"tone1","enabled":true,
+ *               "label":"Alarm","snooze":true,"perm_disabled":false,"bottomRowLabel":""}
+ * List Alarms: JSON array of the same objects
+ *
+ * Kept apart from the BLE callbacks (and free of ArduinoJson) so the
+ * format can be tested and benchmarked off-device.
+ */
+class AlarmProtocol {
+public:
+    /**
+     * Parse a Set Alarm message
+     *
+     * Fields after "enabled" are optional for older apps and take the
+     * AlarmData defaults. Values are not range checked here; AlarmManager
+     * validates them when the alarm is set.
+     * @param json Message text
+     * @param alarm Output
+     * @return false if "id", "hour" or "minute" is missing
+     */
+    static bool parseAlarm(const char* json, AlarmData& alarm);
+
+    /**
+     * Encode one alarm as a JSON object
+     * @param alarm Alarm to encode
+     * @param out Builder the object is appended to
+     */
+    static void appendAlarm(const AlarmData& alarm, StringBuilder& out);
+
+    /**
+     * Encode alarms as a JSON array (List Alarms characteristic)
+     * @param out Replaced with the array; ALARM_JSON_MAX bytes per alarm always fit
+     * @return false if the array did not fit in out
+     */
+    static bool formatAlarmList(const std::vector<AlarmData>& alarms, StringBuilder& out);
+
+    /**
+     * Longest encoding of one alarm, including the separating comma
+     */
+    static const size_t ALARM_JSON_MAX = 160 + (SOUND_NAME_BUFFER_LEN - 1) + ALARM_LABEL_MAX + BOTTOM_LABEL_MAX;
+
+private:
+    static const char* findValue(const char* json, const char* key);
+    static bool readString(const char* json, const char* key, StringBuilder& value);
+    static bool readBool(const char* json, const char* key, bool& value);
+};
+
+#endif // ALARM_PROTOCOL_H
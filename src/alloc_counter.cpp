@@ -0,0 +1,63 @@
+#include "alloc_counter.h"
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+static std::atomic<uint32_t> allocations(0);
+
+uint32_t AllocCounter::total() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#ifdef NATIVE_BUILD
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+#else
+// Resolved by -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (env:esp32dev)
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* p, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* p, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __real_realloc(p, size);
+}
+}
+#endif
@@ -0,0 +1,28 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+/**
+ * AllocCounter - Counts heap allocations since boot
+ *
+ * On the device the firmware is linked with -Wl,--wrap for malloc,
+ * calloc and realloc (platformio.ini), so every allocation in the image,
+ * including operator new, String and library code, passes through a
+ * counting wrapper. On the host, operator new is counted (String is
+ * backed by std::string there). heap_caps_malloc/ps_malloc are not
+ * counted; the firmware uses them only for long-lived buffers.
+ *
+ * TaskMonitor turns the total into the heap.allocs_per_s gauge; in
+ * steady state (clock running, nothing being configured) it should be
+ * close to zero.
+ */
+class AllocCounter {
+public:
+    /**
+     * Allocations since boot (wraps at 2^32)
+     */
+    static uint32_t total();
+};
+
+#endif // ALLOC_COUNTER_H
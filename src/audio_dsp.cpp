@@ -0,0 +1,49 @@
+#include "audio_dsp.h"
+#include <math.h>
+
+static const float TWO_PI_F = 2.0f * (float)M_PI;
+
+void AudioDsp::generateSine(int16_t* stereo, size_t frames, uint16_t frequency, uint32_t sampleRate,
+                            float amplitude, float& phase) {
+    const float phaseIncrement = TWO_PI_F * frequency / sampleRate;
+
+    for (size_t i = 0; i < frames; i++) {
+        int16_t sample = (int16_t)(amplitude * sinf(phase));
+        stereo[i * 2] = sample;      // Left
+        stereo[i * 2 + 1] = sample;  // Right
+
+        phase += phaseIncrement;
+        if (phase >= TWO_PI_F) {
+            phase -= TWO_PI_F;
+        }
+    }
+}
+
+void AudioDsp::scale16(const int16_t* in, int16_t* out, size_t samples, uint8_t percent) {
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = (int16_t)(((int32_t)in[i] * percent) / 100);
+    }
+}
+
+void AudioDsp::mono16ToStereo(const int16_t* in, int16_t* out, size_t samples, uint8_t percent) {
+    for (size_t i = 0; i < samples; i++) {
+        int16_t sample = (int16_t)(((int32_t)in[i] * percent) / 100);
+        out[i * 2] = sample;      // Left
+        out[i * 2 + 1] = sample;  // Right
+    }
+}
+
+size_t AudioDsp::pcm8To16(const uint8_t* in, int16_t* out, size_t samples, bool duplicate, float gain) {
+    if (duplicate) {
+        for (size_t i = 0; i < samples; i++) {
+            int16_t sample = (int16_t)((int16_t)((in[i] - 128) << 8) * gain);
+            out[i * 2] = sample;
+            out[i * 2 + 1] = sample;
+        }
+        return samples * 2;
+    }
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = (int16_t)((int16_t)((in[i] - 128) << 8) * gain);
+    }
+    return samples;
+}
@@ -0,0 +1,50 @@
+#ifndef AUDIO_DSP_H
+#define AUDIO_DSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * AudioDsp - sample generation and conversion for the I2S output
+ *
+ * The output is always interleaved 16-bit stereo. Pure functions on
+ * caller-provided buffers (no I2S, no allocation) so the per-sample work
+ * can be benchmarked off-device.
+ */
+class AudioDsp {
+public:
+    /**
+     * Generate a sine tone
+     * @param stereo Output, frames * 2 samples
+     * @param frames Stereo frames to generate
+     * @param frequency Tone frequency in Hz
+     * @param sampleRate Output sample rate in Hz
+     * @param amplitude Peak amplitude (0-32767)
+     * @param phase Current phase in radians (updated)
+     */
+    static void generateSine(int16_t* stereo, size_t frames, uint16_t frequency, uint32_t sampleRate,
+                             float amplitude, float& phase);
+
+    /**
+     * Scale 16-bit samples (same layout in and out)
+     * @param percent Volume 0-100
+     */
+    static void scale16(const int16_t* in, int16_t* out, size_t samples, uint8_t percent);
+
+    /**
+     * Scale 16-bit mono and duplicate it to both channels
+     * @param out Output, samples * 2 values
+     */
+    static void mono16ToStereo(const int16_t* in, int16_t* out, size_t samples, uint8_t percent);
+
+    /**
+     * Convert unsigned 8-bit samples to 16-bit
+     * @param out Output, samples values (or samples * 2 if duplicate)
+     * @param duplicate true for mono input (each sample goes to both channels)
+     * @param gain Volume 0.0-1.0
+     * @return Values written to out
+     */
+    static size_t pcm8To16(const uint8_t* in, int16_t* out, size_t samples, bool duplicate, float gain);
+};
+
+#endif // AUDIO_DSP_H
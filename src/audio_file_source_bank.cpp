@@ -0,0 +1,75 @@
+#include "audio_file_source_bank.h"
+#include <SPIFFS.h>
+
+AudioFileSourceBank::AudioFileSourceBank(const SoundLocation& location)
+    : _offset(location.offset), _length(location.length), _pos(0) {
+    _file = SPIFFS.open(location.path.c_str(), "r");
+    if (!_file) {
+        Serial.printf("AudioFileSourceBank: Cannot open %s\n", location.path.c_str());
+        return;
+    }
+    if (_offset > 0) {
+        _file.seek(_offset);
+    }
+}
+
+AudioFileSourceBank::~AudioFileSourceBank() {
+    close();
+}
+
+uint32_t AudioFileSourceBank::read(void* data, uint32_t len) {
+    if (!_file || _pos >= _length) {
+        return 0;
+    }
+
+    // Never read past the end of this sound into the next payload
+    if (len > _length - _pos) {
+        len = _length - _pos;
+    }
+    uint32_t n = _file.read((uint8_t*)data, len);
+    _pos += n;
+    return n;
+}
+
+bool AudioFileSourceBank::seek(int32_t pos, int dir) {
+    if (!_file) {
+        return false;
+    }
+
+    int64_t target;
+    if (dir == SEEK_SET) {
+        target = pos;
+    } else if (dir == SEEK_CUR) {
+        target = (int64_t)_pos + pos;
+    } else {
+        target = (int64_t)_length + pos;
+    }
+
+    if (target < 0 || target > _length) {
+        return false;
+    }
+    if (!_file.seek(_offset + (uint32_t)target)) {
+        return false;
+    }
+    _pos = (uint32_t)target;
+    return true;
+}
+
+bool AudioFileSourceBank::close() {
+    if (_file) {
+        _file.close();
+    }
+    return true;
+}
+
+bool AudioFileSourceBank::isOpen() {
+    return (bool)_file;
+}
+
+uint32_t AudioFileSourceBank::getSize() {
+    return _length;
+}
+
+uint32_t AudioFileSourceBank::getPos() {
+    return _pos;
+}
@@ -0,0 +1,35 @@
+#ifndef AUDIO_FILE_SOURCE_BANK_H
+#define AUDIO_FILE_SOURCE_BANK_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "AudioFileSource.h"
+#include "sound_bank.h"
+
+/**
+ * @brief AudioFileSourceBank - ESP8266Audio source for one sound in a SPIFFS file
+ *
+ * Plays the byte range described by a SoundLocation: a payload inside the
+ * sound bank, or a whole loose file. Opening costs one SPIFFS open and one
+ * seek; positions and sizes seen by the decoder are relative to the sound.
+ */
+class AudioFileSourceBank : public AudioFileSource {
+public:
+    explicit AudioFileSourceBank(const SoundLocation& location);
+    virtual ~AudioFileSourceBank() override;
+
+    virtual uint32_t read(void* data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override;
+    virtual uint32_t getSize() override;
+    virtual uint32_t getPos() override;
+
+private:
+    File _file;
+    uint32_t _offset;  // Start of the sound within the file
+    uint32_t _length;  // Sound length in bytes
+    uint32_t _pos;     // Read position relative to _offset
+};
+
+#endif // AUDIO_FILE_SOURCE_BANK_H
@@ -1,18 +1,46 @@
 #include "audio_test.h"
 #include <math.h>
-#include <Preferences.h>
-#include <SPIFFS.h>
-#include "AudioFileSourceSPIFFS.h"
+#include "audio_dsp.h"
+#include "board_profile.h"
+#include "audio_file_source_bank.h"
+#include "file_manager.h"
+#include "log.h"
+#include "mono_clock.h"
+#include "object_slot.h"
+#include "settings_store.h"
+#include "trace.h"
 #include "AudioGeneratorMP3.h"
 #include "AudioGeneratorWAV.h"
 #include "AudioOutputI2S.h"
 
+extern SettingsStore settings;
+extern FileManager fileManager;
+
 // ESP8266Audio library components
 AudioOutputI2S* audioOut = nullptr;
-AudioFileSourceSPIFFS* audioFile = nullptr;
+AudioFileSource* audioFile = nullptr;
 AudioGeneratorMP3* mp3 = nullptr;
 AudioGeneratorWAV* wav = nullptr;
 
+// Storage for the components above, reserved for the life of the firmware
+// and constructed in place for each playback, so playing, stopping and
+// looping do not allocate (and cannot fail for lack of heap at alarm time)
+static ObjectSlot<AudioOutputI2S> outputSlot;
+static ObjectSlot<AudioFileSourceBank> sourceSlot;
+static ObjectSlot<AudioGeneratorMP3> mp3Slot;
+static ObjectSlot<AudioGeneratorWAV> wavSlot;
+
+// MP3 decoder state (stream, frame, synth and input buffer), taken from
+// the heap once in begin(); without it the decoder allocates its own
+static void* mp3Workspace = nullptr;
+
+static AudioGeneratorMP3* createMp3() {
+    if (mp3Workspace != nullptr) {
+        return mp3Slot.create(mp3Workspace, AudioGeneratorMP3::preAllocSize());
+    }
+    return mp3Slot.create();
+}
+
 /**
  * Constructor
  */
@@ -20,6 +48,7 @@ AudioTest::AudioTest()
     : _initialized(false),
       _volume(70),
       _volumeChanged(false),
+      _playbackCap(100),
       _currentSoundType(SOUND_TYPE_NONE),
       _audioLib(nullptr),
       _loopFile(false),
@@ -54,9 +83,9 @@ bool AudioTest::begin() {
 
     // I2S pin configuration
     i2s_pin_config_t pin_config = {
-        .bck_io_num = I2S_BCLK,
-        .ws_io_num = I2S_LRC,
-        .data_out_num = I2S_DOUT,
+        .bck_io_num = Board::PINS.i2sBclk,
+        .ws_io_num = Board::PINS.i2sLrc,
+        .data_out_num = Board::PINS.i2sDout,
         .data_in_num = I2S_PIN_NO_CHANGE
     };
 
@@ -87,11 +116,16 @@ bool AudioTest::begin() {
     }
     Serial.println("Audio mutex created successfully");
 
-    // Load volume from NVS
-    Preferences prefs;
-    prefs.begin("audio", false);
-    _volume = prefs.getUChar("volume", 70);  // Default 70%
-    prefs.end();
+    // Load volume from the settings store
+    _volume = settings.getVolume();
+
+    // Reserve the MP3 decoder state while the heap is still unfragmented
+    mp3Workspace = malloc(AudioGeneratorMP3::preAllocSize());
+    if (mp3Workspace != nullptr) {
+        Serial.printf("Audio: Reserved %d bytes for the MP3 decoder\n", AudioGeneratorMP3::preAllocSize());
+    } else {
+        Serial.println("WARNING: Could not reserve MP3 decoder memory (will allocate per playback)");
+    }
 
     // Note: We'll create AudioOutputI2S on-demand when playing files
     // Don't initialize it here because it conflicts with tone I2S driver
@@ -108,33 +142,18 @@ bool AudioTest::begin() {
 /**
  * Generate sine wave samples
  */
-void AudioTest::generateSineWave(int16_t* buffer, size_t bufferSize, uint16_t frequency, float& phase) {
+void AudioTest::generateSineWave(int16_t* buffer, size_t bufferSize, uint16_t frequency, uint8_t volume, float& phase) {
     // Dynamic amplitude based on volume (0-100) -> (0-32767)
-    const float amplitude = (_volume / 100.0) * 32767.0;
-    const float phaseIncrement = 2.0 * PI * frequency / SAMPLE_RATE;
-
-    for (size_t i = 0; i < bufferSize; i += 2) {
-        // Generate sine wave sample
-        int16_t sample = (int16_t)(amplitude * sin(phase));
-
-        // Stereo output (same sample for both channels)
-        buffer[i] = sample;      // Left channel
-        buffer[i + 1] = sample;  // Right channel
-
-        // Increment phase
-        phase += phaseIncrement;
-        if (phase >= 2.0 * PI) {
-            phase -= 2.0 * PI;
-        }
-    }
+    const float amplitude = (volume / 100.0f) * 32767.0f;
+    AudioDsp::generateSine(buffer, bufferSize / 2, frequency, SAMPLE_RATE, amplitude, phase);
 }
 
 /**
  * Play a test tone
  */
-void AudioTest::playTone(uint16_t frequency, uint32_t duration) {
+void AudioTest::playTone(uint16_t frequency, uint32_t duration, uint8_t volume) {
     if (!_initialized) {
-        Serial.println("Audio not initialized!");
+        LOG_E(AUDIO, "Audio not initialized!");
         return;
     }
 
@@ -148,32 +167,37 @@ void AudioTest::playTone(uint16_t frequency, uint32_t duration) {
 
     _currentSoundType = SOUND_TYPE_TONE;
 
-    Serial.print("Playing ");
-    Serial.print(frequency);
-    Serial.print(" Hz tone for ");
-    Serial.print(duration);
-    Serial.println(" ms...");
+    LOG_D(AUDIO, "Playing %u Hz tone for %u ms", frequency, duration);
+
+    if (volume == VOLUME_CURRENT) {
+        volume = _volume;
+    } else if (volume > 100) {
+        volume = 100;
+    }
 
     const size_t BUFFER_SIZE = 256;  // samples (128 per channel)
     int16_t buffer[BUFFER_SIZE];
     float phase = 0.0;
 
-    uint32_t startTime = millis();
+    Deadline toneEnd;
+    toneEnd.start(duration);
     size_t bytesWritten;
 
-    while (millis() - startTime < duration) {
+    while (!toneEnd.hasExpired()) {
         // Generate sine wave samples
-        generateSineWave(buffer, BUFFER_SIZE, frequency, phase);
+        generateSineWave(buffer, BUFFER_SIZE, frequency, volume, phase);
 
         // Write to I2S
+        Trace::begin(TRACE_AUDIO_I2S_WRITE, sizeof(buffer));
         i2s_write(I2S_PORT, buffer, sizeof(buffer), &bytesWritten, portMAX_DELAY);
+        Trace::end(TRACE_AUDIO_I2S_WRITE);
     }
 
     // Clear DMA buffer to stop sound
     i2s_zero_dma_buffer(I2S_PORT);
 
     _currentSoundType = SOUND_TYPE_NONE;
-    Serial.println("Tone finished.");
+    LOG_D(AUDIO, "Tone finished");
 }
 
 /**
@@ -187,7 +211,7 @@ void AudioTest::stop() {
             if (_currentSoundType == SOUND_TYPE_PCM) {
                 _pcmPlaying = false;
                 _pcmPosition = _pcmSizeBytes;  // Jump to end to stop loop
-                Serial.println("PCM playback stopped.");
+                LOG_D(AUDIO, "PCM playback stopped.");
             }
             xSemaphoreGive(_audioMutex);
         }
@@ -205,7 +229,7 @@ void AudioTest::stop() {
 
         stopFile();  // Also stop file playback if active
         _currentSoundType = SOUND_TYPE_NONE;
-        Serial.println("Audio stopped (buffer cleared).");
+        LOG_D(AUDIO, "Audio stopped (buffer cleared).");
     }
 }
 
@@ -220,15 +244,10 @@ void AudioTest::setVolume(uint8_t volume) {
     _volume = volume;
     _volumeChanged = true;  // Signal audio task to update gain on next loop
 
-    // Save to NVS
-    Preferences prefs;
-    prefs.begin("audio", false);
-    prefs.putUChar("volume", _volume);
-    prefs.end();
+    // Save (written to NVS once changes settle)
+    settings.setVolume(_volume);
 
-    Serial.print(">>> setVolume: Volume saved to ");
-    Serial.print(_volume);
-    Serial.println("% (will update on next audio loop)");
+    LOG_D(AUDIO, "setVolume: Volume saved to %d%% (will update on next audio loop)", _volume);
 }
 
 /**
@@ -241,132 +260,132 @@ uint8_t AudioTest::getVolume() {
 /**
  * Play MP3/WAV file from SPIFFS
  */
-bool AudioTest::playFile(const String& path, bool loop) {
-    Serial.printf("\n>>> playFile() called: path='%s', loop=%d, currentType=%d\n",
-                  path.c_str(), loop, _currentSoundType);
+bool AudioTest::playFile(const SoundLocation& sound, bool loop, uint8_t maxVolume) {
+    LOG_D(AUDIO, "playFile() called: path='%s' @%u+%u, loop=%d, currentType=%d",
+                  sound.path.c_str(), sound.offset, sound.length, loop, _currentSoundType);
 
     if (!_initialized) {
-        Serial.println("ERROR: Audio not initialized!");
+        LOG_E(AUDIO, "Audio not initialized!");
+        fileManager.unpinSound(sound);
         return false;
     }
 
     // Acquire mutex for thread-safe operation
-    Serial.println(">>> playFile: Trying to acquire mutex...");
+    LOG_D(AUDIO, "playFile: Trying to acquire mutex...");
     if (xSemaphoreTake(_audioMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-        Serial.println("ERROR: playFile() couldn't acquire mutex!");
+        LOG_E(AUDIO, "playFile() couldn't acquire mutex!");
+        fileManager.unpinSound(sound);
         return false;
     }
-    Serial.println(">>> playFile: Mutex acquired");
+    LOG_D(AUDIO, "playFile: Mutex acquired");
+
+    // Volume cap applies to this playback only
+    _playbackCap = (maxVolume < 100) ? maxVolume : 100;
+    _volumeChanged = true;  // loop() applies the gain if the output already exists
 
     // Stop any existing file playback
     if (_currentSoundType == SOUND_TYPE_FILE) {
-        Serial.println(">>> playFile: Stopping existing file playback...");
+        LOG_D(AUDIO, "playFile: Stopping existing file playback...");
         // Release mutex before calling stopFile() since it needs the mutex too
         xSemaphoreGive(_audioMutex);
         stopFile();
         // Re-acquire mutex
-        Serial.println(">>> playFile: Re-acquiring mutex after stopFile...");
+        LOG_D(AUDIO, "playFile: Re-acquiring mutex after stopFile...");
         if (xSemaphoreTake(_audioMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-            Serial.println("ERROR: playFile() couldn't re-acquire mutex after stopFile!");
+            LOG_E(AUDIO, "playFile() couldn't re-acquire mutex after stopFile!");
+            fileManager.unpinSound(sound);
             return false;
         }
-        Serial.println(">>> playFile: Mutex re-acquired");
+        LOG_D(AUDIO, "playFile: Mutex re-acquired");
     }
 
-    Serial.printf(">>> playFile: audioOut=%p, currentType=%d\n", audioOut, _currentSoundType);
+    LOG_D(AUDIO, "playFile: audioOut=0x%08x, currentType=%d", (uint32_t)(uintptr_t)audioOut, _currentSoundType);
 
     // Uninstall tone I2S driver before creating AudioOutputI2S
     // This is needed whether we're switching from tone mode OR from idle (first playback)
     if (audioOut == nullptr) {
-        Serial.println("Need to switch from tone I2S to file I2S...");
+        LOG_D(AUDIO, "Need to switch from tone I2S to file I2S...");
 
         // Clear buffer and uninstall tone I2S driver
         i2s_zero_dma_buffer(I2S_PORT);
         esp_err_t err = i2s_driver_uninstall(I2S_PORT);
         if (err == ESP_OK) {
-            Serial.println("Uninstalled tone I2S driver successfully");
+            LOG_D(AUDIO, "Uninstalled tone I2S driver successfully");
         } else {
-            Serial.printf("Warning: i2s_driver_uninstall returned error %d (may already be uninstalled)\n", err);
+            LOG_W(AUDIO, "i2s_driver_uninstall returned error %d (may already be uninstalled)", err);
         }
         delay(100);  // Give I2S hardware time to fully reset
 
         // Create AudioOutputI2S for file playback
-        Serial.println("Creating AudioOutputI2S for file playback...");
-        // Specify I2S port explicitly (0 = I2S_NUM_0, same as our tone driver)
-        audioOut = new AudioOutputI2S(0, 0);  // port 0, use external DAC (not internal)
-
-        Serial.printf("Setting I2S pins: BCLK=%d, LRC=%d, DOUT=%d\n", I2S_BCLK, I2S_LRC, I2S_DOUT);
-        bool pinoutOk = audioOut->SetPinout(I2S_BCLK, I2S_LRC, I2S_DOUT);
-        Serial.printf("SetPinout result: %d\n", pinoutOk);
-
-        float gain = (_volume / 100.0f);
+        LOG_D(AUDIO, "Creating AudioOutputI2S for file playback...");
+        // Specify I2S port explicitly (0 = I2S_NUM_0, same as our tone driver);
+        // the DAC is fixed by the board profile
+        audioOut = outputSlot.create(0, Board::INTERNAL_DAC ? AudioOutputI2S::INTERNAL_DAC
+                                                            : AudioOutputI2S::EXTERNAL_I2S);
+
+        LOG_D(AUDIO, "Setting I2S pins: BCLK=%d, LRC=%d, DOUT=%d",
+              Board::PINS.i2sBclk, Board::PINS.i2sLrc, Board::PINS.i2sDout);
+        bool pinoutOk = audioOut->SetPinout(Board::PINS.i2sBclk, Board::PINS.i2sLrc, Board::PINS.i2sDout);
+        LOG_D(AUDIO, "SetPinout result: %d", pinoutOk);
+
+        float gain = outputGain();
         audioOut->SetGain(gain);
-        Serial.printf("AudioOutputI2S ready - I2S port 0, volume=%d%%, gain=%.2f\n", _volume, gain);
+        LOG_D(AUDIO, "AudioOutputI2S ready - I2S port 0, volume=%d%%, gain=%.2f", _volume, gain);
     }
 
-    // Strip /spiffs prefix if present (SPIFFS.exists doesn't use it)
-    String spiffsPath = path;
-    if (spiffsPath.startsWith("/spiffs")) {
-        spiffsPath = spiffsPath.substring(7);  // Remove "/spiffs"
-    }
+    LOG_I(AUDIO, "Playing file: %s (loop=%d)", sound.path.c_str(), loop);
 
-    // Check if file exists
-    if (!SPIFFS.exists(spiffsPath)) {
-        Serial.printf("ERROR: File not found: %s (checked: %s)\n", path.c_str(), spiffsPath.c_str());
-        xSemaphoreGive(_audioMutex);  // Release mutex before returning
-        return false;
-    }
+    // Store location for looping
+    _currentSound = sound;
 
-    Serial.printf("Playing file: %s (loop=%d)\n", path.c_str(), loop);
-
-    // Store file path for looping (use SPIFFS path without /spiffs prefix)
-    _currentFilePath = spiffsPath;
-
-    // Create file source
-    audioFile = new AudioFileSourceSPIFFS(spiffsPath.c_str());
-    if (!audioFile) {
-        Serial.println("ERROR: Failed to open audio file!");
+    // Create file source (one open + seek to the sound)
+    audioFile = sourceSlot.create(sound);
+    if (!audioFile->isOpen()) {
+        LOG_E(AUDIO, "Failed to open audio file: %s", sound.path.c_str());
+        sourceSlot.destroy();
+        audioFile = nullptr;
+        releaseCurrentSound();
         xSemaphoreGive(_audioMutex);  // Release mutex before returning
         return false;
     }
 
-    // Determine file type and create appropriate generator
-    String lowerPath = path;
-    lowerPath.toLowerCase();
-
-    if (lowerPath.endsWith(".mp3")) {
-        mp3 = new AudioGeneratorMP3();
+    // Create generator for the sound's codec
+    if (sound.codec == SOUND_CODEC_MP3) {
+        mp3 = createMp3();
         if (!mp3->begin(audioFile, audioOut)) {
-            Serial.println("ERROR: Failed to start MP3 playback!");
-            delete audioFile;
-            delete mp3;
+            LOG_E(AUDIO, "Failed to start MP3 playback!");
+            sourceSlot.destroy();
+            mp3Slot.destroy();
             audioFile = nullptr;
             mp3 = nullptr;
+            releaseCurrentSound();
             xSemaphoreGive(_audioMutex);  // Release mutex before returning
             return false;
         }
-    } else if (lowerPath.endsWith(".wav")) {
-        wav = new AudioGeneratorWAV();
+    } else if (sound.codec == SOUND_CODEC_WAV) {
+        wav = wavSlot.create();
         if (!wav->begin(audioFile, audioOut)) {
-            Serial.println("ERROR: Failed to start WAV playback!");
-            delete audioFile;
-            delete wav;
+            LOG_E(AUDIO, "Failed to start WAV playback!");
+            sourceSlot.destroy();
+            wavSlot.destroy();
             audioFile = nullptr;
             wav = nullptr;
+            releaseCurrentSound();
             xSemaphoreGive(_audioMutex);  // Release mutex before returning
             return false;
         }
     } else {
-        Serial.println("ERROR: Unsupported file format! Use .mp3 or .wav");
-        delete audioFile;
+        LOG_E(AUDIO, "Unsupported file format! Use .mp3 or .wav");
+        sourceSlot.destroy();
         audioFile = nullptr;
+        releaseCurrentSound();
         xSemaphoreGive(_audioMutex);  // Release mutex before returning
         return false;
     }
 
     _loopFile = loop;
     _currentSoundType = SOUND_TYPE_FILE;
-    Serial.println("File playback started");
+    LOG_D(AUDIO, "File playback started");
 
     xSemaphoreGive(_audioMutex);  // Release mutex after successful start
     return true;
@@ -376,42 +395,42 @@ bool AudioTest::playFile(const String& path, bool loop) {
  * Stop file playback
  */
 void AudioTest::stopFile() {
-    Serial.println("\n>>> stopFile() called");
+    LOG_D(AUDIO, "stopFile() called");
 
     // Acquire mutex for thread-safe operation
-    Serial.println(">>> stopFile: Trying to acquire mutex...");
+    LOG_D(AUDIO, "stopFile: Trying to acquire mutex...");
     if (xSemaphoreTake(_audioMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
-        Serial.println("Warning: stopFile() couldn't acquire mutex!");
+        LOG_W(AUDIO, "stopFile() couldn't acquire mutex!");
         return;
     }
-    Serial.println(">>> stopFile: Mutex acquired");
+    LOG_D(AUDIO, "stopFile: Mutex acquired");
 
     if (_currentSoundType == SOUND_TYPE_FILE) {
-        Serial.println(">>> stopFile: Cleaning up audio objects...");
+        LOG_D(AUDIO, "stopFile: Cleaning up audio objects...");
         // Stop generators
         if (mp3 != nullptr) {
             mp3->stop();
-            delete mp3;
+            mp3Slot.destroy();
             mp3 = nullptr;
         }
         if (wav != nullptr) {
             wav->stop();
-            delete wav;
+            wavSlot.destroy();
             wav = nullptr;
         }
 
         // Close file source
         if (audioFile != nullptr) {
             audioFile->close();
-            delete audioFile;
+            sourceSlot.destroy();
             audioFile = nullptr;
         }
 
         // Clean up AudioOutputI2S
         if (audioOut != nullptr) {
-            delete audioOut;
+            outputSlot.destroy();
             audioOut = nullptr;
-            Serial.println("Deleted AudioOutputI2S");
+            LOG_D(AUDIO, "Destroyed AudioOutputI2S");
         }
 
         // Reinstall I2S driver for tone generation
@@ -430,26 +449,34 @@ void AudioTest::stopFile() {
         };
 
         i2s_pin_config_t pin_config = {
-            .bck_io_num = I2S_BCLK,
-            .ws_io_num = I2S_LRC,
-            .data_out_num = I2S_DOUT,
+            .bck_io_num = Board::PINS.i2sBclk,
+            .ws_io_num = Board::PINS.i2sLrc,
+            .data_out_num = Board::PINS.i2sDout,
             .data_in_num = I2S_PIN_NO_CHANGE
         };
 
         i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL);
         i2s_set_pin(I2S_PORT, &pin_config);
-        Serial.println("Reinstalled tone I2S driver");
+        LOG_D(AUDIO, "Reinstalled tone I2S driver");
 
         _currentSoundType = SOUND_TYPE_NONE;
         _loopFile = false;
-        _currentFilePath = "";
-        Serial.println(">>> stopFile: File playback stopped");
+        releaseCurrentSound();
+        LOG_D(AUDIO, "stopFile: File playback stopped");
     } else {
-        Serial.println(">>> stopFile: Nothing to stop (not playing file)");
+        LOG_D(AUDIO, "stopFile: Nothing to stop (not playing file)");
     }
 
     xSemaphoreGive(_audioMutex);  // Release mutex
-    Serial.println(">>> stopFile: Mutex released, exiting\n");
+    LOG_D(AUDIO, "stopFile: Mutex released, exiting");
+}
+
+/**
+ * Forget the current sound and release its bank pin
+ */
+void AudioTest::releaseCurrentSound() {
+    fileManager.unpinSound(_currentSound);  // Lets compaction move the payload again
+    _currentSound = SoundLocation();
 }
 
 /**
@@ -494,29 +521,30 @@ SoundType AudioTest::getCurrentSoundType() {
  * Play raw PCM data from RAM buffer
  * Used for preloaded WAV files for instant button feedback
  */
-bool AudioTest::playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t sampleRate, uint8_t bits, uint8_t channels) {
+bool AudioTest::playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t sampleRate, uint8_t bits, uint8_t channels,
+                              uint8_t maxVolume) {
     if (!_initialized) {
-        Serial.println("ERROR: Audio not initialized!");
+        LOG_E(AUDIO, "Audio not initialized!");
         return false;
     }
 
     if (buffer == nullptr || sizeBytes == 0) {
-        Serial.println("ERROR: Invalid PCM buffer!");
+        LOG_E(AUDIO, "Invalid PCM buffer!");
         return false;
     }
 
     // Validate parameters
     if (bits != 8 && bits != 16) {
-        Serial.println("ERROR: PCM bits must be 8 or 16!");
+        LOG_E(AUDIO, "PCM bits must be 8 or 16!");
         return false;
     }
 
     if (channels != 1 && channels != 2) {
-        Serial.println("ERROR: PCM channels must be 1 or 2!");
+        LOG_E(AUDIO, "PCM channels must be 1 or 2!");
         return false;
     }
 
-    Serial.printf(">>> playPCMBuffer: %d bytes, %dHz, %d-bit, %d-channel\n",
+    LOG_D(AUDIO, "playPCMBuffer: %d bytes, %dHz, %d-bit, %d-channel",
                   sizeBytes, sampleRate, bits, channels);
 
     // Stop any file playback first
@@ -525,9 +553,9 @@ bool AudioTest::playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t
     }
 
     // Acquire mutex for thread-safe PCM setup
-    Serial.println(">>> playPCMBuffer: Acquiring mutex...");
+    LOG_D(AUDIO, "playPCMBuffer: Acquiring mutex...");
     if (xSemaphoreTake(_audioMutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-        Serial.println("ERROR: playPCMBuffer() couldn't acquire mutex!");
+        LOG_E(AUDIO, "playPCMBuffer() couldn't acquire mutex!");
         return false;
     }
 
@@ -535,7 +563,7 @@ bool AudioTest::playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t
     if (_currentSoundType == SOUND_TYPE_PCM) {
         _pcmPlaying = false;
         _pcmPosition = _pcmSizeBytes;  // Jump to end to stop loop
-        Serial.println(">>> playPCMBuffer: Stopped previous PCM playback");
+        LOG_D(AUDIO, "playPCMBuffer: Stopped previous PCM playback");
     }
 
     // Clear I2S DMA buffer to remove any residual audio
@@ -554,11 +582,12 @@ bool AudioTest::playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t
     _pcmSampleRate = sampleRate;
     _pcmBits = bits;
     _pcmChannels = channels;
+    _playbackCap = (maxVolume < 100) ? maxVolume : 100;
     _pcmPlaying = true;
     _currentSoundType = SOUND_TYPE_PCM;
 
     xSemaphoreGive(_audioMutex);
-    Serial.println(">>> playPCMBuffer: PCM playback started");
+    LOG_D(AUDIO, "playPCMBuffer: PCM playback started");
 
     return true;
 }
@@ -576,16 +605,14 @@ void AudioTest::loop() {
 
     // Check if volume changed and update audioOut gain (non-blocking from BLE thread)
     if (_volumeChanged && audioOut != nullptr) {
-        audioOut->SetGain((_volume / 100.0f));
+        audioOut->SetGain(outputGain());
         _volumeChanged = false;
-        Serial.print(">>> loop: Applied volume change to ");
-        Serial.print(_volume);
-        Serial.println("%");
+        LOG_D(AUDIO, "loop: Applied volume change to %d%%", _volume);
     }
 
     // Handle PCM buffer playback
     if (_currentSoundType == SOUND_TYPE_PCM && _pcmPlaying) {
-        const size_t CHUNK_SIZE = 512;  // Write 512 bytes at a time
+        const size_t CHUNK_SIZE = PCM_CHUNK_BYTES;
         size_t bytesRemaining = _pcmSizeBytes - _pcmPosition;
 
         if (bytesRemaining > 0) {
@@ -593,53 +620,54 @@ void AudioTest::loop() {
             const uint8_t* dataPtr = _pcmBuffer + _pcmPosition;
 
             // Convert and write based on format
-            if (_pcmBits == 16 && _pcmChannels == 2) {
+            if (_pcmBits == 16 && _pcmChannels == 2 && _playbackCap < 100) {
+                // 16-bit stereo, attenuated to the playback cap
+                int16_t* scaledBuffer = _pcmScratch;
+                size_t sampleCount = bytesToWrite / 2;
+                AudioDsp::scale16((const int16_t*)dataPtr, scaledBuffer, sampleCount, _playbackCap);
+
+                size_t bytesWritten = 0;
+                Trace::begin(TRACE_AUDIO_I2S_WRITE, sampleCount * 2);
+                i2s_write(I2S_PORT, scaledBuffer, sampleCount * 2, &bytesWritten, portMAX_DELAY);
+                Trace::end(TRACE_AUDIO_I2S_WRITE);
+                _pcmPosition += bytesWritten;
+            } else if (_pcmBits == 16 && _pcmChannels == 2) {
                 // Direct write: 16-bit stereo (ideal format)
                 size_t bytesWritten = 0;
+                Trace::begin(TRACE_AUDIO_I2S_WRITE, bytesToWrite);
                 i2s_write(I2S_PORT, dataPtr, bytesToWrite, &bytesWritten, portMAX_DELAY);
+                Trace::end(TRACE_AUDIO_I2S_WRITE);
                 _pcmPosition += bytesWritten;
             } else if (_pcmBits == 16 && _pcmChannels == 1) {
                 // Convert mono to stereo: duplicate each sample
-                int16_t stereoBuffer[CHUNK_SIZE / 2];  // Half the size since we're duplicating
+                int16_t* stereoBuffer = _pcmScratch;    // Two values per input sample
                 size_t sampleCount = bytesToWrite / 2;  // 16-bit = 2 bytes per sample
-
-                for (size_t i = 0; i < sampleCount; i++) {
-                    int16_t sample = ((int16_t*)dataPtr)[i];
-                    stereoBuffer[i * 2] = sample;      // Left
-                    stereoBuffer[i * 2 + 1] = sample;  // Right
-                }
+                AudioDsp::mono16ToStereo((const int16_t*)dataPtr, stereoBuffer, sampleCount, _playbackCap);
 
                 size_t bytesWritten = 0;
+                Trace::begin(TRACE_AUDIO_I2S_WRITE, sampleCount * 4);
                 i2s_write(I2S_PORT, stereoBuffer, sampleCount * 4, &bytesWritten, portMAX_DELAY);
+                Trace::end(TRACE_AUDIO_I2S_WRITE);
                 _pcmPosition += bytesToWrite;
             } else if (_pcmBits == 8) {
                 // Convert 8-bit to 16-bit: shift left 8 bits and apply volume
-                int16_t buffer16[CHUNK_SIZE];
-                float volumeScale = (_volume / 100.0f);
-
-                if (_pcmChannels == 2) {
-                    // 8-bit stereo to 16-bit stereo
-                    for (size_t i = 0; i < bytesToWrite; i++) {
-                        buffer16[i] = (int16_t)((dataPtr[i] - 128) << 8) * volumeScale;
-                    }
-                    size_t bytesWritten = 0;
-                    i2s_write(I2S_PORT, buffer16, bytesToWrite * 2, &bytesWritten, portMAX_DELAY);
-                } else {
-                    // 8-bit mono to 16-bit stereo
-                    for (size_t i = 0; i < bytesToWrite; i++) {
-                        int16_t sample = (int16_t)((dataPtr[i] - 128) << 8) * volumeScale;
-                        buffer16[i * 2] = sample;      // Left
-                        buffer16[i * 2 + 1] = sample;  // Right
-                    }
-                    size_t bytesWritten = 0;
-                    i2s_write(I2S_PORT, buffer16, bytesToWrite * 4, &bytesWritten, portMAX_DELAY);
+                // (mono doubles in size, so it takes half a chunk at a time)
+                int16_t* buffer16 = _pcmScratch;
+                bool mono = (_pcmChannels != 2);
+                if (mono && bytesToWrite > CHUNK_SIZE / 2) {
+                    bytesToWrite = CHUNK_SIZE / 2;
                 }
+                size_t sampleCount = AudioDsp::pcm8To16(dataPtr, buffer16, bytesToWrite, mono, outputGain());
 
+                size_t bytesWritten = 0;
+                Trace::begin(TRACE_AUDIO_I2S_WRITE, sampleCount * 2);
+                i2s_write(I2S_PORT, buffer16, sampleCount * 2, &bytesWritten, portMAX_DELAY);
+                Trace::end(TRACE_AUDIO_I2S_WRITE);
                 _pcmPosition += bytesToWrite;
             }
         } else {
             // Finished playing PCM buffer
-            Serial.println(">>> loop: PCM buffer playback finished");
+            LOG_D(AUDIO, "loop: PCM buffer playback finished");
             _pcmPlaying = false;
             _currentSoundType = SOUND_TYPE_NONE;
             i2s_zero_dma_buffer(I2S_PORT);
@@ -659,44 +687,46 @@ void AudioTest::loop() {
 
         // Debug: Log state every 5 seconds
         if (now - lastStateLog >= 5000) {
-            Serial.printf(">>> AUDIO TASK: State check - mp3=%p, isRunning=%d\n",
-                         mp3, (mp3 != nullptr && mp3->isRunning()));
+            LOG_D(AUDIO, "AUDIO TASK: State check - mp3=0x%08x, isRunning=%d",
+                         (uint32_t)(uintptr_t)mp3, (mp3 != nullptr && mp3->isRunning()));
             lastStateLog = now;
         }
 
         // Process MP3 playback
         if (mp3 != nullptr && mp3->isRunning()) {
-            if (mp3->loop()) {
+            Trace::begin(TRACE_AUDIO_DECODE);
+            bool decoding = mp3->loop();
+            Trace::end(TRACE_AUDIO_DECODE);
+            if (decoding) {
                 isRunning = true;
 
                 // Debug: Log every 3 seconds to confirm decoder is running
                 if (now - lastDebugLog >= 3000) {
-                    Serial.printf(">>> AUDIO TASK: MP3 decoder active - audioOut=%p\n", audioOut);
+                    LOG_D(AUDIO, "AUDIO TASK: MP3 decoder active - audioOut=0x%08x", (uint32_t)(uintptr_t)audioOut);
                     lastDebugLog = now;
                 }
             } else {
                 // File finished
-                Serial.println("\n>>> loop: MP3 file finished");
+                LOG_D(AUDIO, "loop: MP3 file finished");
                 if (_loopFile) {
-                    Serial.println(">>> loop: Restarting for loop playback...");
+                    LOG_D(AUDIO, "loop: Restarting for loop playback...");
                     // Restart for looping
                     mp3->stop();
-                    delete mp3;
+                    mp3Slot.destroy();
                     mp3 = nullptr;
 
                     if (audioFile != nullptr) {
                         audioFile->close();
-                        delete audioFile;
 
-                        // Reopen and restart
-                        audioFile = new AudioFileSourceSPIFFS(_currentFilePath.c_str());
-                        mp3 = new AudioGeneratorMP3();
+                        // Reopen and restart (in place, no allocation)
+                        audioFile = sourceSlot.create(_currentSound);
+                        mp3 = createMp3();
                         mp3->begin(audioFile, audioOut);
-                        Serial.println(">>> loop: Restarted MP3 playback");
+                        LOG_D(AUDIO, "loop: Restarted MP3 playback");
                     }
                 } else {
                     // Finished, need to stop playback
-                    Serial.println(">>> loop: Non-looping file finished, will call stopFile()");
+                    LOG_D(AUDIO, "loop: Non-looping file finished, will call stopFile()");
                     needsStop = true;
                 }
             }
@@ -704,31 +734,33 @@ void AudioTest::loop() {
 
         // Process WAV playback
         if (wav != nullptr && wav->isRunning()) {
-            if (wav->loop()) {
+            Trace::begin(TRACE_AUDIO_DECODE);
+            bool decoding = wav->loop();
+            Trace::end(TRACE_AUDIO_DECODE);
+            if (decoding) {
                 isRunning = true;
             } else {
                 // File finished
-                Serial.println("\n>>> loop: WAV file finished");
+                LOG_D(AUDIO, "loop: WAV file finished");
                 if (_loopFile) {
-                    Serial.println(">>> loop: Restarting for loop playback...");
+                    LOG_D(AUDIO, "loop: Restarting for loop playback...");
                     // Restart for looping
                     wav->stop();
-                    delete wav;
+                    wavSlot.destroy();
                     wav = nullptr;
 
                     if (audioFile != nullptr) {
                         audioFile->close();
-                        delete audioFile;
 
-                        // Reopen and restart
-                        audioFile = new AudioFileSourceSPIFFS(_currentFilePath.c_str());
-                        wav = new AudioGeneratorWAV();
+                        // Reopen and restart (in place, no allocation)
+                        audioFile = sourceSlot.create(_currentSound);
+                        wav = wavSlot.create();
                         wav->begin(audioFile, audioOut);
-                        Serial.println(">>> loop: Restarted WAV playback");
+                        LOG_D(AUDIO, "loop: Restarted WAV playback");
                     }
                 } else {
                     // Finished, need to stop playback
-                    Serial.println(">>> loop: Non-looping file finished, will call stopFile()");
+                    LOG_D(AUDIO, "loop: Non-looping file finished, will call stopFile()");
                     needsStop = true;
                 }
             }
@@ -739,7 +771,7 @@ void AudioTest::loop() {
 
         // Call stopFile() outside mutex since it needs to acquire the mutex itself
         if (needsStop) {
-            Serial.println(">>> loop: Calling stopFile() because file finished");
+            LOG_D(AUDIO, "loop: Calling stopFile() because file finished");
             stopFile();
         }
     } else {
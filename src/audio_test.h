@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <driver/i2s.h>
 #include "config.h"
+#include "sound_bank.h"
 
 // Forward declaration for Audio library
 class Audio;
@@ -32,12 +33,15 @@ public:
      */
     bool begin();
 
+    static const uint8_t VOLUME_CURRENT = 255;  // playTone(): use the volume setting
+
     /**
      * Play a test tone at the specified frequency
      * @param frequency Frequency in Hz (e.g., 440 for A4 note)
      * @param duration Duration in milliseconds
+     * @param volume Volume for this tone only (0-100), leaving the setting untouched
      */
-    void playTone(uint16_t frequency, uint32_t duration);
+    void playTone(uint16_t frequency, uint32_t duration, uint8_t volume = VOLUME_CURRENT);
 
     /**
      * Stop audio output
@@ -58,11 +62,13 @@ public:
 
     /**
      * Play MP3/WAV file from SPIFFS
-     * @param path Full path to audio file (e.g., "/spiffs/alarms/alarm1.mp3")
+     * @param sound Location of the sound (see FileManager::locateSound); its bank pin is
+     *              released when playback stops, or here if playback cannot start
      * @param loop If true, loop the file continuously
+     * @param maxVolume Volume cap for this playback only (e.g. night-time button sounds)
      * @return true if playback started successfully, false otherwise
      */
-    bool playFile(const String& path, bool loop = false);
+    bool playFile(const SoundLocation& sound, bool loop = false, uint8_t maxVolume = 100);
 
     /**
      * Stop file playback
@@ -77,9 +83,11 @@ public:
      * @param sampleRate Sample rate (default: 44100 Hz)
      * @param bits Bits per sample (8 or 16, default: 16)
      * @param channels Number of channels (1=mono, 2=stereo, default: 2)
+     * @param maxVolume Volume cap for this playback only (100 = play 16-bit data unscaled)
      * @return true if playback started successfully
      */
-    bool playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t sampleRate = 44100, uint8_t bits = 16, uint8_t channels = 2);
+    bool playPCMBuffer(const uint8_t* buffer, size_t sizeBytes, uint32_t sampleRate = 44100, uint8_t bits = 16, uint8_t channels = 2,
+                       uint8_t maxVolume = 100);
 
     /**
      * Check if audio is currently playing
@@ -103,10 +111,11 @@ private:
     bool _initialized;
     uint8_t _volume;  // Volume level 0-100 (default: 70)
     volatile bool _volumeChanged;  // Flag: volume changed, needs audioOut update
+    uint8_t _playbackCap;  // Volume cap of the current playback (100 = none)
     volatile SoundType _currentSoundType;  // Track what's currently playing (volatile for multi-core)
     Audio* _audioLib;  // ESP32-audioI2S library instance for file playback
     bool _loopFile;  // Whether to loop file playback
-    String _currentFilePath;  // Current file being played (for looping)
+    SoundLocation _currentSound;  // Current sound being played (for looping)
     SemaphoreHandle_t _audioMutex;  // Mutex for thread-safe audio operations
 
     // PCM buffer playback state
@@ -118,7 +127,17 @@ private:
     uint8_t _pcmChannels;       // Number of channels (1 or 2)
     bool _pcmPlaying;           // Flag: PCM playback active
 
+    // Conversion output for loop() (a member, so 1 KB stays off the audio task stack;
+    // only touched with _audioMutex held)
+    static const size_t PCM_CHUNK_BYTES = 512;  // Source bytes written per loop() call
+    int16_t _pcmScratch[PCM_CHUNK_BYTES];       // Room for mono 16-bit doubled to stereo
+
     static const i2s_port_t I2S_PORT = I2S_NUM_0;
+
+    /**
+     * Gain for file playback: volume limited by the playback cap
+     */
+    float outputGain() const { return ((_volume < _playbackCap) ? _volume : _playbackCap) / 100.0f; }
     static const uint32_t SAMPLE_RATE = 44100;
 
     /**
@@ -126,9 +145,15 @@ private:
      * @param buffer Output buffer
      * @param bufferSize Size of buffer in samples
      * @param frequency Frequency of the tone
+     * @param volume Volume level 0-100
      * @param phase Current phase (updated by function)
      */
-    void generateSineWave(int16_t* buffer, size_t bufferSize, uint16_t frequency, float& phase);
+    void generateSineWave(int16_t* buffer, size_t bufferSize, uint16_t frequency, uint8_t volume, float& phase);
+
+    /**
+     * Forget the current sound and release its bank pin (call with _audioMutex held)
+     */
+    void releaseCurrentSound();
 };
 
 #endif // AUDIO_TEST_H
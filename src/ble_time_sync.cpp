@@ -1,11 +1,14 @@
 #include "ble_time_sync.h"
+#include "log.h"
+#include "metrics.h"
+#include "trace.h"
 #include "alarm_manager.h"
+#include "alarm_protocol.h"
 #include "audio_test.h"
 #include "file_manager.h"
 #include "display_manager.h"
 #include "frontlight_manager.h"
-#include <SPIFFS.h>
-#include <Preferences.h>
+#include "settings_store.h"
 
 // External references
 extern AlarmManager alarmManager;
@@ -13,14 +16,24 @@ extern AudioTest audioObj;
 extern FileManager fileManager;
 extern DisplayManager displayManager;
 extern FrontlightManager frontlightManager;
+extern SettingsStore settings;
 
 // External function for WAV preloading (defined in main.cpp)
-extern bool loadButtonSoundWAV(const String& filePath);
+extern bool loadButtonSoundWAV(const char* soundName);
+
+// Link and upload metrics
+static Counter connections("ble.connections");
+static Counter rxBytes("ble.rx_bytes");
+static Counter rxChunks("ble.rx_chunks");
+static Counter uploads("ble.uploads");
+static Counter uploadErrors("ble.upload_errors");
+static Gauge uploadRate("ble.upload_Bps");  // Payload bytes per second of the last completed upload
 
 // BLE Service UUID: Custom time sync service
 const char* BLETimeSync::SERVICE_UUID = "12340000-1234-5678-1234-56789abcdef0";
 const char* BLETimeSync::TIME_CHAR_UUID = "12340001-1234-5678-1234-56789abcdef0";
 const char* BLETimeSync::DATETIME_CHAR_UUID = "12340002-1234-5678-1234-56789abcdef0";
+const char* BLETimeSync::TIMEZONE_CHAR_UUID = "12340003-1234-5678-1234-56789abcdef0";
 
 // BLE Settings Service UUID: Volume, brightness, display customization
 const char* BLETimeSync::SETTINGS_SERVICE_UUID = "12340030-1234-5678-1234-56789abcdef0";
@@ -47,6 +60,10 @@ const char* BLETimeSync::FILE_DATA_CHAR_UUID = "12340022-1234-5678-1234-56789abc
 const char* BLETimeSync::FILE_STATUS_CHAR_UUID = "12340023-1234-5678-1234-56789abcdef0";
 const char* BLETimeSync::FILE_LIST_CHAR_UUID = "12340024-1234-5678-1234-56789abcdef0";
 
+// BLE Diagnostics Service UUID: Runtime metrics snapshot
+const char* BLETimeSync::DIAGNOSTICS_SERVICE_UUID = "12340050-1234-5678-1234-56789abcdef0";
+const char* BLETimeSync::METRICS_CHAR_UUID = "12340051-1234-5678-1234-56789abcdef0";
+
 BLETimeSync::BLETimeSync()
     : _pServer(nullptr),
       _pTimeService(nullptr),
@@ -54,8 +71,10 @@ BLETimeSync::BLETimeSync()
       _pButtonService(nullptr),
       _pAlarmService(nullptr),
       _pFileService(nullptr),
+      _pDiagnosticsService(nullptr),
       _pTimeCharacteristic(nullptr),
       _pDateTimeCharacteristic(nullptr),
+      _pTimeZoneCharacteristic(nullptr),
       _pVolumeCharacteristic(nullptr),
       _pTestSoundCharacteristic(nullptr),
       _pBrightnessCharacteristic(nullptr),
@@ -67,14 +86,18 @@ BLETimeSync::BLETimeSync()
       _pFileDataCharacteristic(nullptr),
       _pFileStatusCharacteristic(nullptr),
       _pFileListCharacteristic(nullptr),
+      _pMetricsCharacteristic(nullptr),
       _deviceConnected(false),
       _connectionCount(0),
       _timeSyncCallback(nullptr),
+      _timeZoneCallback(nullptr),
       _fileTransferState(FILE_IDLE),
       _receivingFilename(""),
       _receivingFileSize(0),
       _receivedBytes(0),
       _expectedSequence(0),
+      _transferStartMs(0),
+      _metricsPage(0),
       _testSoundRequested(false),
       _pendingTestSoundFile("") {
 }
@@ -108,13 +131,20 @@ bool BLETimeSync::begin(const char* deviceName) {
     _pDateTimeCharacteristic->setCallbacks(new DateTimeCharCallbacks(this));
     _pDateTimeCharacteristic->addDescriptor(new BLE2902());
 
+    // Create Time Zone Characteristic (POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
+    _pTimeZoneCharacteristic = _pTimeService->createCharacteristic(
+        TIMEZONE_CHAR_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
+    );
+    _pTimeZoneCharacteristic->setCallbacks(new TimeZoneCharCallbacks(this));
+
     // Set initial value
     time_t currentTime = time(nullptr);
     uint32_t timeValue = (uint32_t)currentTime;
     _pTimeCharacteristic->setValue(timeValue);
 
     // Start the time service
-    Serial.println("BLE: Starting Time service with 2 characteristics...");
+    Serial.println("BLE: Starting Time service with 3 characteristics...");
     _pTimeService->start();
     Serial.println("BLE: Time service started successfully");
 
@@ -144,7 +174,12 @@ bool BLETimeSync::begin(const char* deviceName) {
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
     );
     _pDisplayMessageCharacteristic->setCallbacks(new DisplayMessageCharCallbacks(this));
-    _pDisplayMessageCharacteristic->setValue(displayManager.getCustomMessage().c_str());
+
+    // Initial values from the settings store: DisplayManager may still be
+    // loading its own copies on the setup task
+    FixedString<CUSTOM_MESSAGE_MAX> customMessage;
+    settings.getCustomMessage(customMessage);
+    _pDisplayMessageCharacteristic->setValue(customMessage.c_str());
 
     // Create Bottom Row Label Characteristic (Read/Write: custom label for bottom row, max 50 chars)
     _pBottomRowLabelCharacteristic = _pSettingsService->createCharacteristic(
@@ -152,7 +187,9 @@ bool BLETimeSync::begin(const char* deviceName) {
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
     );
     _pBottomRowLabelCharacteristic->setCallbacks(new BottomRowLabelCharCallbacks(this));
-    _pBottomRowLabelCharacteristic->setValue(displayManager.getBottomRowLabel().c_str());
+    FixedString<BOTTOM_LABEL_MAX> bottomRowLabel;
+    settings.getBottomRowLabel(bottomRowLabel);
+    _pBottomRowLabelCharacteristic->setValue(bottomRowLabel.c_str());
 
     // Create Brightness Characteristic (Read/Write: 0-100%)
     _pBrightnessCharacteristic = _pSettingsService->createCharacteristic(
@@ -180,11 +217,9 @@ bool BLETimeSync::begin(const char* deviceName) {
     _pButtonSoundCharacteristic->setCallbacks(new ButtonSoundCharCallbacks(this));
     _pButtonSoundCharacteristic->addDescriptor(new BLE2902());
 
-    // Load initial value from NVS
-    Preferences buttonPrefs;
-    buttonPrefs.begin("button", true);
-    String buttonSound = buttonPrefs.getString("sound", "");
-    buttonPrefs.end();
+    // Load initial value from the settings store
+    SoundName buttonSound;
+    settings.getButtonSound(buttonSound);
     _pButtonSoundCharacteristic->setValue(buttonSound.c_str());
 
     // Start the button service
@@ -224,7 +259,7 @@ bool BLETimeSync::begin(const char* deviceName) {
     // Create BLE File Service
     _pFileService = _pServer->createService(FILE_SERVICE_UUID);
 
-    // Create File Control Characteristic (Write: START:<filename>:<size>, END, CANCEL)
+    // Create File Control Characteristic (Write: START:<filename>:<size>[:<sha256>], END, CANCEL)
     _pFileControlCharacteristic = _pFileService->createCharacteristic(
         FILE_CONTROL_CHAR_UUID,
         BLECharacteristic::PROPERTY_WRITE
@@ -256,6 +291,18 @@ bool BLETimeSync::begin(const char* deviceName) {
     // Start the file service
     _pFileService->start();
 
+    // Create BLE Diagnostics Service (not advertised; found by service discovery)
+    _pDiagnosticsService = _pServer->createService(DIAGNOSTICS_SERVICE_UUID);
+
+    // Create Metrics Characteristic (Write: page number, Read: "<page>/<pages>" + one metric per line)
+    _pMetricsCharacteristic = _pDiagnosticsService->createCharacteristic(
+        METRICS_CHAR_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
+    );
+    _pMetricsCharacteristic->setCallbacks(new MetricsCharCallbacks(this));
+
+    _pDiagnosticsService->start();
+
     // Start advertising
     BLEAdvertising* pAdvertising = BLEDevice::getAdvertising();
     pAdvertising->addServiceUUID(SERVICE_UUID);
@@ -267,19 +314,9 @@ bool BLETimeSync::begin(const char* deviceName) {
     pAdvertising->setMaxPreferred(0x12);  // 22.5ms maximum interval
     BLEDevice::startAdvertising();
 
-    Serial.println("BLETimeSync: BLE services started!");
-    Serial.print("BLETimeSync: Device name: ");
-    Serial.println(deviceName);
-    Serial.println("\nTime Service:");
-    Serial.println("  - DateTime characteristic: Write YYYY-MM-DD HH:MM:SS");
-    Serial.println("\nAlarm Service:");
-    Serial.println("  - AlarmSet: Write JSON alarm data");
-    Serial.println("  - AlarmList: Read JSON array of alarms");
-    Serial.println("  - AlarmDelete: Write alarm ID to delete\n");
-
-    // Initialize file list characteristic
-    updateFileList();
+    Serial.printf("BLETimeSync: Advertising as '%s'\n", deviceName);
 
+    // The file list characteristic is filled by updateFileList() once storage is mounted
     return true;
 }
 
@@ -296,6 +333,16 @@ void BLETimeSync::setTimeSyncCallback(TimeSyncCallback callback) {
     _timeSyncCallback = callback;
 }
 
+void BLETimeSync::setTimeZoneCallback(TimeZoneCallback callback) {
+    _timeZoneCallback = callback;
+}
+
+void BLETimeSync::setTimeZoneValue(const char* tz) {
+    if (_pTimeZoneCharacteristic) {
+        _pTimeZoneCharacteristic->setValue(tz);
+    }
+}
+
 uint32_t BLETimeSync::getConnectionCount() {
     return _connectionCount;
 }
@@ -303,39 +350,19 @@ uint32_t BLETimeSync::getConnectionCount() {
 void BLETimeSync::updateAlarmList() {
     if (!_pAlarmListCharacteristic) return;
 
-    // Build JSON array of all alarms
-    String json = "[";
+    // Build JSON array of all alarms in one buffer sized for the worst case
     std::vector<AlarmData> alarms = alarmManager.getAllAlarms();
-
-    for (size_t i = 0; i < alarms.size(); i++) {
-        if (i > 0) json += ",";
-
-        json += "{\"id\":";
-        json += String(alarms[i].id);
-        json += ",\"hour\":";
-        json += String(alarms[i].hour);
-        json += ",\"minute\":";
-        json += String(alarms[i].minute);
-        json += ",\"days\":";
-        json += String(alarms[i].daysOfWeek);
-        json += ",\"sound\":\"";
-        json += alarms[i].sound;
-        json += "\",\"enabled\":";
-        json += alarms[i].enabled ? "true" : "false";
-        json += ",\"label\":\"";
-        json += alarms[i].label;
-        json += "\",\"snooze\":";
-        json += alarms[i].snoozeEnabled ? "true" : "false";
-        json += ",\"perm_disabled\":";
-        json += alarms[i].permanentlyDisabled ? "true" : "false";
-        json += ",\"bottomRowLabel\":\"";
-        json += alarms[i].bottomRowLabel;
-        json += "\"}";
+    size_t size = alarms.size() * AlarmProtocol::ALARM_JSON_MAX + 3;
+    char* json = (char*)malloc(size);
+    if (json == nullptr) {
+        LOG_E(BLE, "Alarm list: Out of memory (%u bytes)", size);
+        return;
     }
+    StringBuilder out(json, size);
+    AlarmProtocol::formatAlarmList(alarms, out);
 
-    json += "]";
-
-    _pAlarmListCharacteristic->setValue(json.c_str());
+    _pAlarmListCharacteristic->setValue((uint8_t*)out.c_str(), out.length());
+    free(json);
     Serial.print("BLE: Updated alarm list (");
     Serial.print(alarms.size());
     Serial.println(" alarms)");
@@ -344,29 +371,34 @@ void BLETimeSync::updateAlarmList() {
 void BLETimeSync::updateFileList() {
     if (!_pFileListCharacteristic) return;
 
-    // Build JSON array of all sound files
-    String json = "[";
+    // Build JSON array of all sound files in one buffer sized for the worst case
+    // (an entry is 45 bytes of keys and punctuation, the name and two numbers)
     std::vector<SoundFileInfo> files = fileManager.getSoundFileList();
+    static const size_t FILE_JSON_MAX = 45 + (SOUND_NAME_BUFFER_LEN - 1) + 2 * 10;
+    size_t size = files.size() * FILE_JSON_MAX + 3;
+    char* json = (char*)malloc(size);
+    if (json == nullptr) {
+        LOG_E(BLE, "File list: Out of memory (%u bytes)", size);
+        return;
+    }
+    StringBuilder out(json, size);
 
+    out += '[';
     for (size_t i = 0; i < files.size(); i++) {
-        if (i > 0) json += ",";
-
-        json += "{\"filename\":\"";
-        json += files[i].filename;
-        json += "\",\"size\":";
-        json += String(files[i].fileSize);
-        json += "}";
+        if (i > 0) out += ',';
+        out.appendf("{\"filename\":\"%s\",\"size\":%u,\"durationMs\":%u}",
+                    files[i].filename.c_str(), (uint32_t)files[i].fileSize, (uint32_t)files[i].durationMs);
     }
+    out += ']';
 
-    json += "]";
-
-    _pFileListCharacteristic->setValue(json.c_str());
+    _pFileListCharacteristic->setValue((uint8_t*)out.c_str(), out.length());
     _pFileListCharacteristic->notify();  // Notify iOS app of file list update
     Serial.print("BLE: Updated file list (");
     Serial.print(files.size());
     Serial.println(" files)");
     Serial.print("BLE: File list JSON: ");
-    Serial.println(json);
+    Serial.println(out.c_str());
+    free(json);
 }
 
 bool BLETimeSync::isFileTransferring() {
@@ -377,11 +409,10 @@ bool BLETimeSync::hasTestSoundRequest() {
     return _testSoundRequested;
 }
 
-String BLETimeSync::getPendingTestSound() {
+void BLETimeSync::getPendingTestSound(StringBuilder& out) {
     _testSoundRequested = false;
-    String soundFile = _pendingTestSoundFile;
-    _pendingTestSoundFile = "";
-    return soundFile;
+    out.assign(_pendingTestSoundFile);
+    _pendingTestSoundFile.clear();
 }
 
 // ============================================
@@ -389,14 +420,17 @@ String BLETimeSync::getPendingTestSound() {
 // ============================================
 
 void BLETimeSync::ServerCallbacks::onConnect(BLEServer* pServer) {
+    Trace::instant(TRACE_BLE_CONNECT, 1);
     _parent->_deviceConnected = true;
     _parent->_connectionCount++;
+    connections.add();
     Serial.println("\n>>> BLE Client Connected!");
     Serial.print("Total connections: ");
     Serial.println(_parent->_connectionCount);
 }
 
 void BLETimeSync::ServerCallbacks::onDisconnect(BLEServer* pServer) {
+    Trace::instant(TRACE_BLE_CONNECT, 0);
     _parent->_deviceConnected = false;
     Serial.println("\n>>> BLE Client Disconnected!");
     // Restart advertising
@@ -409,6 +443,7 @@ void BLETimeSync::ServerCallbacks::onDisconnect(BLEServer* pServer) {
 // ============================================
 
 void BLETimeSync::TimeCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() >= 4) {
@@ -432,6 +467,7 @@ void BLETimeSync::TimeCharCallbacks::onWrite(BLECharacteristic* pCharacteristic)
 // ============================================
 
 void BLETimeSync::DateTimeCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() > 0) {
@@ -445,8 +481,9 @@ void BLETimeSync::DateTimeCharCallbacks::onWrite(BLECharacteristic* pCharacteris
                            &year, &month, &day, &hour, &minute, &second);
 
         if (parsed == 6) {
-            // Convert to Unix timestamp
-            struct tm timeinfo;
+            // Convert local time to Unix timestamp (TZ is set by TimeManager)
+            struct tm timeinfo = {};
+            timeinfo.tm_isdst = -1;  // Let the zone rules decide
             timeinfo.tm_year = year - 1900;
             timeinfo.tm_mon = month - 1;
             timeinfo.tm_mday = day;
@@ -480,11 +517,28 @@ void BLETimeSync::DateTimeCharCallbacks::onWrite(BLECharacteristic* pCharacteris
     }
 }
 
+// ============================================
+// Time Zone Characteristic Callbacks
+// ============================================
+
+void BLETimeSync::TimeZoneCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
+    std::string value = pCharacteristic->getValue();
+
+    Serial.print("\n>>> Received time zone via BLE: ");
+    Serial.println(value.c_str());
+
+    if (_parent->_timeZoneCallback) {
+        _parent->_timeZoneCallback(value.c_str());
+    }
+}
+
 // ============================================
 // Alarm Set Characteristic Callbacks
 // ============================================
 
 void BLETimeSync::AlarmSetCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() > 0) {
@@ -492,81 +546,10 @@ void BLETimeSync::AlarmSetCharCallbacks::onWrite(BLECharacteristic* pCharacteris
         Serial.print("JSON: ");
         Serial.println(value.c_str());
 
-        // Parse JSON: {"id":0,"hour":7,"minute":30,"days":127,"sound":"tone1","enabled":true,"label":"Alarm","snooze":true}
-        // Simple manual parsing (to avoid ArduinoJson dependency)
-
         AlarmData alarm;
-        String json = String(value.c_str());
-
-        // Extract id
-        int idIdx = json.indexOf("\"id\":");
-        if (idIdx >= 0) {
-            alarm.id = json.substring(idIdx + 5).toInt();
-        }
-
-        // Extract hour
-        int hourIdx = json.indexOf("\"hour\":");
-        if (hourIdx >= 0) {
-            alarm.hour = json.substring(hourIdx + 7).toInt();
-        }
-
-        // Extract minute
-        int minIdx = json.indexOf("\"minute\":");
-        if (minIdx >= 0) {
-            alarm.minute = json.substring(minIdx + 9).toInt();
-        }
-
-        // Extract days
-        int daysIdx = json.indexOf("\"days\":");
-        if (daysIdx >= 0) {
-            alarm.daysOfWeek = json.substring(daysIdx + 7).toInt();
-        }
-
-        // Extract sound
-        int soundIdx = json.indexOf("\"sound\":\"");
-        if (soundIdx >= 0) {
-            int soundEnd = json.indexOf("\"", soundIdx + 9);
-            alarm.sound = json.substring(soundIdx + 9, soundEnd);
-        }
-
-        // Extract enabled
-        int enabledIdx = json.indexOf("\"enabled\":");
-        if (enabledIdx >= 0) {
-            alarm.enabled = json.substring(enabledIdx + 10, enabledIdx + 14) == "true";
-        }
-
-        // Extract label (optional for backward compatibility)
-        int labelIdx = json.indexOf("\"label\":\"");
-        if (labelIdx >= 0) {
-            int labelEnd = json.indexOf("\"", labelIdx + 9);
-            alarm.label = json.substring(labelIdx + 9, labelEnd);
-        } else {
-            alarm.label = "Alarm";  // Default
-        }
-
-        // Extract snooze (optional for backward compatibility)
-        int snoozeIdx = json.indexOf("\"snooze\":");
-        if (snoozeIdx >= 0) {
-            alarm.snoozeEnabled = json.substring(snoozeIdx + 9, snoozeIdx + 13) == "true";
-        } else {
-            alarm.snoozeEnabled = true;  // Default
-        }
-
-        // Extract perm_disabled (optional for backward compatibility)
-        int permDisabledIdx = json.indexOf("\"perm_disabled\":");
-        if (permDisabledIdx >= 0) {
-            alarm.permanentlyDisabled = json.substring(permDisabledIdx + 16, permDisabledIdx + 20) == "true";
-        } else {
-            alarm.permanentlyDisabled = false;  // Default
-        }
-
-        // Extract bottomRowLabel (optional for backward compatibility)
-        int bottomRowIdx = json.indexOf("\"bottomRowLabel\":\"");
-        if (bottomRowIdx >= 0) {
-            int bottomRowEnd = json.indexOf("\"", bottomRowIdx + 18);
-            alarm.bottomRowLabel = json.substring(bottomRowIdx + 18, bottomRowEnd);
-        } else {
-            alarm.bottomRowLabel = "";  // Default empty
+        if (!AlarmProtocol::parseAlarm(value.c_str(), alarm)) {
+            Serial.println("BLE: ERROR - Alarm JSON needs id, hour and minute!");
+            return;
         }
 
         // Set the alarm
@@ -585,6 +568,7 @@ void BLETimeSync::AlarmSetCharCallbacks::onWrite(BLECharacteristic* pCharacteris
 // ============================================
 
 void BLETimeSync::AlarmDeleteCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() > 0) {
@@ -608,6 +592,7 @@ void BLETimeSync::AlarmDeleteCharCallbacks::onWrite(BLECharacteristic* pCharacte
 // ============================================
 
 void BLETimeSync::VolumeCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() > 0) {
@@ -629,11 +614,12 @@ void BLETimeSync::VolumeCharCallbacks::onWrite(BLECharacteristic* pCharacteristi
 // ============================================
 
 void BLETimeSync::TestSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
-    String soundName = String(value.c_str());
+    StringView soundName(value.c_str(), value.length());
 
     Serial.print(">>> BLE: Test sound requested: ");
-    Serial.println(soundName);
+    Serial.println(value.c_str());
 
     // Don't allow test sounds while alarm is ringing (prevents race condition)
     if (alarmManager.isAlarmRinging()) {
@@ -665,7 +651,7 @@ void BLETimeSync::TestSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteri
         }
 
         Serial.print("\n>>> BLE: Playing test tone '");
-        Serial.print(soundName);
+        Serial.print(value.c_str());
         Serial.print("' (");
         Serial.print(frequency);
         Serial.println(" Hz for 2 seconds)");
@@ -673,10 +659,9 @@ void BLETimeSync::TestSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteri
         audioObj.playTone(frequency, 2000);
     } else {
         // Try to play custom sound file from SPIFFS
-        String filePath = String(ALARM_SOUNDS_DIR) + "/" + soundName;
-        if (fileManager.fileExists(filePath)) {
+        if (fileManager.soundExists(value.c_str())) {
             Serial.print("\n>>> BLE: Playing test file '");
-            Serial.print(soundName);
+            Serial.print(value.c_str());
             Serial.println("' (queued for playback)");
 
             // Queue the test sound request - main loop will handle playback and priming
@@ -686,7 +671,7 @@ void BLETimeSync::TestSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteri
         } else {
             // File not found - play tone1 as fallback
             Serial.print("\n>>> BLE: File not found '");
-            Serial.print(soundName);
+            Serial.print(value.c_str());
             Serial.println("', using tone1 fallback (2 seconds)");
 
             audioObj.playTone(262, 2000);
@@ -695,22 +680,24 @@ void BLETimeSync::TestSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteri
 }
 
 void BLETimeSync::DisplayMessageCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
-    String message = String(value.c_str());
+    const char* message = value.c_str();
 
     Serial.print("\n>>> BLE: Display message set to: ");
-    Serial.println(message.length() > 0 ? message : "(empty - using day of week)");
+    Serial.println(message[0] != '\0' ? message : "(empty - using day of week)");
 
     // Update DisplayManager with new message
     displayManager.setCustomMessage(message);
 }
 
 void BLETimeSync::BottomRowLabelCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
-    String label = String(value.c_str());
+    const char* label = value.c_str();
 
     Serial.print("\n>>> BLE: Bottom row label set to: ");
-    Serial.println(label.length() > 0 ? label : "(empty - using default layout)");
+    Serial.println(label[0] != '\0' ? label : "(empty - using default layout)");
 
     // Update DisplayManager with new bottom row label
     displayManager.setBottomRowLabel(label);
@@ -721,6 +708,7 @@ void BLETimeSync::BottomRowLabelCharCallbacks::onWrite(BLECharacteristic* pChara
 // ============================================
 
 void BLETimeSync::BrightnessCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
 
     if (value.length() > 0) {
@@ -742,51 +730,47 @@ void BLETimeSync::BrightnessCharCallbacks::onWrite(BLECharacteristic* pCharacter
 // ============================================
 
 void BLETimeSync::ButtonSoundCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
-    String soundFile = String(value.c_str());
+    SoundName soundFile(value.c_str());
 
-    Serial.printf("\n>>> BLE: Received button sound setting: '%s'\n", soundFile.c_str());
+    Serial.printf("\n>>> BLE: Received button sound setting: '%s'\n", value.c_str());
+    if (soundFile.truncated()) {
+        Serial.println(">>> BLE: ERROR - Button sound filename too long");
+        return;
+    }
 
     // Validate file exists (if not empty string)
     if (soundFile.length() > 0) {
-        String soundPath = String(ALARM_SOUNDS_DIR) + "/" + soundFile;
-        if (!fileManager.fileExists(soundPath)) {
+        if (!fileManager.soundExists(soundFile.c_str())) {
             Serial.printf(">>> BLE: WARNING - Button sound file not found: %s\n", soundFile.c_str());
             // Still save it - user may upload file later
         }
     }
 
-    // Save to NVS
-    Preferences prefs;
-    prefs.begin("button", false);
-    prefs.putString("sound", soundFile);
-    prefs.end();
+    // Save (written to NVS once changes settle)
+    settings.setButtonSound(soundFile.c_str());
 
     // Update global variables in main.cpp
-    extern String buttonSoundFile;
-    extern String buttonSoundPath;
+    extern SoundName buttonSoundFile;
     buttonSoundFile = soundFile;
 
-    // Update cached path for fast playback
     if (soundFile.length() > 0) {
-        buttonSoundPath = String(ALARM_SOUNDS_DIR) + "/" + soundFile;
         Serial.printf(">>> BLE: Button sound saved: '%s'\n", soundFile.c_str());
 
         // Check if it's a WAV file - preload into PSRAM for instant playback
-        String lowerPath = soundFile;
-        lowerPath.toLowerCase();
-        if (lowerPath.endsWith(".wav")) {
+        SoundCodec codec = SoundCatalog::codecFromName(soundFile.c_str());
+        if (codec == SOUND_CODEC_WAV) {
             Serial.println(">>> BLE: Preloading WAV file into PSRAM...");
-            if (loadButtonSoundWAV(buttonSoundPath)) {
+            if (loadButtonSoundWAV(soundFile.c_str())) {
                 Serial.println(">>> BLE: WAV preloading successful!");
             } else {
                 Serial.println(">>> BLE: WAV preloading failed - will use normal file playback");
             }
-        } else if (lowerPath.endsWith(".mp3")) {
+        } else if (codec == SOUND_CODEC_MP3) {
             Serial.println(">>> BLE: MP3 file - will use streaming playback (~2 second delay)");
         }
     } else {
-        buttonSoundPath = "";
         Serial.println(">>> BLE: Button sound disabled (empty string)");
 
         // Free any existing PCM buffer
@@ -806,101 +790,72 @@ void BLETimeSync::ButtonSoundCharCallbacks::onWrite(BLECharacteristic* pCharacte
 // ============================================
 
 void BLETimeSync::FileControlCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     std::string value = pCharacteristic->getValue();
-    String command = String(value.c_str());
+    StringView command(value.c_str(), value.length());
 
     Serial.print("\n>>> BLE FILE: Control command: ");
-    Serial.println(command);
+    Serial.println(value.c_str());
 
     if (command.startsWith("START:")) {
-        // Parse: START:<filename>:<filesize>
+        // Parse: START:<filename>:<filesize>[:<sha256hex>]
         int firstColon = command.indexOf(':', 6);
         if (firstColon > 0) {
-            String filename = command.substring(6, firstColon);
-            String sizeStr = command.substring(firstColon + 1);
-            size_t fileSize = sizeStr.toInt();
+            SoundName filename(command.substring(6, firstColon));
+            if (filename.truncated()) {
+                _parent->updateFileStatus("ERROR:Invalid filename");
+                return;
+            }
+            int secondColon = command.indexOf(':', firstColon + 1);
+            StringView sizeStr = (secondColon > 0) ? command.substring(firstColon + 1, secondColon)
+                                                   : command.substring(firstColon + 1);
+            size_t fileSize = sizeStr.toUInt();
+
+            // Optional content hash lets identical sounds be stored once
+            uint8_t digest[SOUND_DIGEST_LEN];
+            bool hasDigest = false;
+            if (secondColon > 0) {
+                hasDigest = SoundBank::parseDigest(value.c_str() + secondColon + 1, digest);
+                if (!hasDigest) {
+                    _parent->updateFileStatus("ERROR:Invalid SHA-256");
+                    return;
+                }
+            }
 
-            _parent->startFileTransfer(filename, fileSize);
+            _parent->startFileTransfer(filename.c_str(), fileSize, hasDigest ? digest : nullptr);
         } else {
             _parent->updateFileStatus("ERROR:Invalid START format");
         }
     } else if (command == "END") {
         // Finish file transfer
         if (_parent->_fileTransferState == FILE_RECEIVING) {
-            if (_parent->_receivingFile) {
-                _parent->_receivingFile.flush();  // Ensure all data is written
-                _parent->_receivingFile.close();
-            }
-
-            if (_parent->_receivedBytes == _parent->_receivingFileSize) {
+            if (_parent->_receivedBytes == _parent->_receivingFileSize && fileManager.finishUpload()) {
                 _parent->_fileTransferState = FILE_COMPLETE;
                 _parent->updateFileStatus("SUCCESS");
-                Serial.println(">>> BLE FILE: Transfer complete successfully!");
+                uint32_t elapsedMs = millis() - _parent->_transferStartMs;
+                uploads.add();
+                uploadRate.set(elapsedMs ? (int32_t)((uint64_t)_parent->_receivedBytes * 1000 / elapsedMs) : 0);
                 Serial.printf(">>> BLE FILE: Saved file: %s (%u bytes)\n", _parent->_receivingFilename.c_str(), _parent->_receivedBytes);
 
-                // Small delay to ensure SPIFFS commits the file
-                delay(100);
-
-                // Verify file was actually saved - try both path formats
-                String pathWithPrefix = String(ALARM_SOUNDS_DIR) + "/" + _parent->_receivingFilename;
-                String pathWithoutPrefix = "/alarms/" + _parent->_receivingFilename;
-
-                Serial.printf(">>> BLE FILE: Checking if file exists...\n");
-                Serial.printf(">>> BLE FILE:   Path with /spiffs prefix: %s\n", pathWithPrefix.c_str());
-                Serial.printf(">>> BLE FILE:   Path without prefix: %s\n", pathWithoutPrefix.c_str());
-
-                bool existsWithPrefix = SPIFFS.exists(pathWithPrefix.c_str());
-                bool existsWithoutPrefix = SPIFFS.exists(pathWithoutPrefix.c_str());
-
-                Serial.printf(">>> BLE FILE:   Exists with prefix: %s\n", existsWithPrefix ? "YES" : "NO");
-                Serial.printf(">>> BLE FILE:   Exists without prefix: %s\n", existsWithoutPrefix ? "YES" : "NO");
-
-                if (existsWithoutPrefix) {
-                    File verifyFile = SPIFFS.open(pathWithoutPrefix.c_str(), "r");
-                    if (verifyFile) {
-                        size_t actualSize = verifyFile.size();
-                        verifyFile.close();
-                        Serial.printf(">>> BLE FILE: VERIFIED - File exists at %s with size %u\n", pathWithoutPrefix.c_str(), actualSize);
-                    } else {
-                        Serial.printf(">>> BLE FILE: WARNING - File exists but cannot open: %s\n", pathWithoutPrefix.c_str());
-                    }
-                } else if (existsWithPrefix) {
-                    File verifyFile = SPIFFS.open(pathWithPrefix.c_str(), "r");
-                    if (verifyFile) {
-                        size_t actualSize = verifyFile.size();
-                        verifyFile.close();
-                        Serial.printf(">>> BLE FILE: VERIFIED - File exists at %s with size %u\n", pathWithPrefix.c_str(), actualSize);
-                    } else {
-                        Serial.printf(">>> BLE FILE: WARNING - File exists but cannot open: %s\n", pathWithPrefix.c_str());
-                    }
-                } else {
-                    Serial.printf(">>> BLE FILE: ERROR - File does NOT exist with either path format!\n");
-                    Serial.println(">>> BLE FILE: Listing /alarms directory to debug...");
-                    File debugDir = SPIFFS.open("/alarms");
-                    if (debugDir && debugDir.isDirectory()) {
-                        File debugFile = debugDir.openNextFile();
-                        while (debugFile) {
-                            Serial.printf(">>> BLE FILE:   Found: %s (%u bytes)\n", debugFile.name(), debugFile.size());
-                            debugFile = debugDir.openNextFile();
-                        }
-                        debugDir.close();
-                    }
-                }
-
                 // Update file list so iOS can see the new file
                 _parent->updateFileList();
             } else {
                 _parent->_fileTransferState = FILE_ERROR;
-                _parent->updateFileStatus("ERROR:Size mismatch");
-                Serial.println(">>> BLE FILE: ERROR - Size mismatch!");
-                
+                uploadErrors.add();
+                if (_parent->_receivedBytes != _parent->_receivingFileSize) {
+                    _parent->updateFileStatus("ERROR:Size mismatch");
+                    Serial.println(">>> BLE FILE: ERROR - Size mismatch!");
+                } else {
+                    _parent->updateFileStatus("ERROR:Catalog update failed");
+                    Serial.println(">>> BLE FILE: ERROR - Could not catalog file");
+                }
+
                 // Delete incomplete file
-                String deletePathOpen = "/alarms/" + _parent->_receivingFilename;
-                SPIFFS.remove(deletePathOpen.c_str());
+                fileManager.abortUpload();
             }
 
             // Reset state
-            _parent->_receivingFilename = "";
+            _parent->_receivingFilename.clear();
             _parent->_receivingFileSize = 0;
             _parent->_receivedBytes = 0;
             _parent->_expectedSequence = 0;
@@ -909,12 +864,12 @@ void BLETimeSync::FileControlCharCallbacks::onWrite(BLECharacteristic* pCharacte
         _parent->cancelFileTransfer();
     } else if (command.startsWith("DELETE:")) {
         // Parse: DELETE:<filename>
-        String filename = command.substring(7);
-        String deletePath = "/alarms/" + filename;
+        SoundName filename(command.substring(7));
 
         Serial.printf(">>> BLE FILE: Delete request for: %s\n", filename.c_str());
 
-        if (SPIFFS.remove(deletePath.c_str())) {
+        if (!filename.truncated() && fileManager.isValidFilename(filename.c_str()) &&
+            fileManager.deleteSound(filename.c_str())) {
             _parent->updateFileStatus("SUCCESS");
             Serial.printf(">>> BLE FILE: Deleted file: %s\n", filename.c_str());
 
@@ -922,24 +877,25 @@ void BLETimeSync::FileControlCharCallbacks::onWrite(BLECharacteristic* pCharacte
             _parent->updateFileList();
         } else {
             _parent->updateFileStatus("ERROR:Delete failed");
-            Serial.printf(">>> BLE FILE: ERROR - Failed to delete file: %s\n", deletePath.c_str());
+            Serial.printf(">>> BLE FILE: ERROR - Failed to delete file: %s\n", filename.c_str());
         }
     } else {
         _parent->updateFileStatus("ERROR:Unknown command");
-        Serial.printf(">>> BLE FILE: ERROR - Unknown command: %s\n", command.c_str());
+        Serial.printf(">>> BLE FILE: ERROR - Unknown command: %s\n", value.c_str());
     }
 }
 
 void BLETimeSync::FileDataCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
     if (_parent->_fileTransferState != FILE_RECEIVING) {
-        Serial.println(">>> BLE FILE: ERROR - Not in receiving state");
+        LOG_E(BLE, "File: Not in receiving state");
         return;
     }
 
     std::string value = pCharacteristic->getValue();
     
     if (value.length() < 2) {
-        Serial.println(">>> BLE FILE: ERROR - Chunk too small");
+        LOG_E(BLE, "File: Chunk too small");
         return;
     }
 
@@ -948,10 +904,7 @@ void BLETimeSync::FileDataCharCallbacks::onWrite(BLECharacteristic* pCharacteris
     
     // Check sequence
     if (sequence != _parent->_expectedSequence) {
-        Serial.print(">>> BLE FILE: ERROR - Sequence mismatch. Expected ");
-        Serial.print(_parent->_expectedSequence);
-        Serial.print(", got ");
-        Serial.println(sequence);
+        LOG_E(BLE, "File: Sequence mismatch. Expected %u, got %u", _parent->_expectedSequence, sequence);
         _parent->updateFileStatus("ERROR:Sequence mismatch");
         _parent->cancelFileTransfer();
         return;
@@ -961,38 +914,61 @@ void BLETimeSync::FileDataCharCallbacks::onWrite(BLECharacteristic* pCharacteris
     size_t dataLen = value.length() - 2;
     const uint8_t* data = (const uint8_t*)value.c_str() + 2;
     
-    if (_parent->_receivingFile) {
-        size_t written = _parent->_receivingFile.write(data, dataLen);
-        if (written != dataLen) {
-            Serial.println(">>> BLE FILE: ERROR - Failed to write data");
-            _parent->updateFileStatus("ERROR:Write failed");
-            _parent->cancelFileTransfer();
-            return;
-        }
-        
-        _parent->_receivedBytes += written;
-        _parent->_expectedSequence++;
-
-        // Flush file every 5 chunks to ensure data is written promptly
-        // With 254-byte chunks, this flushes every ~1.3KB
-        if (sequence % 5 == 0) {
-            _parent->_receivingFile.flush();
-
-            String status = "RECEIVING:" + String(_parent->_receivedBytes) + "/" + String(_parent->_receivingFileSize);
-            _parent->updateFileStatus(status);
-            Serial.print(">>> BLE FILE: Progress: ");
-            Serial.print(_parent->_receivedBytes);
-            Serial.print(" / ");
-            Serial.println(_parent->_receivingFileSize);
-        }
+    if (!fileManager.writeUpload(data, dataLen)) {
+        LOG_E(BLE, "File: Failed to write data");
+        _parent->updateFileStatus("ERROR:Write failed");
+        _parent->cancelFileTransfer();
+        return;
+    }
+
+    _parent->_receivedBytes += dataLen;
+    _parent->_expectedSequence++;
+    rxBytes.add(dataLen);
+    rxChunks.add();
+
+    // Flush file every 5 chunks to ensure data is written promptly
+    // With 254-byte chunks, this flushes every ~1.3KB
+    if (sequence % 5 == 0) {
+        fileManager.flushUpload();
+
+        FixedString<32> status;
+        status.appendf("RECEIVING:%u/%u", (uint32_t)_parent->_receivedBytes, (uint32_t)_parent->_receivingFileSize);
+        _parent->updateFileStatus(status.c_str());
+        LOG_D(BLE, "File: Progress: %u / %u", _parent->_receivedBytes, _parent->_receivingFileSize);
     }
 }
 
+// ============================================
+// Diagnostics Callbacks
+// ============================================
+
+void BLETimeSync::MetricsCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
+    // Page as a single byte or ASCII digits
+    std::string value = pCharacteristic->getValue();
+    if (value.empty()) {
+        return;
+    }
+    if (value.length() == 1 && !isdigit((unsigned char)value[0])) {
+        _parent->_metricsPage = (uint8_t)value[0];
+    } else {
+        _parent->_metricsPage = (uint8_t)atoi(value.c_str());
+    }
+}
+
+void BLETimeSync::MetricsCharCallbacks::onRead(BLECharacteristic* pCharacteristic) {
+    TraceScope trace(TRACE_BLE_CALLBACK, pCharacteristic->getHandle());
+    // Formatted at read time so every read is a fresh snapshot
+    char page[METRICS_PAGE_BYTES + 1];
+    size_t len = Metrics::formatPage(_parent->_metricsPage, page);
+    pCharacteristic->setValue((uint8_t*)page, len);
+}
+
 // ============================================
 // File Transfer Helper Methods
 // ============================================
 
-void BLETimeSync::startFileTransfer(const String& filename, size_t fileSize) {
+void BLETimeSync::startFileTransfer(const char* filename, size_t fileSize, const uint8_t* digest) {
     Serial.print(">>> BLE FILE: Starting transfer - ");
     Serial.print(filename);
     Serial.print(" (");
@@ -1014,7 +990,7 @@ void BLETimeSync::startFileTransfer(const String& filename, size_t fileSize) {
     }
 
     // Check available space
-    if (!fileManager.hasSpaceForFile(fileSize)) {
+    if (!fileManager.hasSpaceForFile(fileSize, digest)) {
         updateFileStatus("ERROR:Not enough space");
         Serial.println(">>> BLE FILE: ERROR - Not enough space");
         return;
@@ -1025,54 +1001,11 @@ void BLETimeSync::startFileTransfer(const String& filename, size_t fileSize) {
         cancelFileTransfer();
     }
 
-    // Open file for writing (use path without /spiffs prefix for SPIFFS.open)
-    String relativePath = "/alarms/" + filename;
-
-    // Debug: Print the actual path being used
-    Serial.print(">>> BLE FILE: Opening file path: ");
-    Serial.println(relativePath);
-    Serial.printf(">>> BLE FILE: SPIFFS Free: %d / Total: %d bytes\n",
-                  SPIFFS.totalBytes() - SPIFFS.usedBytes(), SPIFFS.totalBytes());
-
-    // Ensure directory exists
-    Serial.println(">>> BLE FILE: Checking /alarms directory...");
-    if (!SPIFFS.exists("/alarms/.placeholder")) {
-        Serial.println(">>> BLE FILE: Creating /alarms directory structure...");
-        File placeholder = SPIFFS.open("/alarms/.placeholder", "w");
-        if (placeholder) {
-            placeholder.print("This file ensures the directory exists in SPIFFS");
-            placeholder.close();
-            Serial.printf(">>> BLE FILE: Directory structure created successfully at %s\n", ALARM_SOUNDS_DIR);
-        } else {
-            Serial.printf(">>> BLE FILE: ERROR - Could not create directory structure at %s\n", ALARM_SOUNDS_DIR);
-            updateFileStatus("ERROR:Cannot create directory");
-            return;
-        }
-    } else {
-        Serial.println(">>> BLE FILE: Directory structure already exists");
-    }
-    
-    _receivingFile = SPIFFS.open(relativePath.c_str(), "w");
-    
-    if (!_receivingFile) {
+    if (!fileManager.beginUpload(filename, fileSize, digest)) {
         updateFileStatus("ERROR:Cannot create file");
-        Serial.printf(">>> BLE FILE: ERROR - Cannot create file at: %s\n", relativePath.c_str());
-        
-        // Try to diagnose the issue
-        Serial.println(">>> BLE FILE: Attempting diagnostics...");
-        File testFile = SPIFFS.open("/test.txt", "w");
-        if (testFile) {
-            testFile.print("test");
-            testFile.close();
-            Serial.println(">>> BLE FILE: Can write to root directory - issue is with /alarms path");
-            SPIFFS.remove("/test.txt");
-        } else {
-            Serial.println(">>> BLE FILE: Cannot write to SPIFFS at all - filesystem may be read-only or full");
-        }
+        Serial.printf(">>> BLE FILE: ERROR - Cannot create file: %s\n", filename);
         return;
     }
-    
-    Serial.println(">>> BLE FILE: File opened successfully!");
 
     // Initialize transfer state
     _fileTransferState = FILE_RECEIVING;
@@ -1080,6 +1013,7 @@ void BLETimeSync::startFileTransfer(const String& filename, size_t fileSize) {
     _receivingFileSize = fileSize;
     _receivedBytes = 0;
     _expectedSequence = 0;
+    _transferStartMs = millis();
 
     updateFileStatus("READY");
     Serial.println(">>> BLE FILE: Ready to receive data");
@@ -1087,19 +1021,15 @@ void BLETimeSync::startFileTransfer(const String& filename, size_t fileSize) {
 
 void BLETimeSync::cancelFileTransfer() {
     Serial.println(">>> BLE FILE: Canceling transfer");
-
-    if (_receivingFile) {
-        _receivingFile.close();
+    if (_fileTransferState == FILE_RECEIVING) {
+        uploadErrors.add();
     }
 
     // Delete partial file
-    if (_receivingFilename.length() > 0) {
-        String relativePath = "/alarms/" + _receivingFilename;
-        SPIFFS.remove(relativePath.c_str());
-    }
+    fileManager.abortUpload();
 
     _fileTransferState = FILE_IDLE;
-    _receivingFilename = "";
+    _receivingFilename.clear();
     _receivingFileSize = 0;
     _receivedBytes = 0;
     _expectedSequence = 0;
@@ -1107,9 +1037,9 @@ void BLETimeSync::cancelFileTransfer() {
     updateFileStatus("READY");
 }
 
-void BLETimeSync::updateFileStatus(const String& status) {
+void BLETimeSync::updateFileStatus(const char* status) {
     if (_pFileStatusCharacteristic) {
-        _pFileStatusCharacteristic->setValue(status.c_str());
+        _pFileStatusCharacteristic->setValue(status);
         _pFileStatusCharacteristic->notify();
     }
 }
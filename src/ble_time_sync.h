@@ -7,6 +7,8 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include <FS.h>
+#include "fixed_string.h"
+#include "sound_catalog.h"
 
 // Forward declare AlarmManager to check alarm state in test sound handler
 class AlarmManager;
@@ -26,6 +28,12 @@ public:
      */
     typedef void (*TimeSyncCallback)(time_t timestamp);
 
+    /**
+     * Callback function type for time zone changes
+     * @param tz POSIX TZ string as received (not yet validated)
+     */
+    typedef void (*TimeZoneCallback)(const char* tz);
+
     BLETimeSync();
 
     /**
@@ -52,6 +60,18 @@ public:
      */
     void setTimeSyncCallback(TimeSyncCallback callback);
 
+    /**
+     * Set callback for time zone writes
+     * @param callback Function to call when a TZ string is received
+     */
+    void setTimeZoneCallback(TimeZoneCallback callback);
+
+    /**
+     * Update the time zone characteristic (call after the zone changes)
+     * @param tz POSIX TZ string in effect
+     */
+    void setTimeZoneValue(const char* tz);
+
     /**
      * Get number of successful connections since boot
      * @return Connection count
@@ -82,9 +102,9 @@ public:
 
     /**
      * Get the pending test sound filename and clear the flag
-     * @return filename of sound to test (empty string if none)
+     * @param out Receives the filename of the sound to test (empty if none)
      */
-    String getPendingTestSound();
+    void getPendingTestSound(StringBuilder& out);
 
 private:
     // Friend declarations for callback classes that need access to private members
@@ -95,8 +115,10 @@ private:
     BLEService* _pButtonService;
     BLEService* _pAlarmService;
     BLEService* _pFileService;
+    BLEService* _pDiagnosticsService;
     BLECharacteristic* _pTimeCharacteristic;
     BLECharacteristic* _pDateTimeCharacteristic;
+    BLECharacteristic* _pTimeZoneCharacteristic;
     BLECharacteristic* _pVolumeCharacteristic;
     BLECharacteristic* _pTestSoundCharacteristic;
     BLECharacteristic* _pDisplayMessageCharacteristic;
@@ -110,9 +132,11 @@ private:
     BLECharacteristic* _pFileDataCharacteristic;
     BLECharacteristic* _pFileStatusCharacteristic;
     BLECharacteristic* _pFileListCharacteristic;
+    BLECharacteristic* _pMetricsCharacteristic;
     bool _deviceConnected;
     uint32_t _connectionCount;
     TimeSyncCallback _timeSyncCallback;
+    TimeZoneCallback _timeZoneCallback;
     
     // File transfer state
     enum FileTransferState {
@@ -124,20 +148,24 @@ private:
     };
     
     FileTransferState _fileTransferState;
-    String _receivingFilename;
+    SoundName _receivingFilename;
     size_t _receivingFileSize;
     size_t _receivedBytes;
     uint16_t _expectedSequence;
-    File _receivingFile;
+    uint32_t _transferStartMs;
+
+    // Metrics page returned by the next diagnostics read
+    uint8_t _metricsPage;
 
     // Test sound request state (queued to prevent BLE stack overflow)
     bool _testSoundRequested;
-    String _pendingTestSoundFile;
+    SoundName _pendingTestSoundFile;
 
     // BLE UUIDs
     static const char* SERVICE_UUID;
     static const char* TIME_CHAR_UUID;
     static const char* DATETIME_CHAR_UUID;
+    static const char* TIMEZONE_CHAR_UUID;
     static const char* SETTINGS_SERVICE_UUID;
     static const char* VOLUME_CHAR_UUID;
     static const char* TEST_SOUND_CHAR_UUID;
@@ -155,6 +183,8 @@ private:
     static const char* FILE_DATA_CHAR_UUID;
     static const char* FILE_STATUS_CHAR_UUID;
     static const char* FILE_LIST_CHAR_UUID;
+    static const char* DIAGNOSTICS_SERVICE_UUID;
+    static const char* METRICS_CHAR_UUID;
 
     // Server callbacks
     class ServerCallbacks : public BLEServerCallbacks {
@@ -184,6 +214,15 @@ private:
         BLETimeSync* _parent;
     };
 
+    // Time zone characteristic callbacks
+    class TimeZoneCharCallbacks : public BLECharacteristicCallbacks {
+    public:
+        TimeZoneCharCallbacks(BLETimeSync* parent) : _parent(parent) {}
+        void onWrite(BLECharacteristic* pCharacteristic);
+    private:
+        BLETimeSync* _parent;
+    };
+
     // Alarm Set characteristic callbacks
     class AlarmSetCharCallbacks : public BLECharacteristicCallbacks {
     public:
@@ -274,10 +313,20 @@ private:
         BLETimeSync* _parent;
     };
     
+    // Metrics characteristic callbacks
+    class MetricsCharCallbacks : public BLECharacteristicCallbacks {
+    public:
+        MetricsCharCallbacks(BLETimeSync* parent) : _parent(parent) {}
+        void onWrite(BLECharacteristic* pCharacteristic);
+        void onRead(BLECharacteristic* pCharacteristic);
+    private:
+        BLETimeSync* _parent;
+    };
+
     // Helper methods for file transfer
-    void startFileTransfer(const String& filename, size_t fileSize);
+    void startFileTransfer(const char* filename, size_t fileSize, const uint8_t* digest = nullptr);
     void cancelFileTransfer();
-    void updateFileStatus(const String& status);
+    void updateFileStatus(const char* status);
 };
 
 #endif // BLE_TIME_SYNC_H
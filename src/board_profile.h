@@ -0,0 +1,109 @@
+#ifndef BOARD_PROFILE_H
+#define BOARD_PROFILE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================
+// Board Profiles
+// ============================================
+// A board is a type with compile-time constants: its pins and the
+// drivers it needs. Code uses the active profile (Board, chosen with
+// BOARD_PROFILE in config.h), so switching boards or panels re-compiles
+// specialised code instead of branching at runtime. Every profile's pins
+// are checked by static_assert below.
+
+class GxEPD2_370_GDEY037T03;  // GxEPD2 panel drivers (display_manager.h includes GxEPD2)
+
+static const int8_t PIN_NONE = -1;  // Not connected
+
+/**
+ * BoardPins - GPIO assignment of one board
+ */
+struct BoardPins {
+    int8_t button;      // Input, active LOW (INPUT_PULLUP)
+    int8_t frontlight;  // PWM output
+    int8_t i2sBclk;     // I2S bit clock
+    int8_t i2sLrc;      // I2S left/right clock
+    int8_t i2sDout;     // I2S data out
+    int8_t epdCs;       // E-ink chip select
+    int8_t epdDc;       // E-ink data/command
+    int8_t epdRst;      // E-ink reset
+    int8_t epdBusy;     // E-ink busy (input)
+    int8_t spiSck;      // Hardware SPI clock (used by the e-ink panel)
+    int8_t spiMosi;     // Hardware SPI data out
+};
+
+/**
+ * ESP32-L with DESPI-CO2 e-ink adapter, GDEY037T03 panel, DESPI-F01
+ * frontlight and an external I2S DAC amplifier.
+ * The comments give the pin labels printed on the ESP32-L board.
+ */
+struct Esp32LBoard {
+    static constexpr const char* NAME = "ESP32-L";
+    static constexpr BoardPins PINS = {
+        4,   // Button: T0 (green arcade button with microswitch)
+        32,  // Frontlight: A4 (2N7000 MOSFET + 130 ohm resistor)
+        25,  // I2S BCLK: A18
+        26,  // I2S LRC: A19
+        22,  // I2S DOUT: SCL
+        27,  // EPD CS: T7
+        14,  // EPD DC: T6
+        12,  // EPD RST: T5
+        13,  // EPD BUSY: T4
+        18,  // SPI SCK
+        23,  // SPI MOSI
+    };
+    typedef GxEPD2_370_GDEY037T03 Panel;  // 3.7" with frontlight, UC8253 controller
+    static constexpr bool INTERNAL_DAC = false;  // Audio through an external I2S DAC
+};
+
+// ============================================
+// Pin Validation
+// ============================================
+
+namespace BoardCheck {
+
+constexpr bool isFlashPin(int8_t pin) {
+    return pin >= 6 && pin <= 11;  // Wired to the SPI flash on ESP32 modules
+}
+
+constexpr bool isInputOnly(int8_t pin) {
+    return pin >= 34 && pin <= 39;  // No output driver
+}
+
+constexpr bool isUsable(int8_t pin, bool output) {
+    return pin == PIN_NONE ||
+           (pin >= 0 && pin <= 39 && !isFlashPin(pin) && !(output && isInputOnly(pin)));
+}
+
+/**
+ * @return true if every connected pin exists, avoids the flash pins,
+ *         can drive its outputs and is assigned only once
+ */
+constexpr bool pinsValid(const BoardPins& pins) {
+    const int8_t all[] = {pins.button, pins.frontlight, pins.i2sBclk, pins.i2sLrc, pins.i2sDout,
+                          pins.epdCs, pins.epdDc, pins.epdRst, pins.epdBusy, pins.spiSck, pins.spiMosi};
+    const bool output[] = {false, true, true, true, true, true, true, true, false, true, true};
+    const int count = sizeof(all) / sizeof(all[0]);
+    for (int i = 0; i < count; i++) {
+        if (!isUsable(all[i], output[i])) {
+            return false;
+        }
+        for (int j = i + 1; j < count; j++) {
+            if (all[i] != PIN_NONE && all[i] == all[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace BoardCheck
+
+static_assert(BoardCheck::pinsValid(Esp32LBoard::PINS), "Esp32LBoard: pin conflict or unusable pin");
+
+// The board this firmware is built for
+typedef BOARD_PROFILE Board;
+
+#endif // BOARD_PROFILE_H
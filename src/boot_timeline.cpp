@@ -0,0 +1,37 @@
+#include "boot_timeline.h"
+#include "mono_clock.h"
+
+BootTimeline::Entry BootTimeline::_entries[BOOT_TIMELINE_MAX];
+uint8_t BootTimeline::_count = 0;
+portMUX_TYPE BootTimeline::_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void BootTimeline::mark(const char* event) {
+    int64_t now = MonoClock::nowUs();
+    const char* task = pcTaskGetName(NULL);
+
+    portENTER_CRITICAL(&_lock);
+    if (_count < BOOT_TIMELINE_MAX) {
+        Entry& entry = _entries[_count++];
+        entry.event = event;
+        strncpy(entry.task, task, sizeof(entry.task) - 1);
+        entry.task[sizeof(entry.task) - 1] = '\0';
+        entry.us = now;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+int64_t BootTimeline::timeOf(const char* event) {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (strcmp(_entries[i].event, event) == 0) {
+            return _entries[i].us;
+        }
+    }
+    return -1;
+}
+
+void BootTimeline::print() {
+    Serial.println("BootTimeline:");
+    for (uint8_t i = 0; i < _count; i++) {
+        Serial.printf("  %9lld us  %-16s [%s]\n", (long long)_entries[i].us, _entries[i].event, _entries[i].task);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * BootTimeline - Microsecond timestamps of boot milestones
+ *
+ * Boot stages run in several tasks at once, so each mark records the
+ * task it came from. Times are esp_timer microseconds, which start
+ * counting shortly after reset.
+ */
+class BootTimeline {
+public:
+    /**
+     * Record a milestone (safe from any task; ignored once the table is full)
+     * @param event Static string, e.g. "first_frame"
+     */
+    static void mark(const char* event);
+
+    /**
+     * Time of a recorded milestone
+     * @return Microseconds since boot, or -1 if not recorded
+     */
+    static int64_t timeOf(const char* event);
+
+    /**
+     * Print the timeline to Serial
+     */
+    static void print();
+
+private:
+    struct Entry {
+        const char* event;
+        char task[configMAX_TASK_NAME_LEN];  // Copied: boot tasks delete themselves
+        int64_t us;
+    };
+
+    static Entry _entries[BOOT_TIMELINE_MAX];
+    static uint8_t _count;
+    static portMUX_TYPE _lock;
+};
+
+#endif // BOOT_TIMELINE_H
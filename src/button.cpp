@@ -1,4 +1,7 @@
 #include "button.h"
+#include "mono_clock.h"
+#include "log.h"
+#include "trace.h"
 
 /**
  * Constructor
@@ -16,6 +19,7 @@ Button::Button(uint8_t pin, unsigned long debounceMs)
       _lastPressTime(0),
       _pressDuration(0),
       _lastClickTime(0),
+      _doubleClickMs(BUTTON_DOUBLE_CLICK_MS),
       _clickCount(0),
       _doubleClickFlag(false) {
 }
@@ -40,7 +44,7 @@ void Button::begin() {
  */
 void Button::update() {
     bool rawState = readRaw();
-    unsigned long currentTime = millis();
+    unsigned long currentTime = MonoClock::nowMs();
 
     // If the raw state has changed, reset the debounce timer
     if (rawState != _lastRawState) {
@@ -60,6 +64,7 @@ void Button::update() {
                 _pressedFlag = true;
                 _pressStartTime = currentTime;
                 _lastPressTime = currentTime;
+                Trace::instant(TRACE_BUTTON, _pin);
 
 #ifdef DEBUG_BUTTON
                 Serial.println("[Button] Pressed (rising edge detected)");
@@ -69,19 +74,18 @@ void Button::update() {
                 _releasedFlag = true;
                 _pressDuration = currentTime - _pressStartTime;
 
-                // Track clicks for double-click detection (700ms window)
-                if (currentTime - _lastClickTime < 700) {
+                // Track clicks for double-click detection
+                if (currentTime - _lastClickTime < _doubleClickMs) {
                     _clickCount++;
-                    Serial.print("[Button] Click count: ");
-                    Serial.println(_clickCount);
+                    LOG_D(BUTTON, "Click count: %d", _clickCount);
                     if (_clickCount >= 2) {
                         _doubleClickFlag = true;
                         _clickCount = 0;
-                        Serial.println("[Button] DOUBLE-CLICK DETECTED!");
+                        LOG_D(BUTTON, "Double-click detected");
                     }
                 } else {
                     _clickCount = 1;
-                    Serial.println("[Button] First click");
+                    LOG_D(BUTTON, "First click");
                 }
                 _lastClickTime = currentTime;
 
@@ -134,7 +138,7 @@ bool Button::wasReleased() {
 unsigned long Button::getPressDuration() const {
     if (_currentState) {
         // Button is currently pressed, return current duration
-        return millis() - _pressStartTime;
+        return MonoClock::nowMs() - _pressStartTime;
     } else {
         // Button is released, return last press duration
         return _pressDuration;
@@ -151,22 +155,36 @@ unsigned long Button::getLastPressTime() const {
 /**
  * Check if button was double-clicked
  */
-bool Button::wasDoubleClicked(unsigned long timeoutMs) {
+bool Button::wasDoubleClicked() {
     // Reset click count if too much time has passed
-    unsigned long currentTime = millis();
-    if (currentTime - _lastClickTime > timeoutMs) {
+    unsigned long currentTime = MonoClock::nowMs();
+    if (currentTime - _lastClickTime > _doubleClickMs) {
         _clickCount = 0;
     }
 
     // Check and clear double-click flag
     if (_doubleClickFlag) {
         _doubleClickFlag = false;
-        Serial.println("[Button] wasDoubleClicked() returning TRUE");
+        LOG_D(BUTTON, "wasDoubleClicked() returning true");
         return true;
     }
     return false;
 }
 
+/**
+ * Set the double-click window
+ */
+void Button::setDoubleClickWindow(unsigned long windowMs) {
+    _doubleClickMs = windowMs;
+}
+
+/**
+ * Get the double-click window
+ */
+unsigned long Button::getDoubleClickWindow() const {
+    return _doubleClickMs;
+}
+
 /**
  * Reset button state
  */
@@ -2,6 +2,7 @@
 #define BUTTON_H
 
 #include <Arduino.h>
+#include "config.h"
 
 /**
  * Button Class
@@ -12,7 +13,7 @@
  * Features:
  * - Software debouncing to prevent false triggers
  * - Edge detection for reliable press/release events
- * - Non-blocking operation using millis()
+ * - Non-blocking operation using MonoClock
  * - Support for press duration measurement
  */
 class Button {
@@ -64,17 +65,28 @@ public:
 
     /**
      * Get timestamp of when button was last pressed
-     * @return Timestamp in milliseconds (from millis())
+     * @return Timestamp in milliseconds (from MonoClock::nowMs())
      */
     unsigned long getLastPressTime() const;
 
     /**
      * Check if button was double-clicked
      * Returns true only once per double-click
-     * @param timeoutMs Maximum time between clicks (default: 500ms)
      * @return true if double-click detected
      */
-    bool wasDoubleClicked(unsigned long timeoutMs = 700);
+    bool wasDoubleClicked();
+
+    /**
+     * Set the double-click window
+     * @param windowMs Maximum time between clicks (default: BUTTON_DOUBLE_CLICK_MS)
+     */
+    void setDoubleClickWindow(unsigned long windowMs);
+
+    /**
+     * Get the double-click window
+     * @return Window in milliseconds
+     */
+    unsigned long getDoubleClickWindow() const;
 
     /**
      * Reset button state
@@ -103,6 +115,7 @@ private:
 
     // Double-click detection
     unsigned long _lastClickTime;    // Timestamp of last click
+    unsigned long _doubleClickMs;    // Max time between clicks
     uint8_t _clickCount;             // Number of clicks in sequence
     bool _doubleClickFlag;           // Flag for wasDoubleClicked()
 
@@ -10,46 +10,44 @@
 #define PROJECT_VERSION "0.1.0"
 
 // ============================================
-// Hardware Pin Assignments
+// Board Selection
 // ============================================
-// Note: ESP32-L board uses special pin labels (T pins = Touch pins)
-// The comments show the physical label on the ESP32-L board
-
-// Button Configuration
-#define BUTTON_PIN          4     // GPIO 4 (Labeled "T0" on ESP32-L)
-                                  // Green arcade button with microswitch
-                                  // Active LOW (connects to GND when pressed)
-
-// I2S Audio Pins
-#define I2S_DOUT            22    // GPIO 22 (SCL on ESP32-L board)
-#define I2S_BCLK            25    // GPIO 25 (A18 on ESP32-L board)
-#define I2S_LRC             26    // GPIO 26 (A19 on ESP32-L board)
-
-// E-Ink Display (DESPI-CO2 via SPI)
-// Display: GDEY037T03 (3.7" with frontlight, UC8253 controller)
-// ✓ Pins verified from ESP32-L schematic - NO CONFLICTS
-#define EPD_CS              27    // Chip Select (T7 on ESP32-L)
-#define EPD_DC              14    // Data/Command (T6 on ESP32-L)
-#define EPD_RST             12    // Reset (T5 on ESP32-L)
-#define EPD_BUSY            13    // Busy status (T4 on ESP32-L)
-// SPI: MOSI=23, SCK=18 (hardware SPI)
-
-// Frontlight (DESPI-F01)
-#define FRONTLIGHT_PIN      32    // GPIO 32 (Labeled "A4" on ESP32-L)
-                                  // PWM control for brightness (0-255)
-                                  // Connected via 2N7000 MOSFET + 130Ω resistor
+// Pins, display panel and DAC of each board are in board_profile.h
+// (pin conflicts are compile errors there)
+#define BOARD_PROFILE       Esp32LBoard
 
 // ============================================
 // Button Configuration
 // ============================================
 #define BUTTON_DEBOUNCE_MS  50    // Debounce time in milliseconds
 #define BUTTON_LONG_PRESS_MS 2000 // Long press threshold (future use)
+#define BUTTON_DOUBLE_CLICK_MS 700  // Max gap between clicks of a double-click (also delays snooze)
+
+// ============================================
+// Timer Configuration
+// ============================================
+#define TIMER_WHEEL_TICK_MS     10  // Timer resolution (loop() runs about this often)
+#define TIMER_WHEEL_SLOTS       32  // Wheel buckets (one revolution = 320 ms)
+#define TIMER_WHEEL_MAX_TIMERS  8   // Concurrent timers
+
+// ============================================
+// Frontlight Configuration
+// ============================================
+#define FRONTLIGHT_FADE_MS      800   // Hardware fade for alarm boost and restores (0 = instant)
+#define SUNRISE_DURATION_MIN    10    // Ramp the frontlight up this long before an alarm (0 = off)
+#define SUNRISE_TARGET_PERCENT  100   // Brightness reached at the alarm time
+#define SUNRISE_STEP_MS         1000  // Length of each hardware-faded ramp segment
 
 // ============================================
 // Serial Configuration
 // ============================================
 #define SERIAL_BAUD         115200
 
+// ============================================
+// Boot Configuration
+// ============================================
+#define BOOT_TIMELINE_MAX   16    // Boot timeline events kept for the "boot" serial command
+
 // ============================================
 // Audio Configuration
 // ============================================
@@ -62,12 +60,43 @@
 #define DISPLAY_ROTATION    0     // Display rotation (0, 1, 2, 3)
 #define PARTIAL_UPDATE_INTERVAL 60000  // Full refresh interval (ms)
 
+// ============================================
+// Day/Night Profile Configuration
+// ============================================
+#define PROFILES_ENABLED        true
+#define NIGHT_START_MINUTE      (22 * 60)  // 22:00 local time
+#define NIGHT_END_MINUTE        (7 * 60)   // 07:00 local time
+#define NIGHT_BRIGHTNESS        5          // Frontlight cap at night (%)
+#define NIGHT_CLICK_VOLUME_MAX  20         // Button sound volume cap at night (%)
+#define NIGHT_SECONDS_REFRESH   false      // false = redraw the clock once a minute at night
+
+// ============================================
+// Settings Configuration
+// ============================================
+#define SETTINGS_NAMESPACE       "settings"  // NVS namespace of the settings store
+#define SETTINGS_COMMIT_DELAY_MS 3000        // Write settings this long after the last change
+#define CUSTOM_MESSAGE_MAX       100         // Custom display message length (chars)
+#define BOTTOM_LABEL_MAX         50          // Bottom row label length (chars)
+#define ALARM_LABEL_MAX          32          // Alarm label length (chars); longer labels are cut
+
+// ============================================
+// Timekeeping Configuration
+// ============================================
+#define TIME_CHECKPOINT_INTERVAL_S 3600   // NVS checkpoint of wall-clock time (power-loss fallback)
+#define TIME_DEFAULT_EPOCH  1767225600    // 2026-01-01 00:00:00, used when no time is known
+#define TIME_DEFAULT_TZ     "UTC0"        // POSIX TZ until one is set over BLE
+#define TZ_SPEC_MAX         48            // POSIX TZ string buffer incl. terminator
+#define TZ_TRANSITION_YEARS 4             // Years of DST transitions kept precomputed
+
 // ============================================
 // Alarm Configuration
 // ============================================
 #define MAX_ALARMS          10    // Maximum number of alarms
 #define SNOOZE_DURATION_MS  300000 // Snooze duration (5 minutes)
 #define ALARM_TIMEOUT_MS    600000 // Auto-stop after 10 minutes
+#define ALARM_TONE_BURST_MS 60       // Restart interval of built-in alarm tone bursts
+#define ALARM_CATCHUP_MAX_MIN 60     // Skipped minutes (DST start, stalls) still checked for alarms
+#define ALARM_REFIRE_GUARD_S 7200    // Same alarm at the same local minute won't ring twice (DST end)
 
 // ============================================
 // BLE Configuration
@@ -80,7 +109,77 @@
 // ============================================
 #define SPIFFS_MOUNT_POINT  "/spiffs"
 #define ALARM_SOUNDS_DIR    "/spiffs/alarms"
+#define ALARM_SOUNDS_SPIFFS_DIR "/alarms"     // Same directory, as passed to SPIFFS.open()
 #define MAX_SOUND_FILE_SIZE 512000  // Max 500 KB per sound file
+#define MAX_SOUND_FILES     32      // Capacity of the sound catalog
+#define SOUND_NAME_BUFFER_LEN 32    // Filename buffer incl. terminator (SPIFFS limits names to 23 chars)
+#define SOUND_CATALOG_PATH  "/catalog.bin"  // Sound catalog (outside /alarms so it is never listed)
+#define STORAGE_PATH_MAX    32      // SPIFFS object name limit incl. terminator
+#define SOUND_BANK_PATH     "/sounds.bnk"   // Packed sound bank (header + index + payloads)
+#define SOUND_BANK_JOURNAL_PATH "/sounds.jnl" // Payload move in progress during compaction
+#define SOUND_BANK_ALIGN    4096            // Payload alignment within the bank (flash sector)
+#define SOUND_QUARANTINE_DIR "/bad"     // Corrupted sounds are moved here, not deleted
+#define STORAGE_FORMAT_ON_FAIL false    // Format SPIFFS if mount fails (erases all sounds!)
+#define STORAGE_BOOT_CHECK_CRC false    // Boot check: true = full CRC of every sound, false = size only
+
+// ============================================
+// Storage Maintenance Configuration
+// ============================================
+#define STORAGE_MAINT_INTERVAL_MS   30000  // How often the maintenance task looks for idle time
+#define STORAGE_MAINT_ALARM_GUARD_MIN 15   // No GC/compaction when an alarm is due within this many minutes
+#define STORAGE_GC_TARGET_BYTES     131072 // Free space to keep erased ahead of uploads (128 KB)
+#define STORAGE_LOCK_TIMEOUT_MS     1000   // Max wait for a running maintenance pass
+
+// ============================================
+// Logging Configuration
+// ============================================
+// Levels: LOG_LEVEL_NONE, _ERROR, _WARN, _INFO, _DEBUG (see log.h).
+// Calls above a module's level compile to nothing. Release builds
+// (-DLOG_RELEASE, env:esp32dev-release) cap every module at INFO.
+#define LOG_MAIN_LEVEL      LOG_LEVEL_INFO
+#define LOG_AUDIO_LEVEL     LOG_LEVEL_INFO
+#define LOG_BLE_LEVEL       LOG_LEVEL_INFO
+#define LOG_BUTTON_LEVEL    LOG_LEVEL_INFO
+#define LOG_STORAGE_LEVEL   LOG_LEVEL_INFO
+#define LOG_DISPLAY_LEVEL   LOG_LEVEL_INFO
+#define LOG_ALARM_LEVEL     LOG_LEVEL_INFO
+#define LOG_RING_RECORDS    64    // Buffered log records (64 bytes each)
+#define LOG_DRAIN_INTERVAL_MS 20  // Drain task wake-up interval
+
+// ============================================
+// Metrics Configuration
+// ============================================
+#define METRICS_MAX             32   // Registered counters, gauges and histograms
+#define METRICS_HISTOGRAM_BUCKETS 8  // Max buckets per histogram (including overflow)
+#define METRICS_PAGE_BYTES      180  // BLE diagnostics page size (fits one ATT read at MTU 185)
+
+// ============================================
+// Trace Configuration
+// ============================================
+#define TRACE_EVENTS            1024 // Most recent trace events kept (8 bytes each)
+#define TRACE_MAX_TASKS         12   // Distinct tasks named in a trace
+
+// ============================================
+// Task Stack Configuration
+// ============================================
+// Stack sizes in bytes; "tasks" prints measured peaks and suggested sizes
+#define AUDIO_TASK_STACK        8192 // MP3/WAV decoding
+#define STORAGE_TASK_STACK      6144 // SPIFFS mount, sound preloading, maintenance
+#define BLE_BOOT_TASK_STACK     6144 // BLE stack bring-up (exits when done)
+#define LOG_TASK_STACK          3072 // Log drain
+#define TASK_MONITOR_MAX_TASKS  8    // Watched tasks
+#define TASK_MONITOR_INTERVAL_MS 10000 // Watermark sampling period
+#define TASK_STACK_WARN_BYTES   512  // Free stack below this is flagged as a near-overflow
+#define TASK_STACK_MARGIN_PCT   25   // Headroom added to the measured peak in suggestions
+#define HEAP_LARGEST_WARN_BYTES 16384 // Largest free heap block below this is flagged
+
+// ============================================
+// Loop Monitor Configuration
+// ============================================
+#define LOOP_STAGE_BUDGET_MS    100  // A loop() stage taking longer is logged as a stall
+#define LOOP_DISPLAY_BUDGET_MS  2500 // Budget of stages that refresh the e-ink panel
+#define LOOP_STALL_LOG_INTERVAL_MS 10000 // At most one stall warning per stage this often
+#define SERIAL_COMMAND_MAX      32   // Serial command line length (chars)
 
 // ============================================
 // Debug Configuration
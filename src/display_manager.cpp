@@ -3,29 +3,37 @@
 #include <Fonts/FreeMonoBold24pt7b.h>
 #include <Fonts/FreeMonoBold12pt7b.h>
 #include <Fonts/FreeMono9pt7b.h>
-#include <Preferences.h>
+#include "settings_store.h"
+#include "metrics.h"
+#include "trace.h"
+
+extern SettingsStore settings;
+
+// Refresh metrics (refresh time covers drawing plus the panel update)
+static const uint32_t REFRESH_BOUNDS_MS[] = { 250, 500, 1000, 2000, 4000 };
+static Counter fullRefreshes("display.full_refreshes");
+static Counter partialRefreshes("display.partial_refreshes");
+static Histogram refreshTime("display.refresh_ms", REFRESH_BOUNDS_MS, 5);
 
 DisplayManager::DisplayManager()
     : _display(nullptr),
       _initialized(false),
       _bleConnected(false),
-      _timeSynced(false),
-      _alarmStatus(""),
-      _customMessage(""),
-      _bottomRowLabel(""),
+      _timeConfidence(TIME_CONFIDENCE_UNKNOWN),
+      _showSeconds(true),
       _lastFullRefresh(0),
       _forceFullRefresh(false),
-      _lastTimeStr(""),
       _scrollPixelOffset(0),
       _lastScrollTime(0) {
+    _lastTimeStr[0] = '\0';
 }
 
 bool DisplayManager::begin() {
     Serial.println("DisplayManager: Initializing e-ink display...");
 
     // Create display object
-    _display = new GxEPD2_BW<GxEPD2_370_GDEY037T03, GxEPD2_370_GDEY037T03::HEIGHT>(
-        GxEPD2_370_GDEY037T03(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)
+    _display = new GxEPD2_BW<Board::Panel, Board::Panel::HEIGHT>(
+        Board::Panel(Board::PINS.epdCs, Board::PINS.epdDc, Board::PINS.epdRst, Board::PINS.epdBusy)
     );
 
     if (!_display) {
@@ -41,28 +49,21 @@ bool DisplayManager::begin() {
 
     Serial.println("DisplayManager: Display initialized successfully!");
 
-    // Do initial full refresh to clear screen
-    _display->setFullWindow();
-    _display->firstPage();
-    do {
-        _display->fillScreen(GxEPD_WHITE);
-    } while (_display->nextPage());
+    // No separate clearing pass: the first clock frame is a full refresh
+    _forceFullRefresh = true;
 
-    // Load custom message and bottom row label from NVS
-    Preferences prefs;
-    prefs.begin("display", true);  // Read-only
-    _customMessage = prefs.getString("customMsg", "");
-    _bottomRowLabel = prefs.getString("bottomLabel", "");
-    prefs.end();
+    // Load custom message and bottom row label from the settings store
+    settings.getCustomMessage(_customMessage);
+    settings.getBottomRowLabel(_bottomRowLabel);
 
     if (_customMessage.length() > 0) {
         Serial.print("DisplayManager: Loaded custom message: ");
-        Serial.println(_customMessage);
+        Serial.println(_customMessage.c_str());
     }
 
     if (_bottomRowLabel.length() > 0) {
         Serial.print("DisplayManager: Loaded bottom row label: ");
-        Serial.println(_bottomRowLabel);
+        Serial.println(_bottomRowLabel.c_str());
     }
 
     _lastFullRefresh = millis();
@@ -71,17 +72,21 @@ bool DisplayManager::begin() {
     return true;
 }
 
-void DisplayManager::showClock(const String& timeStr, const String& dateStr, const String& dayStr, uint8_t second) {
+void DisplayManager::showClock(const char* timeStr, const char* dateStr, const char* dayStr, uint8_t second) {
     if (!_initialized) return;
+    TraceScope trace(TRACE_DISPLAY_REFRESH, _forceFullRefresh ? 1 : 0);
+    uint32_t startMs = millis();
 
     // Check if we need a full refresh (only when forced, e.g., at 3 AM)
     if (_forceFullRefresh) {
-        Serial.println("DisplayManager: Performing full refresh (3 AM daily refresh)...");
+        fullRefreshes.add();
+        Serial.println("DisplayManager: Performing full refresh (first frame or 3 AM daily refresh)...");
         _display->setFullWindow();
         _lastFullRefresh = millis();
         _forceFullRefresh = false;
     } else {
         // Partial update for time changes
+        partialRefreshes.add();
         _display->setPartialWindow(0, 0, _display->width(), _display->height());
     }
 
@@ -119,7 +124,8 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
                 }
                 
                 // Calculate total width including spacing
-                String spacedMessage = _customMessage + "     ";  // 5 spaces between loops
+                FixedString<CUSTOM_MESSAGE_MAX + 5> spacedMessage(_customMessage);
+                spacedMessage += "     ";  // 5 spaces between loops
                 _display->getTextBounds(spacedMessage.c_str(), 0, 0, &x1, &y1, &w, &h);
                 int16_t totalScrollWidth = w;
                 
@@ -128,9 +134,6 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
                     _scrollPixelOffset = 0;
                 }
                 
-                // Create extended message for seamless looping
-                String displayText = _customMessage + "     " + _customMessage + "     ";
-                
                 // Define clipping boundaries (inside the borders)
                 int16_t clipLeft = 20;
                 int16_t clipRight = _display->width() - 20;
@@ -140,9 +143,10 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
                 // Calculate start position - text scrolls from left to right edge
                 int16_t startX = clipLeft - _scrollPixelOffset;
                 
-                // Draw the scrolling text
+                // Draw the spaced message twice for seamless looping
                 _display->setCursor(startX, 45);
-                _display->print(displayText);
+                _display->print(spacedMessage.c_str());
+                _display->print(spacedMessage.c_str());
                 
                 // Mask overflow areas with white rectangles
                 // Left mask - from left edge to clip boundary
@@ -159,12 +163,12 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
                 _display->getTextBounds(_customMessage.c_str(), 0, 0, &x1, &y1, &w, &h);
                 int16_t topX = (_display->width() - w) / 2;
                 _display->setCursor(topX, 45);
-                _display->print(_customMessage);
+                _display->print(_customMessage.c_str());
                 _scrollPixelOffset = 0;
             }
         } else {
             // No custom message - show day of week (centered)
-            _display->getTextBounds(dayStr.c_str(), 0, 0, &x1, &y1, &w, &h);
+            _display->getTextBounds(dayStr, 0, 0, &x1, &y1, &w, &h);
             int16_t topX = (_display->width() - w) / 2;
             _display->setCursor(topX, 45);
             _display->print(dayStr);
@@ -176,43 +180,47 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
 
         // Display large time in center
         _display->setFont(&FreeSansBold24pt7b);
-        _display->getTextBounds(timeStr.c_str(), 0, 0, &x1, &y1, &w, &h);
+        _display->getTextBounds(timeStr, 0, 0, &x1, &y1, &w, &h);
         int16_t timeX = (_display->width() - w) / 2;
         int16_t timeY = (_display->height() / 2) + 20;
         _display->setCursor(timeX, timeY);
         _display->print(timeStr);
 
         // Draw small analog seconds clock to the right of time
-        int16_t clockCenterX = timeX + w + 35;  // Position to the right of time
-        int16_t clockCenterY = timeY - 20;      // Vertically aligned with time
-        int16_t clockRadius = 20;               // Small clock radius
-
-        // Draw clock circle
-        _display->drawCircle(clockCenterX, clockCenterY, clockRadius, GxEPD_BLACK);
-
-        // Calculate hand angle (seconds: 0 = top, clockwise)
-        // Convert seconds (0-59) to angle in radians
-        // 0 seconds = -90 degrees (top), each second = 6 degrees
-        float angle = (second * 6.0 - 90.0) * PI / 180.0;
-
-        // Calculate hand endpoint (hand length = radius - 2)
-        int16_t handLength = clockRadius - 3;
-        int16_t handX = clockCenterX + handLength * cos(angle);
-        int16_t handY = clockCenterY + handLength * sin(angle);
-
-        // Draw the seconds hand
-        _display->drawLine(clockCenterX, clockCenterY, handX, handY, GxEPD_BLACK);
-
-        // Draw center dot
-        _display->fillCircle(clockCenterX, clockCenterY, 2, GxEPD_BLACK);
+        // (omitted when redrawn once a minute - a frozen hand would mislead)
+        if (_showSeconds) {
+            int16_t clockCenterX = timeX + w + 35;  // Position to the right of time
+            int16_t clockCenterY = timeY - 20;      // Vertically aligned with time
+            int16_t clockRadius = 20;               // Small clock radius
+
+            // Draw clock circle
+            _display->drawCircle(clockCenterX, clockCenterY, clockRadius, GxEPD_BLACK);
+
+            // Calculate hand angle (seconds: 0 = top, clockwise)
+            // Convert seconds (0-59) to angle in radians
+            // 0 seconds = -90 degrees (top), each second = 6 degrees
+            float angle = (second * 6.0 - 90.0) * PI / 180.0;
+
+            // Calculate hand endpoint (hand length = radius - 2)
+            int16_t handLength = clockRadius - 3;
+            int16_t handX = clockCenterX + handLength * cos(angle);
+            int16_t handY = clockCenterY + handLength * sin(angle);
+
+            // Draw the seconds hand
+            _display->drawLine(clockCenterX, clockCenterY, handX, handY, GxEPD_BLACK);
+
+            // Draw center dot
+            _display->fillCircle(clockCenterX, clockCenterY, 2, GxEPD_BLACK);
+        }
 
         // Check if bottom row label is set for dynamic layout
         if (_bottomRowLabel.length() > 0) {
             // LAYOUT WITH BOTTOM LABEL:
             // - Draw day and date UNDER the time (smaller font)
             _display->setFont(&FreeMono9pt7b);
-            String dayDateStr = dayStr + ", " + dateStr;
-            _display->getTextBounds(dayDateStr.c_str(), 0, 0, &x1, &y1, &w, &h);
+            char dayDateStr[32];
+            snprintf(dayDateStr, sizeof(dayDateStr), "%s, %s", dayStr, dateStr);
+            _display->getTextBounds(dayDateStr, 0, 0, &x1, &y1, &w, &h);
             int16_t dayDateX = (_display->width() - w) / 2;
             int16_t dayDateY = timeY + 35;  // Below the time
             _display->setCursor(dayDateX, dayDateY);
@@ -223,7 +231,7 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
             _display->getTextBounds(_bottomRowLabel.c_str(), 0, 0, &x1, &y1, &w, &h);
             int16_t bottomX = (_display->width() - w) / 2;
             _display->setCursor(bottomX, _display->height() - 30);
-            _display->print(_bottomRowLabel);
+            _display->print(_bottomRowLabel.c_str());
 
             // Draw horizontal line above bottom label
             _display->drawLine(20, _display->height() - 50, _display->width() - 20, _display->height() - 50, GxEPD_BLACK);
@@ -231,8 +239,13 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
             // DEFAULT LAYOUT (no bottom label):
             // - Bottom row shows: Day+Date (if custom message) OR just Date
             _display->setFont(&FreeMonoBold12pt7b);
-            String bottomText = (_customMessage.length() > 0) ? (dayStr + " " + dateStr) : dateStr;
-            _display->getTextBounds(bottomText.c_str(), 0, 0, &x1, &y1, &w, &h);
+            char bottomText[32];
+            if (_customMessage.length() > 0) {
+                snprintf(bottomText, sizeof(bottomText), "%s %s", dayStr, dateStr);
+            } else {
+                snprintf(bottomText, sizeof(bottomText), "%s", dateStr);
+            }
+            _display->getTextBounds(bottomText, 0, 0, &x1, &y1, &w, &h);
             int16_t bottomX = (_display->width() - w) / 2;
             _display->setCursor(bottomX, _display->height() - 30);
             _display->print(bottomText);
@@ -242,16 +255,21 @@ void DisplayManager::showClock(const String& timeStr, const String& dateStr, con
         }
 
     } while (_display->nextPage());
+    refreshTime.record(millis() - startMs);
 
-    _lastTimeStr = timeStr;
+    strncpy(_lastTimeStr, timeStr, sizeof(_lastTimeStr) - 1);
+    _lastTimeStr[sizeof(_lastTimeStr) - 1] = '\0';
 }
 
-void DisplayManager::showAlarmRinging(const String& timeStr, const String& alarmLabel, const String& bottomRowLabel) {
+void DisplayManager::showAlarmRinging(const char* timeStr, const char* alarmLabel, const char* bottomRowLabel) {
     if (!_initialized) return;
 
     Serial.print("DisplayManager: Showing alarm ringing screen for: ");
     Serial.println(alarmLabel);
 
+    TraceScope trace(TRACE_DISPLAY_REFRESH, 1);
+    uint32_t startMs = millis();
+    fullRefreshes.add();
     _display->setFullWindow();
     _display->firstPage();
     do {
@@ -269,7 +287,7 @@ void DisplayManager::showAlarmRinging(const String& timeStr, const String& alarm
         _display->setFont(&FreeMonoBold24pt7b);
         int16_t x1, y1;
         uint16_t w, h;
-        String displayLabel = alarmLabel;
+        FixedString<ALARM_LABEL_MAX> displayLabel(alarmLabel);
 
         // Check if label fits, use smaller font if needed
         _display->getTextBounds(displayLabel.c_str(), 0, 0, &x1, &y1, &w, &h);
@@ -280,7 +298,7 @@ void DisplayManager::showAlarmRinging(const String& timeStr, const String& alarm
             // If still too long, truncate
             if (w > (_display->width() - 40)) {
                 while (displayLabel.length() > 0 && w > (_display->width() - 40)) {
-                    displayLabel = displayLabel.substring(0, displayLabel.length() - 1);
+                    displayLabel.truncate(displayLabel.length() - 1);
                     _display->getTextBounds(displayLabel.c_str(), 0, 0, &x1, &y1, &w, &h);
                 }
             }
@@ -289,21 +307,21 @@ void DisplayManager::showAlarmRinging(const String& timeStr, const String& alarm
         _display->getTextBounds(displayLabel.c_str(), 0, 0, &x1, &y1, &w, &h);
         int16_t alarmX = (_display->width() - w) / 2;
         _display->setCursor(alarmX, 80);
-        _display->print(displayLabel);
+        _display->print(displayLabel.c_str());
 
         // Current time - USE SAME FONT AS NORMAL CLOCK (FreeSansBold24pt7b)
         _display->setFont(&FreeSansBold24pt7b);
-        _display->getTextBounds(timeStr.c_str(), 0, 0, &x1, &y1, &w, &h);
+        _display->getTextBounds(timeStr, 0, 0, &x1, &y1, &w, &h);
         int16_t timeX = (_display->width() - w) / 2;
         int16_t timeY = (_display->height() / 2) + 20;
         _display->setCursor(timeX, timeY);
         _display->print(timeStr);
 
         // Bottom row: Show custom label if set, otherwise show instructions
-        if (bottomRowLabel.length() > 0) {
+        if (bottomRowLabel[0] != '\0') {
             // Show custom bottom row label
             _display->setFont(&FreeMonoBold12pt7b);
-            _display->getTextBounds(bottomRowLabel.c_str(), 0, 0, &x1, &y1, &w, &h);
+            _display->getTextBounds(bottomRowLabel, 0, 0, &x1, &y1, &w, &h);
             int16_t labelX = (_display->width() - w) / 2;
             _display->setCursor(labelX, _display->height() - 30);
             _display->print(bottomRowLabel);
@@ -324,58 +342,49 @@ void DisplayManager::showAlarmRinging(const String& timeStr, const String& alarm
         }
 
     } while (_display->nextPage());
+    refreshTime.record(millis() - startMs);
 }
 
 void DisplayManager::setBLEStatus(bool connected) {
     _bleConnected = connected;
 }
 
-void DisplayManager::setTimeSyncStatus(bool synced) {
-    _timeSynced = synced;
+void DisplayManager::setTimeConfidence(TimeConfidence confidence) {
+    _timeConfidence = confidence;
+}
+
+void DisplayManager::setShowSeconds(bool show) {
+    _showSeconds = show;
 }
 
-void DisplayManager::setAlarmStatus(const String& status) {
+void DisplayManager::setAlarmStatus(const char* status) {
     _alarmStatus = status;
 }
 
-void DisplayManager::setCustomMessage(const String& message) {
-    // Allow longer messages now that we support scrolling (max 100 chars)
-    _customMessage = message.substring(0, 100);
+void DisplayManager::setCustomMessage(const char* message) {
+    // Allow longer messages now that we support scrolling (cut at CUSTOM_MESSAGE_MAX)
+    _customMessage = message;
     
     // Reset scroll position when message changes
     _scrollPixelOffset = 0;
     _lastScrollTime = 0;
 
-    // Save to NVS
-    Preferences prefs;
-    prefs.begin("display", false);
-    prefs.putString("customMsg", _customMessage);
-    prefs.end();
+    // Save (written to NVS once changes settle)
+    settings.setCustomMessage(_customMessage.c_str());
 
     Serial.print("DisplayManager: Custom message set to: ");
-    Serial.println(_customMessage.length() > 0 ? _customMessage : "(empty - using day of week)");
+    Serial.println(_customMessage.length() > 0 ? _customMessage.c_str() : "(empty - using day of week)");
 }
 
-String DisplayManager::getCustomMessage() const {
-    return _customMessage;
-}
-
-void DisplayManager::setBottomRowLabel(const String& label) {
-    // Max 50 chars for bottom row label
-    _bottomRowLabel = label.substring(0, 50);
+void DisplayManager::setBottomRowLabel(const char* label) {
+    // Max BOTTOM_LABEL_MAX chars for bottom row label
+    _bottomRowLabel = label;
 
-    // Save to NVS
-    Preferences prefs;
-    prefs.begin("display", false);
-    prefs.putString("bottomLabel", _bottomRowLabel);
-    prefs.end();
+    // Save (written to NVS once changes settle)
+    settings.setBottomRowLabel(_bottomRowLabel.c_str());
 
     Serial.print("DisplayManager: Bottom row label set to: ");
-    Serial.println(_bottomRowLabel.length() > 0 ? _bottomRowLabel : "(empty)");
-}
-
-String DisplayManager::getBottomRowLabel() const {
-    return _bottomRowLabel;
+    Serial.println(_bottomRowLabel.length() > 0 ? _bottomRowLabel.c_str() : "(empty)");
 }
 
 void DisplayManager::forceFullRefresh() {
@@ -392,10 +401,18 @@ void DisplayManager::drawStatusIcons() {
         _display->print("---");
     }
 
+    // Time confidence marker next to BLE status (blank once synced)
+    _display->setCursor(55, 25);
+    if (_timeConfidence == TIME_CONFIDENCE_ESTIMATED) {
+        _display->print("~");
+    } else if (_timeConfidence == TIME_CONFIDENCE_UNKNOWN) {
+        _display->print("?");
+    }
+
     // Draw alarm status icon (top right) - replaces sync indicator
     _display->setCursor(_display->width() - 80, 25);
     if (_alarmStatus.length() > 0) {
-        _display->print(_alarmStatus);  // "ALARM" or "SNOOZE"
+        _display->print(_alarmStatus.c_str());  // "ALARM" or "SNOOZE"
     } else {
         _display->print("     ");  // Empty space if no alarm
     }
@@ -3,7 +3,10 @@
 
 #include <Arduino.h>
 #include <GxEPD2_BW.h>
+#include "board_profile.h"
 #include "config.h"
+#include "fixed_string.h"
+#include "time_manager.h"
 
 /**
  * DisplayManager - E-ink display abstraction with smart refresh logic
@@ -28,7 +31,7 @@ public:
      * @param dayStr Day of week string (e.g., "Wednesday")
      * @param second Current second (0-59) for analog seconds indicator
      */
-    void showClock(const String& timeStr, const String& dateStr, const String& dayStr, uint8_t second);
+    void showClock(const char* timeStr, const char* dateStr, const char* dayStr, uint8_t second);
 
     /**
      * Show alarm ringing screen
@@ -36,7 +39,7 @@ public:
      * @param alarmLabel Alarm label to display (e.g., "Morning Routine")
      * @param bottomRowLabel Custom bottom row text (or empty to show instructions)
      */
-    void showAlarmRinging(const String& timeStr, const String& alarmLabel, const String& bottomRowLabel);
+    void showAlarmRinging(const char* timeStr, const char* alarmLabel, const char* bottomRowLabel);
 
     /**
      * Set BLE connection status
@@ -45,40 +48,46 @@ public:
     void setBLEStatus(bool connected);
 
     /**
-     * Set time sync status
-     * @param synced true if time has been synced
+     * Set time confidence (shown as a marker next to the BLE status)
+     * @param confidence "~" when ESTIMATED, "?" when UNKNOWN, nothing when SYNCED
      */
-    void setTimeSyncStatus(bool synced);
+    void setTimeConfidence(TimeConfidence confidence);
+
+    /**
+     * Show or hide the analog seconds indicator
+     * @param show false when the clock is only redrawn once a minute (night profile)
+     */
+    void setShowSeconds(bool show);
 
     /**
      * Set alarm status (replaces sync indicator)
      * @param status "ALARM" if alarm set, "SNOOZE" if snoozed, "" if none
      */
-    void setAlarmStatus(const String& status);
+    void setAlarmStatus(const char* status);
 
     /**
      * Set custom message for top row of display
-     * @param message Custom message (max 50 chars, empty string to disable)
+     * @param message Custom message (max CUSTOM_MESSAGE_MAX chars, empty string to disable)
      */
-    void setCustomMessage(const String& message);
+    void setCustomMessage(const char* message);
 
     /**
      * Get current custom message
      * @return Custom message string
      */
-    String getCustomMessage() const;
+    const char* getCustomMessage() const { return _customMessage.c_str(); }
 
     /**
      * Set custom label for bottom row of display
-     * @param label Custom label (max 50 chars, empty string to disable)
+     * @param label Custom label (max BOTTOM_LABEL_MAX chars, empty string to disable)
      */
-    void setBottomRowLabel(const String& label);
+    void setBottomRowLabel(const char* label);
 
     /**
      * Get current bottom row label
      * @return Bottom row label string
      */
-    String getBottomRowLabel() const;
+    const char* getBottomRowLabel() const { return _bottomRowLabel.c_str(); }
 
     /**
      * Force a full refresh on next update
@@ -86,16 +95,17 @@ public:
     void forceFullRefresh();
 
 private:
-    GxEPD2_BW<GxEPD2_370_GDEY037T03, GxEPD2_370_GDEY037T03::HEIGHT>* _display;
+    GxEPD2_BW<Board::Panel, Board::Panel::HEIGHT>* _display;
     bool _initialized;
     bool _bleConnected;
-    bool _timeSynced;
-    String _alarmStatus;  // "ALARM", "SNOOZE", or ""
-    String _customMessage;  // Custom message for top row (empty = use day of week)
-    String _bottomRowLabel;  // Custom label for bottom row (empty = use default layout)
+    TimeConfidence _timeConfidence;
+    bool _showSeconds;
+    FixedString<7> _alarmStatus;  // "ALARM", "SNOOZE", or ""
+    FixedString<CUSTOM_MESSAGE_MAX> _customMessage;  // Custom message for top row (empty = use day of week)
+    FixedString<BOTTOM_LABEL_MAX> _bottomRowLabel;  // Custom label for bottom row (empty = use default layout)
     unsigned long _lastFullRefresh;
     bool _forceFullRefresh;
-    String _lastTimeStr;
+    char _lastTimeStr[12];
     
     // Scrolling state for long messages
     int _scrollPixelOffset;       // Current scroll position (in pixels)
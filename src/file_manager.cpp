@@ -1,9 +1,42 @@
 #include "file_manager.h"
+#include <esp_spiffs.h>
+#include "log.h"
+
+namespace {
+
+/**
+ * @brief Scoped hold of the FileManager mutex
+ */
+class StorageLock {
+public:
+    StorageLock(SemaphoreHandle_t mutex, TickType_t timeout)
+        : _mutex(mutex), _held(mutex != nullptr && xSemaphoreTakeRecursive(mutex, timeout) == pdTRUE) {}
+    ~StorageLock() {
+        if (_held) {
+            xSemaphoreGiveRecursive(_mutex);
+        }
+    }
+    bool held() const { return _held; }
+
+private:
+    SemaphoreHandle_t _mutex;
+    bool _held;
+};
+
+const TickType_t LOCK_TIMEOUT = pdMS_TO_TICKS(STORAGE_LOCK_TIMEOUT_MS);
 
-FileManager::FileManager() : _initialized(false) {
+}  // namespace
+
+FileManager::FileManager()
+    : _initialized(false), _mutex(nullptr), _pinLock(portMUX_INITIALIZER_UNLOCKED), _bankReaders(0),
+      _uploading(false), _uploadCrc(0), _uploadBytes(0), _uploadHasDigest(false), _uploadDedupId(0) {
+    _uploadName[0] = '\0';
+    memset(&_stats, 0, sizeof(_stats));
+    mbedtls_sha256_init(&_uploadSha);
 }
 
 FileManager::~FileManager() {
+    mbedtls_sha256_free(&_uploadSha);
     if (_initialized) {
         SPIFFS.end();
     }
@@ -12,13 +45,25 @@ FileManager::~FileManager() {
 bool FileManager::begin() {
     Serial.println("\n=== FileManager Initialization ===");
 
-    // Mount SPIFFS
-    if (!SPIFFS.begin(true)) {  // true = format if mount fails
-        Serial.println("ERROR: Failed to mount SPIFFS!");
+    if (_mutex == nullptr) {
+        _mutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    // Mount SPIFFS without formatting - a failed mount must not wipe custom sounds
+    uint32_t mountStart = micros();
+    bool mounted = SPIFFS.begin(false);
+    if (!mounted && STORAGE_FORMAT_ON_FAIL) {
+        Serial.println("WARNING: SPIFFS mount failed, formatting (STORAGE_FORMAT_ON_FAIL)");
+        mounted = SPIFFS.begin(true);
+    }
+    uint32_t mountUs = micros() - mountStart;
+
+    if (!mounted) {
+        Serial.println("ERROR: Failed to mount SPIFFS! Partition left untouched, custom sounds unavailable");
         return false;
     }
 
-    Serial.println("SPIFFS mounted successfully");
+    Serial.printf("SPIFFS mounted successfully (%lu us)\n", (unsigned long)mountUs);
 
     // Print SPIFFS info
     size_t total = SPIFFS.totalBytes();
@@ -30,46 +75,67 @@ bool FileManager::begin() {
     Serial.printf("SPIFFS Free:  %d KB\n", free / 1024);
 
     // Create alarm sounds directory if it doesn't exist
-    if (!ensureDirectory(ALARM_SOUNDS_DIR)) {
+    if (!ensureDirectory(StoragePath(ALARM_SOUNDS_DIR))) {
         Serial.println("ERROR: Failed to create alarm sounds directory!");
         return false;
     }
 
     Serial.println("Alarm sounds directory ready");
 
+    // Load sound catalog, falling back to a one-time directory scan
+    _bank.load();
+    if (!_catalog.load()) {
+        _catalog.rebuild();
+        _catalog.save();
+    }
+
+    // Integrity check (read-only unless something is wrong)
+    uint32_t checkStart = micros();
+    SoundCheckResult check;
+    _catalog.checkAll(STORAGE_BOOT_CHECK_CRC, check);
+    checkBank(STORAGE_BOOT_CHECK_CRC, check);
+    uint32_t checkUs = micros() - checkStart;
+
+    Serial.printf("Storage check (%s): %d checked, %d missing, %d quarantined (%lu us)\n",
+                  STORAGE_BOOT_CHECK_CRC ? "crc" : "size",
+                  check.checked, check.missing, check.quarantined, (unsigned long)checkUs);
+
+    _stats.freeBytes = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    _stats.reclaimableBytes = _bank.deadBytes();
+
     _initialized = true;
     Serial.println("=== FileManager Ready ===\n");
 
     return true;
 }
 
-bool FileManager::fileExists(const String& path) {
+bool FileManager::fileExists(const StoragePath& path) {
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return false;
     }
 
-    // Strip /spiffs prefix if present for SPIFFS.exists()
-    String checkPath = path;
-    if (checkPath.startsWith(SPIFFS_MOUNT_POINT)) {
-        checkPath = checkPath.substring(strlen(SPIFFS_MOUNT_POINT));
+    // Sound files are answered from the catalog
+    const char* soundName = soundNameFromPath(path);
+    if (soundName != nullptr) {
+        return _catalog.verify(soundName);
     }
 
-    return SPIFFS.exists(checkPath.c_str());
+    return SPIFFS.exists(path.c_str());
 }
 
-size_t FileManager::getFileSize(const String& path) {
+size_t FileManager::getFileSize(const StoragePath& path) {
     if (!_initialized || !fileExists(path)) {
         return 0;
     }
 
-    // Strip /spiffs prefix if present for SPIFFS.open()
-    String openPath = path;
-    if (openPath.startsWith(SPIFFS_MOUNT_POINT)) {
-        openPath = openPath.substring(strlen(SPIFFS_MOUNT_POINT));
+    const char* soundName = soundNameFromPath(path);
+    if (soundName != nullptr) {
+        const SoundCatalogEntry* entry = _catalog.find(soundName);
+        return entry ? entry->size : 0;
     }
 
-    File file = SPIFFS.open(openPath.c_str(), "r");
+    File file = SPIFFS.open(path.c_str(), "r");
     if (!file) {
         return 0;
     }
@@ -80,7 +146,7 @@ size_t FileManager::getFileSize(const String& path) {
     return size;
 }
 
-bool FileManager::deleteFile(const String& path) {
+bool FileManager::deleteFile(const StoragePath& path) {
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return false;
@@ -91,13 +157,12 @@ bool FileManager::deleteFile(const String& path) {
         return false;
     }
 
-    // Strip /spiffs prefix if present for SPIFFS.remove()
-    String removePath = path;
-    if (removePath.startsWith(SPIFFS_MOUNT_POINT)) {
-        removePath = removePath.substring(strlen(SPIFFS_MOUNT_POINT));
+    const char* soundName = soundNameFromPath(path);
+    if (soundName != nullptr) {
+        return deleteSound(soundName);
     }
 
-    if (SPIFFS.remove(removePath.c_str())) {
+    if (SPIFFS.remove(path.c_str())) {
         Serial.printf("Deleted file: %s\n", path.c_str());
         return true;
     } else {
@@ -106,49 +171,22 @@ bool FileManager::deleteFile(const String& path) {
     }
 }
 
-std::vector<String> FileManager::listSounds() {
-    std::vector<String> sounds;
+std::vector<SoundName> FileManager::listSounds() {
+    std::vector<SoundName> sounds;
 
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return sounds;
     }
 
-    // Use path without /spiffs prefix for SPIFFS.open
-    File root = SPIFFS.open("/alarms");
-    if (!root) {
-        Serial.println("ERROR: Failed to open alarm sounds directory!");
-        return sounds;
-    }
-
-    if (!root.isDirectory()) {
-        Serial.println("ERROR: Alarm sounds path is not a directory!");
-        root.close();
-        return sounds;
-    }
-
-    File file = root.openNextFile();
-    while (file) {
-        if (!file.isDirectory()) {
-            String filename = String(file.name());
-            // Remove directory path, keep only filename
-            int lastSlash = filename.lastIndexOf('/');
-            if (lastSlash >= 0) {
-                filename = filename.substring(lastSlash + 1);
-            }
-
-            // Only include MP3 and WAV files
-            if (filename.endsWith(".mp3") || filename.endsWith(".wav") ||
-                filename.endsWith(".MP3") || filename.endsWith(".WAV")) {
-                sounds.push_back(filename);
-                Serial.printf("Found sound file: %s (%d bytes)\n", filename.c_str(), file.size());
-            }
+    sounds.reserve(_catalog.count());
+    for (size_t i = 0; i < _catalog.count(); i++) {
+        const SoundCatalogEntry& entry = _catalog.at(i);
+        if (entry.codec == SOUND_CODEC_MP3 || entry.codec == SOUND_CODEC_WAV) {
+            sounds.push_back(SoundName(entry.name));
         }
-        file = root.openNextFile();
     }
 
-    root.close();
-
     Serial.printf("Total sound files found: %d\n", sounds.size());
     return sounds;
 }
@@ -169,7 +207,7 @@ size_t FileManager::getTotalSpace() {
     return SPIFFS.totalBytes();
 }
 
-bool FileManager::writeChunk(const String& path, const uint8_t* data, size_t len, bool append) {
+bool FileManager::writeChunk(const StoragePath& path, const uint8_t* data, size_t len, bool append) {
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return false;
@@ -188,14 +226,8 @@ bool FileManager::writeChunk(const String& path, const uint8_t* data, size_t len
         }
     }
 
-    // Strip /spiffs prefix if present for SPIFFS.open()
-    String openPath = path;
-    if (openPath.startsWith(SPIFFS_MOUNT_POINT)) {
-        openPath = openPath.substring(strlen(SPIFFS_MOUNT_POINT));
-    }
-
     const char* mode = append ? "a" : "w";
-    File file = SPIFFS.open(openPath.c_str(), mode);
+    File file = SPIFFS.open(path.c_str(), mode);
     if (!file) {
         Serial.printf("ERROR: Failed to open file for writing: %s\n", path.c_str());
         return false;
@@ -213,7 +245,7 @@ bool FileManager::writeChunk(const String& path, const uint8_t* data, size_t len
     return true;
 }
 
-size_t FileManager::readFile(const String& path, uint8_t* buffer, size_t maxLen) {
+size_t FileManager::readFile(const StoragePath& path, uint8_t* buffer, size_t maxLen) {
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return 0;
@@ -224,13 +256,7 @@ size_t FileManager::readFile(const String& path, uint8_t* buffer, size_t maxLen)
         return 0;
     }
 
-    // Strip /spiffs prefix if present for SPIFFS.open()
-    String openPath = path;
-    if (openPath.startsWith(SPIFFS_MOUNT_POINT)) {
-        openPath = openPath.substring(strlen(SPIFFS_MOUNT_POINT));
-    }
-
-    File file = SPIFFS.open(openPath.c_str(), "r");
+    File file = SPIFFS.open(path.c_str(), "r");
     if (!file) {
         Serial.printf("ERROR: Failed to open file for reading: %s\n", path.c_str());
         return 0;
@@ -246,21 +272,16 @@ size_t FileManager::readFile(const String& path, uint8_t* buffer, size_t maxLen)
     return bytesRead;
 }
 
-bool FileManager::ensureDirectory(const String& path) {
+bool FileManager::ensureDirectory(const StoragePath& path) {
     // SPIFFS doesn't have real directories, just path prefixes
     // Create a placeholder file to establish the directory path
-    
-    Serial.printf("Directory path: %s\n", path.c_str());
-    
-    // Extract the relative path (remove /spiffs prefix if present)
-    String relativePath = path;
-    if (relativePath.startsWith(SPIFFS_MOUNT_POINT)) {
-        relativePath = relativePath.substring(strlen(SPIFFS_MOUNT_POINT));
+    StoragePath placeholderPath = path.join(".placeholder");
+
+    // Already established - don't rewrite flash on every boot
+    if (SPIFFS.exists(placeholderPath.c_str())) {
+        return true;
     }
-    
-    // Create placeholder file to establish directory
-    String placeholderPath = relativePath + "/.placeholder";
-    
+
     Serial.printf("Creating directory structure with placeholder: %s\n", placeholderPath.c_str());
     
     File placeholder = SPIFFS.open(placeholderPath.c_str(), "w");
@@ -284,116 +305,77 @@ std::vector<SoundFileInfo> FileManager::getSoundFileList() {
         return soundFiles;
     }
 
-    Serial.println(">>> FileManager: Listing files in /alarms directory...");
-    // Use path without /spiffs prefix for SPIFFS.open
-    File root = SPIFFS.open("/alarms");
-    if (!root) {
-        Serial.println("ERROR: Failed to open alarm sounds directory!");
-        return soundFiles;
-    }
+    soundFiles.reserve(_catalog.count());
+    for (size_t i = 0; i < _catalog.count(); i++) {
+        const SoundCatalogEntry& entry = _catalog.at(i);
 
-    if (!root.isDirectory()) {
-        Serial.println("ERROR: Alarm sounds path is not a directory!");
-        root.close();
-        return soundFiles;
-    }
-
-    File file = root.openNextFile();
-    while (file) {
-        String fullPath = String(file.name());
-        Serial.printf(">>> FileManager: Examining file: %s (isDir=%d)\n", fullPath.c_str(), file.isDirectory());
-
-        if (!file.isDirectory()) {
-            String filename = fullPath;
-            // Remove directory path, keep only filename
-            int lastSlash = filename.lastIndexOf('/');
-            if (lastSlash >= 0) {
-                filename = filename.substring(lastSlash + 1);
-            }
+        SoundFileInfo info;
+        info.filename = entry.name;
+        info.fileSize = entry.size;
+        info.durationMs = entry.durationMs;
 
-            Serial.printf(">>> FileManager: Extracted filename: %s\n", filename.c_str());
-
-            // Skip placeholder file
-            if (filename == ".placeholder") {
-                Serial.println(">>> FileManager: Skipping placeholder file");
-                file = root.openNextFile();
-                continue;
-            }
-
-            // Only include audio files
-            if (filename.endsWith(".mp3") || filename.endsWith(".wav") ||
-                filename.endsWith(".m4a") ||
-                filename.endsWith(".MP3") || filename.endsWith(".WAV") ||
-                filename.endsWith(".M4A")) {
-
-                SoundFileInfo info;
-                info.filename = filename;
-                info.fileSize = file.size();
-
-                // Generate display name (remove extension, capitalize first letter)
-                info.displayName = filename;
-                int dotPos = info.displayName.lastIndexOf('.');
-                if (dotPos > 0) {
-                    info.displayName = info.displayName.substring(0, dotPos);
-                }
-                // Replace underscores with spaces
-                info.displayName.replace('_', ' ');
-
-                soundFiles.push_back(info);
-                Serial.printf("Found sound: %s (%d bytes)\n", filename.c_str(), file.size());
-            } else {
-                Serial.printf(">>> FileManager: Skipping non-audio file: %s\n", filename.c_str());
-            }
+        // Generate display name (remove extension, replace underscores with spaces)
+        const char* dot = strrchr(entry.name, '.');
+        size_t nameLength = (dot != nullptr && dot > entry.name) ? dot - entry.name : strlen(entry.name);
+        for (size_t c = 0; c < nameLength; c++) {
+            info.displayName += (entry.name[c] == '_') ? ' ' : entry.name[c];
         }
-        file = root.openNextFile();
-    }
 
-    root.close();
+        soundFiles.push_back(info);
+    }
 
     Serial.printf("Total sound files: %d\n", soundFiles.size());
     return soundFiles;
 }
 
-bool FileManager::isValidFilename(const String& filename) {
+bool FileManager::isValidFilename(const char* filename) {
     // Check for empty filename
-    if (filename.length() == 0) {
+    size_t length = filename ? strlen(filename) : 0;
+    if (length == 0) {
         return false;
     }
 
     // Check for path traversal attempts
-    if (filename.indexOf("..") >= 0 || filename.indexOf('/') >= 0 || filename.indexOf('\\') >= 0) {
+    if (strstr(filename, "..") != nullptr || strchr(filename, '/') != nullptr || strchr(filename, '\\') != nullptr) {
         Serial.println("ERROR: Invalid filename - contains path characters");
         return false;
     }
 
-    // Check for valid file extension
-    String lowerFilename = filename;
-    lowerFilename.toLowerCase();
-    if (!lowerFilename.endsWith(".mp3") && !lowerFilename.endsWith(".wav") && !lowerFilename.endsWith(".m4a")) {
+    // Check for valid file extension (any case)
+    const char* extension = (length >= 4) ? filename + length - 4 : "";
+    if (strcasecmp(extension, ".mp3") != 0 && strcasecmp(extension, ".wav") != 0 && strcasecmp(extension, ".m4a") != 0) {
         Serial.println("ERROR: Invalid filename - unsupported extension");
         return false;
     }
 
-    // Check filename length (SPIFFS path limit is 31 chars, /alarms/ = 8 chars, so filename max is 23)
+    // Check filename length (bank names are stored in the index, not as SPIFFS paths)
     // Note: filename includes extension (e.g., "myfile.m4a" = 11 chars)
-    if (filename.length() > 23) {
-        Serial.println("ERROR: Invalid filename - too long (max 23 chars total including extension)");
+    if (length > SOUND_NAME_BUFFER_LEN - 1) {
+        Serial.printf("ERROR: Invalid filename - too long (max %d chars total including extension)\n",
+                      SOUND_NAME_BUFFER_LEN - 1);
         return false;
     }
 
     return true;
 }
 
-bool FileManager::hasSpaceForFile(size_t fileSize) {
+bool FileManager::hasSpaceForFile(size_t fileSize, const uint8_t* digest) {
     if (!_initialized) {
         Serial.println("ERROR: FileManager not initialized!");
         return false;
     }
 
+    // Identical content is already stored and will be shared
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (digest != nullptr && lock.held() && _bank.findByDigest(digest, fileSize) != nullptr) {
+        Serial.println("Upload matches a stored sound, no space needed");
+        return true;
+    }
+
     size_t freeSpace = getFreeSpace();
     
-    // Add 10% buffer for filesystem overhead
-    size_t requiredSpace = fileSize + (fileSize / 10);
+    // Add 10% buffer for filesystem overhead, plus worst-case bank alignment padding
+    size_t requiredSpace = fileSize + (fileSize / 10) + SOUND_BANK_ALIGN;
     
     if (freeSpace < requiredSpace) {
         Serial.printf("ERROR: Insufficient space! Need %d bytes, have %d bytes\n", requiredSpace, freeSpace);
@@ -402,3 +384,417 @@ bool FileManager::hasSpaceForFile(size_t fileSize) {
 
     return true;
 }
+
+// ============================================
+// Sound Access
+// ============================================
+
+bool FileManager::soundExists(const char* name) {
+    if (!_initialized) {
+        return false;
+    }
+
+    // verify() may rewrite the catalog
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    return lock.held() && _catalog.verify(name);
+}
+
+bool FileManager::locateSound(const char* name, SoundLocation& location) {
+    if (!_initialized) {
+        return false;
+    }
+
+    // Bank offsets move while a compaction is running, and BLE may delete the sound
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (!lock.held()) {
+        LOG_W(STORAGE, "Storage busy, cannot locate %s", name);
+        return false;
+    }
+
+    if (!_catalog.verify(name)) {
+        return false;
+    }
+    const SoundCatalogEntry* entry = _catalog.find(name);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->bankId != 0) {
+        if (!_bank.locate(entry->bankId, location)) {
+            return false;
+        }
+
+        // Taken under the storage lock, so no compaction step can start before it
+        portENTER_CRITICAL(&_pinLock);
+        _bankReaders++;
+        portEXIT_CRITICAL(&_pinLock);
+        location.pinned = true;
+        return true;
+    }
+
+    location.path = StoragePath::forSound(name);
+    location.offset = 0;
+    location.length = entry->size;
+    location.codec = entry->codec;
+    return location.path.isValid();
+}
+
+void FileManager::unpinSound(const SoundLocation& location) {
+    if (!location.pinned) {
+        return;
+    }
+
+    // Not the storage lock: a stopping stream must not wait behind an upload
+    portENTER_CRITICAL(&_pinLock);
+    if (_bankReaders > 0) {
+        _bankReaders--;
+    }
+    portEXIT_CRITICAL(&_pinLock);
+}
+
+bool FileManager::deleteSound(const char* name) {
+    if (!_initialized) {
+        Serial.println("ERROR: FileManager not initialized!");
+        return false;
+    }
+
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (!lock.held()) {
+        Serial.println("ERROR: Storage busy (maintenance running)");
+        return false;
+    }
+
+    const SoundCatalogEntry* entry = _catalog.find(name);
+    if (entry == nullptr) {
+        Serial.printf("Sound does not exist: %s\n", name);
+        return false;
+    }
+
+    if (!releaseSound(*entry)) {
+        Serial.printf("ERROR: Failed to delete sound: %s\n", name);
+        return false;
+    }
+
+    Serial.printf("Deleted sound: %s\n", name);
+    _catalog.save();
+    return true;
+}
+
+bool FileManager::compactSounds() {
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (!_initialized || !lock.held() || _bank.isAppending() || bankPinned()) {
+        return false;
+    }
+    while (_bank.deadBytes() > 0) {
+        if (!_bank.compactStep()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FileManager::runMaintenance() {
+    // Never wait - foreground work has priority
+    StorageLock lock(_mutex, 0);
+    if (!_initialized || !lock.held() || _uploading) {
+        return false;
+    }
+
+    // Compaction rewrites bank pages, so do it before GC; a pinned payload
+    // may be streaming from the offset it was located at
+    if (_bank.deadBytes() > 0 && !bankPinned()) {
+        uint32_t compactStart = millis();
+        if (_bank.compactStep()) {
+            _stats.lastCompactMs = millis() - compactStart;
+            _stats.compactRuns++;
+        }
+    }
+
+    // Pre-erase free space so the next upload doesn't trigger GC mid-write
+    size_t freeBytes = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    size_t target = (freeBytes < STORAGE_GC_TARGET_BYTES) ? freeBytes : STORAGE_GC_TARGET_BYTES;
+    uint32_t gcStart = micros();
+    esp_err_t err = esp_spiffs_gc(nullptr, target);
+    _stats.lastGcUs = micros() - gcStart;
+    if (_stats.lastGcUs > _stats.maxGcUs) {
+        _stats.maxGcUs = _stats.lastGcUs;
+    }
+    _stats.gcRuns++;
+
+    _stats.freeBytes = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    _stats.reclaimableBytes = _bank.deadBytes();
+
+    LOG_D(STORAGE, "Maintenance - GC %lu us (%s, max %lu us), compact %lu ms, free %lu KB, reclaimable %lu KB",
+          (unsigned long)_stats.lastGcUs, (err == ESP_OK) ? "ok" : "partial",
+          (unsigned long)_stats.maxGcUs, (unsigned long)_stats.lastCompactMs,
+          (unsigned long)(_stats.freeBytes / 1024), (unsigned long)(_stats.reclaimableBytes / 1024));
+    return true;
+}
+
+// ============================================
+// Upload Session
+// ============================================
+
+bool FileManager::beginUpload(const char* filename, size_t size, const uint8_t* digest) {
+    if (!_initialized) {
+        Serial.println("ERROR: FileManager not initialized!");
+        return false;
+    }
+
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (!lock.held()) {
+        Serial.println("ERROR: Storage busy (maintenance running)");
+        return false;
+    }
+
+    abortUpload();
+
+    // Known content: hash incoming data to confirm it, but don't write it
+    const SoundBankEntry* existing = (digest != nullptr) ? _bank.findByDigest(digest, size) : nullptr;
+    if (existing != nullptr) {
+        Serial.printf("Upload %s is identical to bank sound %d, deduplicating\n", filename, existing->id);
+        _uploadDedupId = existing->id;
+    } else {
+        _uploadDedupId = 0;
+        if (!_bank.beginAppend()) {
+            Serial.printf("ERROR: Cannot start upload: %s\n", filename);
+            return false;
+        }
+    }
+
+    strncpy(_uploadName, filename, SOUND_NAME_BUFFER_LEN - 1);
+    _uploadName[SOUND_NAME_BUFFER_LEN - 1] = '\0';
+    _uploadCrc = 0;
+    _uploadBytes = 0;
+    _uploadHasDigest = digest != nullptr;
+    if (_uploadHasDigest) {
+        memcpy(_uploadDigest, digest, SOUND_DIGEST_LEN);
+    }
+    mbedtls_sha256_starts_ret(&_uploadSha, 0);
+    _uploading = true;
+    return true;
+}
+
+bool FileManager::writeUpload(const uint8_t* data, size_t len) {
+    if (!_uploading) {
+        return false;
+    }
+
+    size_t written = (_uploadDedupId != 0) ? len : _bank.append(data, len);
+    _uploadCrc = SoundCatalog::updateCrc(_uploadCrc, data, written);
+    mbedtls_sha256_update_ret(&_uploadSha, data, written);
+    _uploadBytes += written;
+
+    if (written != len) {
+        LOG_E(STORAGE, "Upload write incomplete! Wrote %u of %u bytes", written, len);
+        return false;
+    }
+    return true;
+}
+
+void FileManager::flushUpload() {
+    _bank.flushAppend();
+}
+
+bool FileManager::finishUpload() {
+    if (!_uploading) {
+        return false;
+    }
+
+    StorageLock lock(_mutex, LOCK_TIMEOUT);
+    if (!lock.held()) {
+        Serial.println("ERROR: Storage busy (maintenance running)");
+        return false;
+    }
+
+    uint8_t digest[SOUND_DIGEST_LEN];
+    mbedtls_sha256_finish_ret(&_uploadSha, digest);
+
+    if (_uploadHasDigest && memcmp(digest, _uploadDigest, SOUND_DIGEST_LEN) != 0) {
+        Serial.printf("ERROR: Upload %s does not match its SHA-256\n", _uploadName);
+        abortUpload();
+        return false;
+    }
+
+    // Content may match a stored sound even if the sender didn't say so
+    uint16_t id = _uploadDedupId;
+    if (id == 0) {
+        const SoundBankEntry* existing = _bank.findByDigest(digest, _uploadBytes);
+        if (existing != nullptr) {
+            Serial.printf("Upload %s is identical to bank sound %d, deduplicating\n", _uploadName, existing->id);
+            _bank.abortAppend();
+            id = existing->id;
+        }
+    }
+
+    SoundProbe probe;
+    if (id == 0) {
+        id = _bank.finishAppend(_uploadName, SoundCatalog::codecFromName(_uploadName), digest, probe);
+        if (id == 0) {
+            Serial.printf("ERROR: Could not add %s to sound bank\n", _uploadName);
+            _uploading = false;
+            _uploadName[0] = '\0';
+            return false;
+        }
+    }
+    _uploading = false;
+
+    // Replace an older sound with the same name
+    const SoundCatalogEntry* previous = _catalog.find(_uploadName);
+    if (previous != nullptr && previous->bankId != id) {
+        releaseSound(*previous);
+    }
+
+    SoundCatalogEntry entry;
+    describeBankSound(*_bank.find(id), _uploadName, _uploadCrc, entry);
+    entry.flags = SOUND_FLAG_VERIFIED;
+    _uploadName[0] = '\0';
+
+    Serial.printf("Upload complete: %s (bank id %d, %u bytes, ~%u ms, crc %08x)\n",
+                  entry.name, id, entry.size, entry.durationMs, entry.crc32);
+
+    if (!_catalog.put(entry)) {
+        Serial.println("ERROR: Sound catalog full");
+        if (_catalog.countBankRefs(id) == 0) {
+            _bank.remove(id);
+        }
+        return false;
+    }
+    return _catalog.save();
+}
+
+void FileManager::abortUpload() {
+    if (!_uploading) {
+        return;
+    }
+
+    StorageLock lock(_mutex, portMAX_DELAY);
+
+    _bank.abortAppend();
+    _uploading = false;
+    Serial.printf("Upload aborted: %s\n", _uploadName);
+    _uploadName[0] = '\0';
+}
+
+const SoundCatalogEntry* FileManager::getSoundInfo(const char* filename) {
+    if (!_initialized || !_catalog.verify(filename)) {
+        return nullptr;
+    }
+    return _catalog.find(filename);
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void FileManager::checkBank(bool verifyCrc, SoundCheckResult& result) {
+    bool changed = false;
+
+    // Catalog entries whose bank payload is gone or damaged
+    for (int i = (int)_catalog.count() - 1; i >= 0; i--) {
+        const SoundCatalogEntry& entry = _catalog.at(i);
+        if (entry.bankId == 0) {
+            continue;
+        }
+        result.checked++;
+
+        const SoundBankEntry* bankEntry = _bank.find(entry.bankId);
+        if (bankEntry == nullptr) {
+            Serial.printf("Storage check: %s missing from sound bank\n", entry.name);
+            result.missing++;
+            _catalog.remove(entry.name);
+            changed = true;
+        } else if (bankEntry->length != entry.size ||
+                   (verifyCrc && _bank.payloadCrc(entry.bankId) != entry.crc32)) {
+            // Kept as a loose file under SOUND_QUARANTINE_DIR (ID-named if the name is too long)
+            StoragePath path = StoragePath(SOUND_QUARANTINE_DIR).join(entry.name);
+            if (!path.isValid()) {
+                char name[16];
+                snprintf(name, sizeof(name), "bank_%u", entry.bankId);
+                path = StoragePath(SOUND_QUARANTINE_DIR).join(name);
+            }
+            if (_bank.quarantine(entry.bankId, path.c_str())) {
+                Serial.printf("Storage check: %s corrupted in sound bank, quarantined\n", entry.name);
+                result.quarantined++;
+                _catalog.remove(entry.name);
+                changed = true;
+            } else {
+                Serial.printf("Storage check: WARNING - %s corrupted in sound bank, could not quarantine\n",
+                              entry.name);
+            }
+        }
+    }
+
+    // Bank sounds the catalog doesn't know about (e.g. catalog was rebuilt)
+    for (size_t i = 0; i < _bank.count(); i++) {
+        const SoundBankEntry& bankEntry = _bank.at(i);
+        if (bankEntry.flags & (SOUND_BANK_FLAG_DELETED | SOUND_BANK_FLAG_QUARANTINED)) {
+            continue;
+        }
+        if (_catalog.countBankRefs(bankEntry.id) > 0 || _catalog.find(bankEntry.name) != nullptr) {
+            continue;  // Already catalogued (or name taken by a loose file)
+        }
+
+        SoundCatalogEntry entry;
+        describeBankSound(bankEntry, bankEntry.name, _bank.payloadCrc(bankEntry.id), entry);
+
+        if (_catalog.put(entry)) {
+            Serial.printf("Storage check: Catalogued bank sound %s\n", entry.name);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        _catalog.save();
+    }
+}
+
+bool FileManager::bankPinned() {
+    portENTER_CRITICAL(&_pinLock);
+    bool pinned = _bankReaders > 0;
+    portEXIT_CRITICAL(&_pinLock);
+    return pinned;
+}
+
+bool FileManager::releaseSound(const SoundCatalogEntry& entry) {
+    bool ok;
+    if (entry.bankId == 0) {
+        ok = SPIFFS.remove(StoragePath::forSound(entry.name).c_str());
+    } else if (_catalog.countBankRefs(entry.bankId) > 1) {
+        ok = true;  // Payload still used by another name
+    } else {
+        ok = _bank.remove(entry.bankId);
+    }
+
+    if (ok) {
+        _catalog.remove(entry.name);
+    }
+    return ok;
+}
+
+void FileManager::describeBankSound(const SoundBankEntry& bankEntry, const char* name, uint32_t crc,
+                                    SoundCatalogEntry& entry) {
+    memset(&entry, 0, sizeof(entry));
+    strncpy(entry.name, name, SOUND_NAME_BUFFER_LEN - 1);
+    entry.size = bankEntry.length;
+    entry.codec = bankEntry.codec;
+    entry.bankId = bankEntry.id;
+    entry.crc32 = crc;
+
+    SoundLocation location;
+    _bank.locate(bankEntry.id, location);
+    File file = SPIFFS.open(location.path.c_str(), "r");
+    if (file) {
+        SoundProbe probe;
+        SoundCatalog::probe(file, location.offset, location.length, (SoundCodec)entry.codec, probe);
+        entry.durationMs = probe.durationMs;
+        file.close();
+    }
+}
+
+const char* FileManager::soundNameFromPath(const StoragePath& path) {
+    const char* name = path.soundName();
+    if (name == nullptr || SoundCatalog::codecFromName(name) == SOUND_CODEC_UNKNOWN) {
+        return nullptr;
+    }
+    return name;
+}
@@ -4,22 +4,45 @@
 #include <Arduino.h>
 #include <SPIFFS.h>
 #include <vector>
+#include <mbedtls/sha256.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "config.h"
+#include "sound_catalog.h"
+#include "sound_bank.h"
+#include "storage_path.h"
 
 /**
  * @brief File information structure
  */
 struct SoundFileInfo {
-    String filename;      // e.g., "alarm1.mp3"
+    SoundName filename;   // e.g., "alarm1.mp3"
     size_t fileSize;      // bytes
-    String displayName;   // e.g., "Alarm 1"
+    SoundName displayName;  // e.g., "Alarm 1"
+    uint32_t durationMs;  // Estimated play time (0 = unknown)
+};
+
+/**
+ * @brief Storage maintenance statistics (see FileManager::runMaintenance)
+ */
+struct StorageStats {
+    uint32_t freeBytes;         // SPIFFS free space after the last pass
+    uint32_t reclaimableBytes;  // Sound bank space held by deleted sounds
+    uint32_t lastGcUs;          // Duration of the last GC call
+    uint32_t maxGcUs;           // Longest GC call since boot
+    uint32_t lastCompactMs;     // Duration of the last bank compaction step
+    uint16_t gcRuns;            // GC calls since boot
+    uint16_t compactRuns;       // Bank compaction steps since boot
 };
 
 /**
  * @brief FileManager handles SPIFFS operations for alarm sound files
  *
  * Provides file system mounting, CRUD operations, and space management
- * for custom alarm sound files stored in SPIFFS.
+ * for custom alarm sound files stored in SPIFFS. Uploaded sounds are packed
+ * into a SoundBank; sounds copied into the alarm directory as loose files
+ * are still supported. Both are tracked in a SoundCatalog so listing and
+ * lookups don't walk the directory.
  */
 class FileManager {
 public:
@@ -27,37 +50,40 @@ public:
     ~FileManager();
 
     /**
-     * @brief Initialize SPIFFS and create alarm directory
+     * @brief Mount SPIFFS, load the sound catalog and run the boot integrity check
+     *
+     * Never formats the partition unless STORAGE_FORMAT_ON_FAIL is set.
+     * A clean boot performs no flash writes.
      * @return true if successful, false otherwise
      */
     bool begin();
 
     /**
      * @brief Check if a file exists
-     * @param path Full path to file (e.g., "/spiffs/alarms/alarm1.mp3")
+     * @param path Full path to file (e.g., StoragePath::forSound("alarm1.mp3"))
      * @return true if file exists, false otherwise
      */
-    bool fileExists(const String& path);
+    bool fileExists(const StoragePath& path);
 
     /**
      * @brief Get file size in bytes
      * @param path Full path to file
      * @return File size in bytes, 0 if file doesn't exist
      */
-    size_t getFileSize(const String& path);
+    size_t getFileSize(const StoragePath& path);
 
     /**
      * @brief Delete a file
      * @param path Full path to file
      * @return true if successful, false otherwise
      */
-    bool deleteFile(const String& path);
+    bool deleteFile(const StoragePath& path);
 
     /**
      * @brief List all sound files in alarm directory
      * @return Vector of filenames (not full paths)
      */
-    std::vector<String> listSounds();
+    std::vector<SoundName> listSounds();
 
     /**
      * @brief Get free space in SPIFFS
@@ -79,7 +105,7 @@ public:
      * @param append If true, append to existing file; if false, create new file
      * @return true if successful, false otherwise
      */
-    bool writeChunk(const String& path, const uint8_t* data, size_t len, bool append);
+    bool writeChunk(const StoragePath& path, const uint8_t* data, size_t len, bool append);
 
     /**
      * @brief Read entire file into buffer
@@ -88,7 +114,7 @@ public:
      * @param maxLen Maximum buffer length
      * @return Number of bytes read, 0 on failure
      */
-    size_t readFile(const String& path, uint8_t* buffer, size_t maxLen);
+    size_t readFile(const StoragePath& path, uint8_t* buffer, size_t maxLen);
 
     /**
      * @brief Get list of sound files with metadata
@@ -101,24 +127,179 @@ public:
      * @param filename Filename to validate (without path)
      * @return true if valid, false otherwise
      */
-    bool isValidFilename(const String& filename);
+    bool isValidFilename(const char* filename);
 
     /**
      * @brief Check if there's enough space for a file
      * @param fileSize Size of file in bytes
+     * @param digest SHA-256 of the file if known; identical stored content needs no space
      * @return true if space available, false otherwise
      */
-    bool hasSpaceForFile(size_t fileSize);
+    bool hasSpaceForFile(size_t fileSize, const uint8_t* digest = nullptr);
+
+    /**
+     * @brief Check if a sound is available for playback
+     * @param name Sound name (filename without path)
+     * @return true if catalogued and present on flash
+     */
+    bool soundExists(const char* name);
+
+    /**
+     * @brief Resolve a sound name to the file range holding it
+     *
+     * A bank location is returned pinned: compaction moves no payload
+     * until every pinned location is released with unpinSound().
+     * @param name Sound name (filename without path)
+     * @param location Output location for AudioFileSourceBank
+     * @return true if the sound exists
+     */
+    bool locateSound(const char* name, SoundLocation& location);
+
+    /**
+     * @brief Release the bank pin taken by locateSound() (no-op if unpinned)
+     */
+    void unpinSound(const SoundLocation& location);
+
+    /**
+     * @brief Delete a sound (bank entry or loose file)
+     * @param name Sound name (filename without path)
+     * @return true if successful, false otherwise
+     */
+    bool deleteSound(const char* name);
+
+    /**
+     * @brief Reclaim space held by deleted bank sounds
+     *
+     * Runs compaction steps until the bank is packed, moving payloads
+     * within the bank. Refused while an upload is active or a located
+     * bank sound is still pinned.
+     * @return true if compacted (or nothing to reclaim)
+     */
+    bool compactSounds();
+
+    /**
+     * @brief Bytes that compactSounds() would reclaim
+     */
+    uint32_t getReclaimableSpace() const { return _bank.deadBytes(); }
+
+    /**
+     * @brief Idle-time flash maintenance: one bank compaction step, then pre-erase free space
+     *
+     * A pass moves at most one payload, so the storage lock is not held
+     * for a whole compaction. SPIFFS otherwise garbage-collects inside
+     * whichever write runs out of erased pages, stalling uploads and sound
+     * streaming. Call from the storage maintenance task only when no
+     * alarm is due and no sound is playing. Skipped while an upload is
+     * active; compaction is also skipped while a bank sound is pinned.
+     * @return true if a pass ran
+     */
+    bool runMaintenance();
+
+    /**
+     * @brief Statistics from the most recent maintenance pass
+     */
+    const StorageStats& getStorageStats() const { return _stats; }
+
+    /**
+     * @brief Start receiving a sound into the sound bank
+     *
+     * The upload is hashed while streaming. If the sender supplies the
+     * SHA-256 up front and identical content is already stored, received
+     * data is only hashed, never written, and the name becomes an alias.
+     * @param filename Sound name (must pass isValidFilename)
+     * @param size Expected size in bytes
+     * @param digest Expected SHA-256, or nullptr if not supplied
+     * @return true if ready to receive data
+     */
+    bool beginUpload(const char* filename, size_t size, const uint8_t* digest = nullptr);
+
+    /**
+     * @brief Append data to the file being uploaded
+     * @param data Pointer to data buffer
+     * @param len Length of data
+     * @return true if all bytes were written
+     */
+    bool writeUpload(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Flush buffered upload data to flash
+     */
+    void flushUpload();
+
+    /**
+     * @brief Add the uploaded sound to the bank index and sound catalog
+     *
+     * Identical content already in the bank is stored once and shared.
+     * Replaces any existing sound with the same name.
+     * @return true if the sound was catalogued
+     */
+    bool finishUpload();
+
+    /**
+     * @brief Abandon the upload (its bank space is reused by the next upload)
+     */
+    void abortUpload();
+
+    /**
+     * @brief Get catalog entry for a sound file
+     * @param filename Filename without path
+     * @return Catalog entry, or nullptr if not catalogued
+     */
+    const SoundCatalogEntry* getSoundInfo(const char* filename);
 
 private:
     bool _initialized;
+    SoundCatalog _catalog;
+    SoundBank _bank;
+    SemaphoreHandle_t _mutex;  // Recursive; serializes bank changes with the maintenance task
+    StorageStats _stats;
+    portMUX_TYPE _pinLock;
+    uint16_t _bankReaders;  // Pinned bank locations (taken under _mutex, released under _pinLock)
+
+    // Upload in progress
+    bool _uploading;
+    char _uploadName[SOUND_NAME_BUFFER_LEN];
+    uint32_t _uploadCrc;
+    uint32_t _uploadBytes;
+    mbedtls_sha256_context _uploadSha;
+    bool _uploadHasDigest;                    // Sender supplied the expected digest
+    uint8_t _uploadDigest[SOUND_DIGEST_LEN];  // Expected digest
+    uint16_t _uploadDedupId;                  // Bank ID of identical content (0 = store new payload)
+
+    /**
+     * @brief Remove one catalog name, freeing its bank payload if no other name uses it
+     */
+    bool releaseSound(const SoundCatalogEntry& entry);
+
+    /**
+     * @brief Check if a located bank sound is still being read (call with _mutex held)
+     */
+    bool bankPinned();
+
+    /**
+     * @brief Fill a catalog entry for a bank payload (probes duration)
+     */
+    void describeBankSound(const SoundBankEntry& bankEntry, const char* name, uint32_t crc, SoundCatalogEntry& entry);
+
+    /**
+     * @brief Reconcile catalog bank entries with the bank index
+     * @param verifyCrc true to compare payload CRCs, false for length only
+     * @param result Counts are added to the existing values
+     */
+    void checkBank(bool verifyCrc, SoundCheckResult& result);
+
+    /**
+     * @brief Catalogued sound filename for a path
+     * @return Pointer into path at the filename, or nullptr if path is not a sound file
+     */
+    static const char* soundNameFromPath(const StoragePath& path);
 
     /**
-     * @brief Create directory if it doesn't exist
+     * @brief Create directory placeholder if it doesn't exist (no write if present)
      * @param path Directory path
      * @return true if exists or created successfully
      */
-    bool ensureDirectory(const String& path);
+    bool ensureDirectory(const StoragePath& path);
 };
 
 #endif // FILE_MANAGER_H
@@ -0,0 +1,116 @@
+#include "fixed_string.h"
+#include <stdio.h>
+
+// ============================================
+// StringView
+// ============================================
+
+int StringView::indexOf(char c, size_t from) const {
+    if (from >= _length) {
+        return -1;
+    }
+    const char* found = (const char*)memchr(_data + from, c, _length - from);
+    return found ? (int)(found - _data) : -1;
+}
+
+StringView StringView::substring(size_t from, size_t to) const {
+    if (to > _length) {
+        to = _length;
+    }
+    if (from >= to) {
+        return StringView(_data + (from < _length ? from : _length), 0);
+    }
+    return StringView(_data + from, to - from);
+}
+
+uint32_t StringView::toUInt() const {
+    uint32_t value = 0;
+    for (size_t i = 0; i < _length && _data[i] >= '0' && _data[i] <= '9'; i++) {
+        value = value * 10 + (_data[i] - '0');
+    }
+    return value;
+}
+
+// ============================================
+// StringBuilder
+// ============================================
+
+StringBuilder::StringBuilder(char* buffer, size_t size)
+    : _buffer(buffer),
+      _size((uint16_t)(size < UINT16_MAX ? size : UINT16_MAX)),
+      _length(0),
+      _truncated(false) {
+    _buffer[0] = '\0';
+}
+
+void StringBuilder::clear() {
+    _length = 0;
+    _truncated = false;
+    _buffer[0] = '\0';
+}
+
+StringBuilder& StringBuilder::append(StringView text) {
+    size_t room = _size - 1 - _length;
+    size_t length = text.length();
+    if (length > room) {
+        length = room;
+        _truncated = true;
+    }
+    memcpy(_buffer + _length, text.data(), length);
+    _length += length;
+    _buffer[_length] = '\0';
+    return *this;
+}
+
+StringBuilder& StringBuilder::append(char c) {
+    if (_length + 1 < _size) {
+        _buffer[_length++] = c;
+        _buffer[_length] = '\0';
+    } else {
+        _truncated = true;
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendUInt(uint32_t value) {
+    // Cheaper than appendf for the numbers in hot formatting paths
+    char digits[10];
+    size_t count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        append(digits[--count]);
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::appendf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vappendf(format, args);
+    va_end(args);
+    return *this;
+}
+
+StringBuilder& StringBuilder::vappendf(const char* format, va_list args) {
+    size_t room = _size - _length;
+    int written = vsnprintf(_buffer + _length, room, format, args);
+    if (written < 0) {
+        _buffer[_length] = '\0';
+    } else if ((size_t)written >= room) {
+        _length = _size - 1;  // vsnprintf filled the rest and terminated
+        _truncated = true;
+    } else {
+        _length += written;
+    }
+    return *this;
+}
+
+void StringBuilder::truncate(size_t length) {
+    if (length < _length) {
+        _length = length;
+        _buffer[_length] = '\0';
+    }
+}
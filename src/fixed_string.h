@@ -0,0 +1,135 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * StringView - Non-owning view of a character range (not null-terminated)
+ *
+ * For slicing text that already lives somewhere else (a BLE write, an
+ * NVS record) without copying it. The viewed text must outlive the view.
+ */
+class StringView {
+public:
+    StringView() : _data(""), _length(0) {}
+    StringView(const char* text) : _data(text ? text : ""), _length(text ? strlen(text) : 0) {}
+    StringView(const char* data, size_t length) : _data(data), _length(length) {}
+
+    const char* data() const { return _data; }
+    size_t length() const { return _length; }
+    bool isEmpty() const { return _length == 0; }
+
+    bool equals(StringView other) const {
+        return _length == other._length && memcmp(_data, other._data, _length) == 0;
+    }
+    bool operator==(StringView other) const { return equals(other); }
+    bool operator!=(StringView other) const { return !equals(other); }
+    bool startsWith(StringView prefix) const {
+        return _length >= prefix._length && memcmp(_data, prefix._data, prefix._length) == 0;
+    }
+
+    /**
+     * @return Index of the first c at or after from, or -1
+     */
+    int indexOf(char c, size_t from = 0) const;
+
+    /**
+     * Characters [from, to), clamped to the view
+     */
+    StringView substring(size_t from, size_t to = SIZE_MAX) const;
+
+    /**
+     * Leading decimal digits as a number (0 if there are none)
+     */
+    uint32_t toUInt() const;
+
+private:
+    const char* _data;
+    size_t _length;
+};
+
+/**
+ * StringBuilder - Appends text into a caller's buffer, never allocating
+ *
+ * The buffer is always null-terminated. Text that does not fit is cut
+ * off and truncated() reports it, so callers decide whether a partial
+ * result is usable (a display label) or not (a JSON document).
+ *
+ * Usage: char line[48]; StringBuilder out(line, sizeof(line));
+ *        out.appendf("RECEIVING:%u/%u", received, total);
+ */
+class StringBuilder {
+public:
+    StringBuilder(char* buffer, size_t size);
+
+    const char* c_str() const { return _buffer; }
+    size_t length() const { return _length; }
+    size_t capacity() const { return _size - 1; }
+    bool isEmpty() const { return _length == 0; }
+    bool truncated() const { return _truncated; }
+    StringView view() const { return StringView(_buffer, _length); }
+    operator StringView() const { return view(); }
+
+    void clear();
+    StringBuilder& assign(StringView text) { clear(); return append(text); }
+    StringBuilder& append(StringView text);
+    StringBuilder& append(char c);
+    StringBuilder& appendUInt(uint32_t value);
+    StringBuilder& appendf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    StringBuilder& vappendf(const char* format, va_list args);
+
+    /**
+     * Shorten to length characters (no effect if already shorter)
+     */
+    void truncate(size_t length);
+
+    StringBuilder& operator=(StringView text) { return assign(text); }
+    StringBuilder& operator+=(StringView text) { return append(text); }
+    StringBuilder& operator+=(char c) { return append(c); }
+    bool operator==(StringView text) const { return view() == text; }
+    bool operator!=(StringView text) const { return view() != text; }
+    bool startsWith(StringView prefix) const { return view().startsWith(prefix); }
+
+protected:
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    char* _buffer;
+    uint16_t _size;     // Buffer bytes including the terminator
+    uint16_t _length;
+    bool _truncated;
+};
+
+/**
+ * FixedString - StringBuilder with inline storage for up to N characters
+ *
+ * A value type: copies the text, never the pointer, so it can live in
+ * structs that are copied around (AlarmData) and in std::vector.
+ */
+template <size_t N>
+class FixedString : public StringBuilder {
+    static_assert(N > 0 && N < UINT16_MAX, "FixedString capacity out of range");
+
+public:
+    FixedString() : StringBuilder(_storage, N + 1) {}
+    FixedString(StringView text) : StringBuilder(_storage, N + 1) { append(text); }
+    FixedString(const char* text) : StringBuilder(_storage, N + 1) { append(text); }
+    FixedString(const FixedString& other) : StringBuilder(_storage, N + 1) { append(other.view()); }
+
+    FixedString& operator=(const FixedString& other) {
+        if (this != &other) {
+            assign(other.view());
+        }
+        return *this;
+    }
+    FixedString& operator=(StringView text) { assign(text); return *this; }
+    FixedString& operator=(const char* text) { assign(text); return *this; }
+
+private:
+    char _storage[N + 1];
+};
+
+#endif // FIXED_STRING_H
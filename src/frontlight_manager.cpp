@@ -1,10 +1,55 @@
 #include "frontlight_manager.h"
-#include <Preferences.h>
+#include "board_profile.h"
+#include "settings_store.h"
+
+extern SettingsStore settings;
+
+// ============================================
+// Brightness Curve
+// ============================================
+// Percent -> 11-bit duty following CIE 1931 lightness (L* = percent), so
+// equal steps look equal and the dim end, used at night, gets fine steps.
+// Generated at compile time; lives in flash.
+
+static const uint32_t DUTY_MAX = 2047;
+
+struct BrightnessCurve {
+    uint16_t duty[101];
+
+    constexpr BrightnessCurve() : duty() {
+        for (int percent = 0; percent <= 100; percent++) {
+            // Relative luminance Y for lightness L* = percent
+            double l = (double)percent;
+            double y = (l > 8.0) ? ((l + 16.0) / 116.0) * ((l + 16.0) / 116.0) * ((l + 16.0) / 116.0)
+                                 : l / 903.3;
+            uint32_t value = (uint32_t)(y * DUTY_MAX + 0.5);
+            if (percent > 0 && value == 0) {
+                value = 1;
+            }
+            duty[percent] = (uint16_t)value;
+        }
+    }
+};
+
+static constexpr BrightnessCurve BRIGHTNESS_CURVE;
+
+static_assert(BRIGHTNESS_CURVE.duty[0] == 0, "0% must be off");
+static_assert(BRIGHTNESS_CURVE.duty[1] > 0, "1% must be visible");
+static_assert(BRIGHTNESS_CURVE.duty[100] == DUTY_MAX, "100% must be full duty");
 
 FrontlightManager::FrontlightManager()
     : _brightness(50),           // Default 50% brightness
       _savedBrightness(50),
-      _isOn(true) {
+      _isOn(true),
+      _sunriseActive(false),
+      _sunriseFrom(0),
+      _sunriseTo(0),
+      _sunriseDurationMs(0),
+      _sunriseElapsedMs(0),
+      _fadeInstalled(false),
+      _levelPending(false),
+      _pendingLevel(0),
+      _pendingFadeMs(0) {
 }
 
 bool FrontlightManager::begin() {
@@ -14,16 +59,19 @@ bool FrontlightManager::begin() {
     ledcSetup(PWM_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION);
 
     // Attach channel to GPIO pin
-    ledcAttachPin(FRONTLIGHT_PIN, PWM_CHANNEL);
+    ledcAttachPin(Board::PINS.frontlight, PWM_CHANNEL);
 
-    // Load brightness from NVS
-    Preferences prefs;
-    prefs.begin("frontlight", true);  // Read-only
-    _brightness = prefs.getUChar("brightness", 50);  // Default 50%
-    _savedBrightness = _brightness;
-    prefs.end();
+    // Hardware fade engine (without it every change is an immediate step)
+    esp_err_t err = ledc_fade_func_install(0);
+    _fadeInstalled = (err == ESP_OK);
+    if (!_fadeInstalled) {
+        Serial.printf("FrontlightManager: Fade unavailable (%d), brightness changes will step\n", err);
+    }
 
-    Serial.print("FrontlightManager: Loaded brightness from NVS: ");
+    // Load brightness from the settings store
+    loadBrightness();
+
+    Serial.print("FrontlightManager: Loaded brightness from settings: ");
     Serial.print(_brightness);
     Serial.println("%");
 
@@ -31,12 +79,14 @@ bool FrontlightManager::begin() {
     updatePWM();
 
     Serial.print("FrontlightManager: Initialized on GPIO ");
-    Serial.println(FRONTLIGHT_PIN);
+    Serial.println(Board::PINS.frontlight);
 
     return true;
 }
 
-void FrontlightManager::setBrightness(uint8_t brightness) {
+void FrontlightManager::setBrightness(uint8_t brightness, uint32_t fadeMs) {
+    _sunriseActive = false;
+
     // Clamp to 0-100 range
     if (brightness > 100) {
         brightness = 100;
@@ -55,14 +105,16 @@ void FrontlightManager::setBrightness(uint8_t brightness) {
     // Save to NVS
     saveBrightness();
 
-    updatePWM();
+    updatePWM(fadeMs);
 
     Serial.print("FrontlightManager: Brightness set to ");
     Serial.print(_brightness);
     Serial.println("%");
 }
 
-void FrontlightManager::setBrightnessTemporary(uint8_t brightness) {
+void FrontlightManager::setBrightnessTemporary(uint8_t brightness, uint32_t fadeMs) {
+    _sunriseActive = false;
+
     // Clamp to 0-100 range
     if (brightness > 100) {
         brightness = 100;
@@ -80,7 +132,7 @@ void FrontlightManager::setBrightnessTemporary(uint8_t brightness) {
 
     // Do NOT save to NVS - this is temporary
 
-    updatePWM();
+    updatePWM(fadeMs);
 
     Serial.print("FrontlightManager: Brightness set temporarily to ");
     Serial.print(_brightness);
@@ -92,6 +144,7 @@ uint8_t FrontlightManager::getBrightness() const {
 }
 
 void FrontlightManager::on() {
+    _sunriseActive = false;
     _isOn = true;
     _brightness = _savedBrightness;
 
@@ -107,6 +160,7 @@ void FrontlightManager::on() {
 }
 
 void FrontlightManager::off() {
+    _sunriseActive = false;
     _isOn = false;
     _savedBrightness = _brightness;  // Remember current brightness
     _brightness = 0;
@@ -119,27 +173,104 @@ bool FrontlightManager::isOn() const {
     return _isOn;
 }
 
-void FrontlightManager::updatePWM() {
-    uint8_t pwmValue = percentToPWM(_brightness);
-    ledcWrite(PWM_CHANNEL, pwmValue);
+void FrontlightManager::startSunrise(uint8_t targetPercent, uint32_t durationMs) {
+    if (targetPercent > 100) {
+        targetPercent = 100;
+    }
+
+    _sunriseFrom = _brightness * 10;
+    _sunriseTo = targetPercent * 10;
+    _sunriseDurationMs = (durationMs > 0) ? durationMs : 1;
+    _sunriseElapsedMs = 0;
+    _sunriseActive = true;
+    _isOn = true;
+    _segmentDone.cancel();  // First segment is issued by the next update()
+
+    Serial.printf("FrontlightManager: Sunrise %d%% -> %d%% over %lu s\n",
+                  _brightness, targetPercent, (unsigned long)(durationMs / 1000));
+}
+
+void FrontlightManager::cancelSunrise() {
+    if (_sunriseActive) {
+        _sunriseActive = false;
+        Serial.println("FrontlightManager: Sunrise cancelled");
+    }
 }
 
-uint8_t FrontlightManager::percentToPWM(uint8_t percent) {
-    // Convert 0-100 percent to 0-255 PWM value
-    return (uint8_t)((percent * 255) / 100);
+void FrontlightManager::update() {
+    if (_levelPending && _fadeDone.hasExpired()) {
+        applyLevel(_pendingLevel, _pendingFadeMs);
+    }
+
+    if (!_sunriseActive || _sunriseElapsedMs >= _sunriseDurationMs) {
+        return;  // No ramp, or holding at the target
+    }
+    if (_segmentDone.isArmed() && !_segmentDone.hasExpired()) {
+        return;
+    }
+
+    // Fade to where the ramp should be at the end of the next segment
+    uint32_t step = _sunriseDurationMs - _sunriseElapsedMs;
+    if (step > SUNRISE_STEP_MS) {
+        step = SUNRISE_STEP_MS;
+    }
+    _sunriseElapsedMs += step;
+
+    int32_t span = (int32_t)_sunriseTo - (int32_t)_sunriseFrom;
+    uint16_t level = _sunriseFrom + (int32_t)((int64_t)span * _sunriseElapsedMs / _sunriseDurationMs);
+    _brightness = (level + 5) / 10;
+
+    applyLevel(level, step);
+    _segmentDone.start(step);
+}
+
+void FrontlightManager::updatePWM(uint32_t fadeMs) {
+    applyLevel(_brightness * 10, fadeMs);
+}
+
+void FrontlightManager::applyLevel(uint16_t level, uint32_t fadeMs) {
+    // Don't wait on the driver's fade lock inside loop()
+    if (_fadeDone.isArmed() && !_fadeDone.hasExpired()) {
+        _pendingLevel = level;
+        _pendingFadeMs = fadeMs;
+        _levelPending = true;
+        return;
+    }
+    _fadeDone.cancel();
+    _levelPending = false;
+
+    uint32_t duty = levelToDuty(level);
+
+    if (!_fadeInstalled) {
+        ledcWrite(PWM_CHANNEL, duty);
+    } else if (fadeMs == 0) {
+        ledc_set_duty_and_update(LEDC_MODE, LEDC_CHANNEL, duty, 0);
+    } else {
+        ledc_set_fade_with_time(LEDC_MODE, LEDC_CHANNEL, duty, (int)fadeMs);
+        ledc_fade_start(LEDC_MODE, LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+        _fadeDone.start(fadeMs);  // The fade takes at most fadeMs
+    }
+}
+
+uint32_t FrontlightManager::levelToDuty(uint16_t level) {
+    static_assert((1UL << PWM_RESOLUTION) - 1 == DUTY_MAX, "Brightness curve is built for the PWM resolution");
+
+    if (level >= 1000) {
+        return DUTY_MAX;
+    }
+
+    // Interpolate tenths between whole-percent curve points
+    uint32_t low = BRIGHTNESS_CURVE.duty[level / 10];
+    uint32_t high = BRIGHTNESS_CURVE.duty[level / 10 + 1];
+    uint32_t duty = low + ((high - low) * (level % 10) + 5) / 10;
+    return (level > 0 && duty == 0) ? 1 : duty;
 }
 
 void FrontlightManager::saveBrightness() {
-    Preferences prefs;
-    prefs.begin("frontlight", false);
-    prefs.putUChar("brightness", _brightness);
-    prefs.end();
+    settings.setBrightness(_brightness);  // Written to NVS once the slider settles
 }
 
 void FrontlightManager::loadBrightness() {
-    Preferences prefs;
-    prefs.begin("frontlight", true);
-    _brightness = prefs.getUChar("brightness", 50);  // Default 50%
+    _brightness = settings.getBrightness();
     _savedBrightness = _brightness;
-    prefs.end();
 }
@@ -2,13 +2,18 @@
 #define FRONTLIGHT_MANAGER_H
 
 #include <Arduino.h>
+#include <driver/ledc.h>
 #include "config.h"
+#include "mono_clock.h"
 
 /**
  * FrontlightManager - PWM control for DESPI-F01 frontlight via MOSFET
  *
  * Controls brightness of e-ink display frontlight using PWM signal
- * connected to 2N7000 N-channel MOSFET gate.
+ * connected to 2N7000 N-channel MOSFET gate. Brightness percentages follow
+ * perceived lightness rather than duty cycle, and changes can be faded by
+ * the LEDC hardware fade engine, which steps the duty cycle without CPU
+ * involvement.
  */
 class FrontlightManager {
 public:
@@ -21,17 +26,46 @@ public:
     bool begin();
 
     /**
-     * Set brightness level
+     * Set brightness level (ends any sunrise ramp)
      * @param brightness 0-100 (0 = off, 100 = full brightness)
+     * @param fadeMs Hardware fade duration (0 = immediate)
      */
-    void setBrightness(uint8_t brightness);
+    void setBrightness(uint8_t brightness, uint32_t fadeMs = 0);
 
     /**
-     * Set brightness temporarily without saving to NVS
+     * Set brightness temporarily without saving to NVS (ends any sunrise ramp)
      * Used for alarm brightness boost - doesn't overwrite user's saved setting
      * @param brightness 0-100 (0 = off, 100 = full brightness)
+     * @param fadeMs Hardware fade duration (0 = immediate)
      */
-    void setBrightnessTemporary(uint8_t brightness);
+    void setBrightnessTemporary(uint8_t brightness, uint32_t fadeMs = 0);
+
+    /**
+     * Ramp brightness up from the current level ahead of an alarm (not saved)
+     *
+     * The ramp is a chain of SUNRISE_STEP_MS hardware fades driven by
+     * update(), then holds at the target until brightness is set again or
+     * cancelSunrise() is called.
+     * @param targetPercent Brightness at the end of the ramp
+     * @param durationMs Ramp length
+     */
+    void startSunrise(uint8_t targetPercent, uint32_t durationMs);
+
+    /**
+     * Stop a sunrise ramp, leaving the current level in place
+     */
+    void cancelSunrise();
+
+    /**
+     * Check if a sunrise ramp is running or holding at its target
+     */
+    bool isSunriseActive() const { return _sunriseActive; }
+
+    /**
+     * Advance the sunrise ramp and apply a level held back by a running
+     * fade (call from loop)
+     */
+    void update();
 
     /**
      * Get current brightness level
@@ -70,13 +104,48 @@ private:
     uint8_t _savedBrightness;     // Saved brightness when turning off
     bool _isOn;
 
+    // Sunrise ramp (levels in tenths of a percent)
+    bool _sunriseActive;
+    uint16_t _sunriseFrom;
+    uint16_t _sunriseTo;
+    uint32_t _sunriseDurationMs;
+    uint32_t _sunriseElapsedMs;  // Ramp time covered by the fades issued so far
+    Deadline _segmentDone;
+
     // PWM Configuration
     static const uint8_t PWM_CHANNEL = 0;       // LED PWM channel
-    static const uint32_t PWM_FREQUENCY = 30000; // 25 kHz PWM frequency (above audible range)
-    static const uint8_t PWM_RESOLUTION = 8;    // 8-bit resolution (0-255)
+    static const uint32_t PWM_FREQUENCY = 39062; // 80 MHz / 2048: above 20 kHz, so the MOSFET and frontlight don't whine
+    static const uint8_t PWM_RESOLUTION = 11;   // 11-bit resolution (0-2047); 12 bits would cap the clock at 19.5 kHz
+
+    // Arduino LEDC channel 0 is hardware channel 0 of the high-speed group
+    static const ledc_mode_t LEDC_MODE = LEDC_HIGH_SPEED_MODE;
+    static const ledc_channel_t LEDC_CHANNEL = LEDC_CHANNEL_0;
+
+    bool _fadeInstalled;
+    Deadline _fadeDone;       // End of the hardware fade in progress
+    bool _levelPending;       // A level is waiting for that fade to end
+    uint16_t _pendingLevel;
+    uint32_t _pendingFadeMs;
 
-    void updatePWM();
-    uint8_t percentToPWM(uint8_t percent);
+    /**
+     * Drive the output to a level
+     *
+     * While a hardware fade runs, the LEDC driver blocks any new duty or
+     * fade on the channel until the fade ends. The level is then held
+     * and applied by update() once the fade is over; a newer level
+     * replaces a held one.
+     * @param level Tenths of a percent (0-1000)
+     * @param fadeMs Hardware fade duration (0 = immediate)
+     */
+    void applyLevel(uint16_t level, uint32_t fadeMs);
+    void updatePWM(uint32_t fadeMs = 0);
+
+    /**
+     * Perceptual (CIE 1931 lightness) duty for a level
+     * @param level Tenths of a percent (0-1000)
+     * @return Duty 0-2047, at least 1 for any non-zero level
+     */
+    static uint32_t levelToDuty(uint16_t level);
 };
 
 #endif // FRONTLIGHT_MANAGER_H
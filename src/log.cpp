@@ -0,0 +1,167 @@
+#include "log.h"
+#include "task_monitor.h"
+
+static const char* const MODULE_NAMES[LOG_MODULE_COUNT] = {
+    "MAIN", "AUDIO", "BLE", "BUTTON", "STORAGE", "DISPLAY", "ALARM"
+};
+static const char LEVEL_LETTERS[] = { '-', 'E', 'W', 'I', 'D' };
+
+Log::Record Log::_ring[LOG_RING_RECORDS];
+std::atomic<uint32_t> Log::_head(0);
+std::atomic<uint32_t> Log::_tail(0);
+LogStats Log::_stats = { 0, 0, 0, 0, 0 };
+
+void Log::begin() {
+    // Lowest priority: logs are printed when nothing else wants the CPU
+    TaskHandle_t task = NULL;
+    xTaskCreate(drainTask, "LogTask", LOG_TASK_STACK, NULL, 0, &task);
+    TaskMonitor::watch(task, LOG_TASK_STACK);
+}
+
+void Log::flush() {
+    // Single consumer: a flush already in progress (drain task) finishes the job
+    static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    if (busy.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    while (true) {
+        Record& record = _ring[tail % LOG_RING_RECORDS];
+        if (!record.ready.load(std::memory_order_acquire)) {
+            break;  // Empty, or the oldest record is still being filled
+        }
+        print(record);
+        record.ready.store(0, std::memory_order_release);
+        _tail.store(++tail, std::memory_order_release);
+    }
+    busy.clear(std::memory_order_release);
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+Log::Record* Log::reserve() {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    do {
+        if (head - _tail.load(std::memory_order_acquire) >= LOG_RING_RECORDS) {
+            _stats.dropped++;
+            return nullptr;
+        }
+    } while (!_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel));
+
+    uint32_t queued = head + 1 - _tail.load(std::memory_order_relaxed);
+    if (queued > _stats.highWater) {
+        _stats.highWater = queued;
+    }
+    return &_ring[head % LOG_RING_RECORDS];
+}
+
+void Log::publish(Record* record, uint32_t cycles) {
+    record->ready.store(1, std::memory_order_release);
+
+    // Statistics only; an occasional lost update between tasks is acceptable
+    _stats.written++;
+    _stats.totalCycles += cycles;
+    if (cycles > _stats.maxCycles) {
+        _stats.maxCycles = cycles;
+    }
+}
+
+void Log::encode(Record& record, const char* value) {
+    if (value == nullptr) {
+        value = "(null)";
+    }
+
+    // Copy what fits; a later string may find no room and print empty
+    uint8_t offset = record.stringUsed;
+    size_t room = LOG_STRING_BYTES - offset;
+    size_t length = strlen(value);
+    if (room == 0) {
+        offset = LOG_STRING_BYTES - 1;  // Points at the final terminator
+    } else {
+        if (length > room - 1) {
+            length = room - 1;
+        }
+        memcpy(record.strings + offset, value, length);
+        record.strings[offset + length] = '\0';
+        record.stringUsed = offset + length + 1;
+    }
+    record.strings[LOG_STRING_BYTES - 1] = '\0';
+    setArg(record, ARG_STRING, offset);
+}
+
+void Log::print(const Record& record) {
+    char line[160];
+    int pos = snprintf(line, sizeof(line), "[%6lu.%03lu] %c %s: ",
+                       (unsigned long)(record.ms / 1000), (unsigned long)(record.ms % 1000),
+                       LEVEL_LETTERS[record.level], MODULE_NAMES[record.module]);
+
+    // Format one conversion at a time so each argument is passed with its own type
+    const char* p = record.format;
+    uint8_t arg = 0;
+    while (*p != '\0' && pos < (int)sizeof(line) - 2) {
+        if (*p != '%') {
+            line[pos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[pos++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy the conversion spec, e.g. "%-8s" or "%lu"
+        char spec[16];
+        uint8_t len = 0;
+        spec[len++] = *p++;
+        while (*p != '\0' && strchr("diouxXcsfFeEgGp", *p) == nullptr && len < sizeof(spec) - 2) {
+            spec[len++] = *p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        char conversion = *p++;
+        spec[len++] = conversion;
+        spec[len] = '\0';
+
+        if (arg >= record.argc) {
+            pos += snprintf(line + pos, sizeof(line) - pos, "?");
+            continue;
+        }
+
+        ArgTag tag = (ArgTag)((record.tags >> (arg * 2)) & 0x03);
+        uint32_t value = record.args[arg++];
+        size_t room = sizeof(line) - pos;
+        bool isString = (conversion == 's');
+        bool isFloat = (strchr("fFeEgG", conversion) != nullptr);
+        if (isString != (tag == ARG_STRING) || isFloat != (tag == ARG_FLOAT)) {
+            pos += snprintf(line + pos, room, "?");  // Argument doesn't match the conversion
+        } else if (tag == ARG_STRING) {
+            pos += snprintf(line + pos, room, spec, record.strings + value);
+        } else if (tag == ARG_FLOAT) {
+            float f;
+            memcpy(&f, &value, sizeof(f));
+            pos += snprintf(line + pos, room, spec, (double)f);
+        } else if (tag == ARG_INT) {
+            pos += snprintf(line + pos, room, spec, (int32_t)value);
+        } else {
+            pos += snprintf(line + pos, room, spec, value);
+        }
+    }
+
+    if (pos > (int)sizeof(line) - 2) {
+        pos = sizeof(line) - 2;
+    }
+    line[pos++] = '\n';
+    Serial.write((const uint8_t*)line, pos);
+}
+
+void Log::drainTask(void* pvParameters) {
+    (void)pvParameters;
+    while (true) {
+        flush();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
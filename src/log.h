@@ -0,0 +1,175 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+// Log levels (a call is kept if its level <= the module's level)
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+#include "config.h"
+
+#ifndef LOG_LEVEL_MAX
+#ifdef LOG_RELEASE
+#define LOG_LEVEL_MAX LOG_LEVEL_INFO
+#else
+#define LOG_LEVEL_MAX LOG_LEVEL_DEBUG
+#endif
+#endif
+
+/**
+ * Log modules (names match the LOG_<module>_LEVEL settings in config.h)
+ */
+enum LogModule : uint8_t {
+    LOG_MODULE_MAIN = 0,
+    LOG_MODULE_AUDIO,
+    LOG_MODULE_BLE,
+    LOG_MODULE_BUTTON,
+    LOG_MODULE_STORAGE,
+    LOG_MODULE_DISPLAY,
+    LOG_MODULE_ALARM,
+    LOG_MODULE_COUNT
+};
+
+/**
+ * Logging cost and loss counters
+ */
+struct LogStats {
+    uint32_t written;      // Records queued
+    uint32_t dropped;      // Records lost because the ring was full
+    uint32_t totalCycles;  // CPU cycles spent queuing (divide by written for the average)
+    uint32_t maxCycles;    // Most expensive single call
+    uint16_t highWater;    // Most records waiting at once
+};
+
+/**
+ * Log - Deferred logging through a lock-free ring of binary records
+ *
+ * A log call stores the format string pointer, its arguments and a
+ * timestamp in a 64-byte record and returns; nothing is formatted and
+ * the UART is never touched by the caller. A low-priority task formats
+ * and prints queued records. Any task may log (multi-producer, one
+ * consumer); when the ring is full records are dropped and counted.
+ *
+ * Format strings must be literals. Arguments may be integers, floats,
+ * C strings or Strings (up to LOG_MAX_ARGS; string contents are copied,
+ * LOG_STRING_BYTES in total per record). 64-bit integers are not supported.
+ *
+ * Usage: LOG_I(AUDIO, "Playing %s (loop=%d)", name, loop);
+ */
+class Log {
+public:
+    static const uint8_t LOG_MAX_ARGS = 6;
+    static const uint8_t LOG_STRING_BYTES = 24;
+
+    /**
+     * Start the drain task
+     */
+    static void begin();
+
+    /**
+     * Queue a record (use the LOG_x macros, which strip disabled levels)
+     */
+    template <typename... Args>
+    static void write(LogModule module, uint8_t level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+        uint32_t startCycles = ESP.getCycleCount();
+
+        Record* record = reserve();
+        if (record == nullptr) {
+            return;
+        }
+        record->ms = millis();
+        record->format = format;
+        record->module = module;
+        record->level = level;
+        record->argc = 0;
+        record->tags = 0;
+        record->stringUsed = 0;
+        int expand[] = { 0, (encode(*record, args), 0)... };
+        (void)expand;
+        publish(record, ESP.getCycleCount() - startCycles);
+    }
+
+    /**
+     * Format and print everything queued (drain task, or a caller about to restart)
+     */
+    static void flush();
+
+    /**
+     * Logging statistics since boot
+     */
+    static const LogStats& getStats() { return _stats; }
+
+private:
+    enum ArgTag : uint8_t { ARG_INT = 0, ARG_UINT = 1, ARG_FLOAT = 2, ARG_STRING = 3 };
+
+    struct Record {
+        std::atomic<uint8_t> ready;  // Set by the producer once filled
+        uint8_t module;
+        uint8_t level;
+        uint8_t argc;
+        uint16_t tags;       // 2 bits per argument (ArgTag)
+        uint8_t stringUsed;  // Bytes of strings[] in use
+        uint8_t reserved;
+        uint32_t ms;
+        const char* format;
+        uint32_t args[LOG_MAX_ARGS];  // Values, float bits, or offsets into strings[]
+        char strings[LOG_STRING_BYTES];
+    };
+
+    static Record _ring[LOG_RING_RECORDS];
+    static std::atomic<uint32_t> _head;  // Next record to reserve
+    static std::atomic<uint32_t> _tail;  // Next record to print
+    static LogStats _stats;
+
+    static Record* reserve();
+    static void publish(Record* record, uint32_t cycles);
+    static void print(const Record& record);
+    static void drainTask(void* pvParameters);
+
+    static void setArg(Record& record, ArgTag tag, uint32_t value) {
+        record.tags |= tag << (record.argc * 2);
+        record.args[record.argc++] = value;
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    encode(Record& record, const T& value) {
+        setArg(record, std::is_signed<T>::value ? ARG_INT : ARG_UINT, (uint32_t)value);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    encode(Record& record, const T& value) {
+        float f = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        setArg(record, ARG_FLOAT, bits);
+    }
+
+    static void encode(Record& record, const char* value);
+    static void encode(Record& record, char* value) { encode(record, (const char*)value); }
+    static void encode(Record& record, const String& value) { encode(record, value.c_str()); }
+};
+
+#define LOG_ENABLED(module, level) ((level) <= LOG_##module##_LEVEL && (level) <= LOG_LEVEL_MAX)
+
+#define LOG_AT(module, level, format, ...)                                     \
+    do {                                                                       \
+        if (LOG_ENABLED(module, level)) {                                      \
+            Log::write(LOG_MODULE_##module, level, format, ##__VA_ARGS__);     \
+        }                                                                      \
+    } while (0)
+
+#define LOG_E(module, format, ...) LOG_AT(module, LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_W(module, format, ...) LOG_AT(module, LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define LOG_I(module, format, ...) LOG_AT(module, LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_D(module, format, ...) LOG_AT(module, LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+
+#endif // LOG_H
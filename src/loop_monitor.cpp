@@ -0,0 +1,178 @@
+#include "loop_monitor.h"
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include "log.h"
+#include "metrics.h"
+
+LoopMonitor::StageStats LoopMonitor::_stats[LOOP_STAGE_COUNT + 1];
+uint32_t LoopMonitor::_iterationStartUs = 0;
+uint32_t LoopMonitor::_stageStartUs = 0;
+uint8_t LoopMonitor::_watchdogStage = LoopMonitor::NO_STAGE;
+bool LoopMonitor::_watchdogActive = false;
+
+static const char* const STAGE_NAMES[LOOP_STAGE_COUNT + 1] = {
+    "ble", "input", "button", "timers", "alarm", "test_sound", "serial", "clock", "display", "total"
+};
+
+// Stages that may refresh the e-ink panel get the longer budget
+static const uint16_t STAGE_BUDGET_MS[LOOP_STAGE_COUNT] = {
+    LOOP_STAGE_BUDGET_MS,    // ble
+    LOOP_STAGE_BUDGET_MS,    // input
+    LOOP_STAGE_BUDGET_MS,    // button
+    LOOP_STAGE_BUDGET_MS,    // timers
+    LOOP_DISPLAY_BUDGET_MS,  // alarm (ringing screen)
+    LOOP_STAGE_BUDGET_MS,    // test_sound
+    LOOP_STAGE_BUDGET_MS,    // serial
+    LOOP_STAGE_BUDGET_MS,    // clock
+    LOOP_DISPLAY_BUDGET_MS,  // display
+};
+
+static Counter loopStalls("loop.stalls");
+static Gauge loopMax("loop.max_ms", []() -> int32_t {
+    return LoopMonitor::stats(LoopMonitor::TOTAL).maxUs / 1000;
+});
+
+// ============================================
+// Reset-Surviving Stage Record
+// ============================================
+// The stage in progress, updated at every stage boundary. RTC_NOINIT
+// memory keeps it through the watchdog reset that ends a hang.
+#define LOOP_RTC_MAGIC 0x4C4F4F50  // "LOOP"
+
+struct RtcLoopRecord {
+    uint32_t magic;
+    uint32_t stage;  // LOOP_STAGE_COUNT: between iterations
+};
+
+RTC_NOINIT_ATTR static RtcLoopRecord rtcLoopRecord;
+
+void LoopMonitor::begin() {
+    const RtcLoopRecord& record = rtcLoopRecord;
+    if (esp_reset_reason() == ESP_RST_TASK_WDT && record.magic == LOOP_RTC_MAGIC &&
+        record.stage <= LOOP_STAGE_COUNT) {
+        _watchdogStage = record.stage;
+        LOG_E(MAIN, "LoopMonitor: Task watchdog reset, loop() was stuck in %s",
+              record.stage < LOOP_STAGE_COUNT ? STAGE_NAMES[record.stage] : "(between iterations)");
+    } else {
+        _watchdogStage = NO_STAGE;
+    }
+    rtcLoopRecord.magic = LOOP_RTC_MAGIC;
+    rtcLoopRecord.stage = LOOP_STAGE_COUNT;
+
+    // Only subscribes this task: the timeout and panic setting are shared
+    // with every watched task (the idle tasks), so they stay as configured
+    esp_err_t err = esp_task_wdt_add(NULL);
+    _watchdogActive = (err == ESP_OK);
+    if (_watchdogActive) {
+        LOG_I(MAIN, "LoopMonitor: loop() watched by the task watchdog (%u s)", CONFIG_ESP_TASK_WDT_TIMEOUT_S);
+    } else {
+        LOG_W(MAIN, "LoopMonitor: Task watchdog unavailable (%d)", err);
+    }
+}
+
+void LoopMonitor::beginIteration() {
+    if (_watchdogActive) {
+        esp_task_wdt_reset();
+    }
+    _iterationStartUs = micros();
+    _stageStartUs = _iterationStartUs;
+    rtcLoopRecord.stage = 0;
+}
+
+void LoopMonitor::endStage(LoopStage stage) {
+    uint32_t now = micros();
+    uint32_t us = now - _stageStartUs;
+    _stageStartUs = now;
+    rtcLoopRecord.stage = stage + 1;
+    record(stage, us);
+
+    StageStats& stats = _stats[stage];
+    if (us > (uint32_t)STAGE_BUDGET_MS[stage] * 1000) {
+        stats.stalls++;
+        loopStalls.add();
+
+        uint32_t nowMs = millis();
+        if (stats.lastLogMs == 0 || nowMs - stats.lastLogMs >= LOOP_STALL_LOG_INTERVAL_MS) {
+            LOG_W(MAIN, "LoopMonitor: %s stalled loop() for %u ms (budget %u ms, %u similar not logged)",
+                  STAGE_NAMES[stage], us / 1000, STAGE_BUDGET_MS[stage], stats.suppressed);
+            stats.lastLogMs = nowMs ? nowMs : 1;
+            stats.suppressed = 0;
+        } else {
+            stats.suppressed++;
+        }
+    }
+}
+
+void LoopMonitor::endIteration() {
+    uint32_t us = micros() - _iterationStartUs;
+    rtcLoopRecord.stage = LOOP_STAGE_COUNT;
+    record(TOTAL, us);
+
+    // Half the watchdog timeout means the next such stall may reset the board
+    if (_watchdogActive && us / 1000 >= CONFIG_ESP_TASK_WDT_TIMEOUT_S * 500) {
+        LOG_E(MAIN, "LoopMonitor: loop() took %u ms, over half the watchdog timeout", us / 1000);
+    }
+}
+
+void LoopMonitor::record(uint8_t index, uint32_t us) {
+    StageStats& stats = _stats[index];
+    stats.count++;
+    if (us > stats.maxUs) {
+        stats.maxUs = us;
+    }
+
+    uint8_t bucket = 0;
+    uint32_t bound = FIRST_BOUND_US;
+    while (us >= bound && bucket < BUCKETS - 1) {
+        bound <<= 1;
+        bucket++;
+    }
+    stats.buckets[bucket]++;
+}
+
+void LoopMonitor::reset() {
+    memset(_stats, 0, sizeof(_stats));
+}
+
+const char* LoopMonitor::stageName(uint8_t index) {
+    return index <= LOOP_STAGE_COUNT ? STAGE_NAMES[index] : "?";
+}
+
+uint32_t LoopMonitor::percentileUs(const StageStats& stats, uint8_t pct) {
+    if (stats.count == 0) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(((uint64_t)stats.count * pct + 99) / 100);  // Rank, rounded up
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+        seen += stats.buckets[bucket];
+        if (seen >= target) {
+            uint32_t bound = FIRST_BOUND_US << bucket;
+            return bound < stats.maxUs ? bound : stats.maxUs;
+        }
+    }
+    return stats.maxUs;  // Overflow bucket
+}
+
+void LoopMonitor::printReport() {
+    Serial.println("LoopMonitor: loop() latency by stage (ms; p50/p99 are bucket upper bounds)");
+    Serial.println("  stage          count      p50      p99      max  stalls  budget");
+    for (uint8_t i = 0; i <= LOOP_STAGE_COUNT; i++) {
+        const StageStats& stats = _stats[i];
+        Serial.printf("  %-10s %9u %8.1f %8.1f %8.1f  %6u", STAGE_NAMES[i], stats.count,
+                      percentileUs(stats, 50) / 1000.0f, percentileUs(stats, 99) / 1000.0f,
+                      stats.maxUs / 1000.0f, stats.stalls);
+        if (i < LOOP_STAGE_COUNT) {
+            Serial.printf("  %6u\n", STAGE_BUDGET_MS[i]);
+        } else {
+            Serial.println();
+        }
+    }
+    Serial.printf("LoopMonitor: Task watchdog %s (%u s)", _watchdogActive ? "on" : "off",
+                  CONFIG_ESP_TASK_WDT_TIMEOUT_S);
+    if (_watchdogStage != NO_STAGE) {
+        Serial.printf(", last reset by it in stage %s",
+                      _watchdogStage < LOOP_STAGE_COUNT ? STAGE_NAMES[_watchdogStage] : "(between iterations)");
+    }
+    Serial.println();
+}
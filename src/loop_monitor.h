@@ -0,0 +1,98 @@
+#ifndef LOOP_MONITOR_H
+#define LOOP_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Stages of loop(), in the order they run
+ */
+enum LoopStage : uint8_t {
+    LOOP_STAGE_BLE,         // bleSync.update()
+    LOOP_STAGE_INPUT,       // Button debouncing, status indicators
+    LOOP_STAGE_BUTTON,      // Button sounds, snooze and dismiss
+    LOOP_STAGE_TIMERS,      // Timer wheel, frontlight fades, settings commits, BLE time sync
+    LOOP_STAGE_ALARM,       // Alarm audio and the ringing screen
+    LOOP_STAGE_TEST_SOUND,  // Test sounds queued over BLE
+    LOOP_STAGE_SERIAL,      // Serial commands
+    LOOP_STAGE_CLOCK,       // Alarm checks, profiles, sunrise
+    LOOP_STAGE_DISPLAY,     // Clock redraw
+    LOOP_STAGE_COUNT
+};
+
+/**
+ * LoopMonitor - Times every loop() iteration and each of its stages
+ *
+ * loop() calls beginIteration(), endStage() after each stage and
+ * endIteration() before its idle delay. Per stage (and for the whole
+ * iteration) the monitor keeps the count, maximum and a log2 histogram
+ * of durations for percentiles. A stage over its budget is counted as a
+ * stall and logged with its name (rate limited per stage).
+ *
+ * loop() is also subscribed to the task watchdog, whose timeout and
+ * panic setting come from the framework's sdkconfig. The stage in progress
+ * is kept in RTC memory, so if the watchdog resets the board, begin()
+ * reports which stage hung. Only the loop task may call these methods.
+ */
+class LoopMonitor {
+public:
+    static const uint8_t BUCKETS = 16;
+    static const uint32_t FIRST_BOUND_US = 128;  // Bucket b holds durations below FIRST_BOUND_US << b
+    static const uint8_t TOTAL = LOOP_STAGE_COUNT;  // Stats index of whole iterations
+    static const uint8_t NO_STAGE = 0xFF;
+
+    struct StageStats {
+        uint32_t count;
+        uint32_t maxUs;
+        uint32_t stalls;
+        uint32_t buckets[BUCKETS];
+        uint32_t lastLogMs;   // Last stall warning
+        uint32_t suppressed;  // Stall warnings skipped since then
+    };
+
+    /**
+     * Report a watchdog reset of loop() and subscribe the calling task
+     * (the loop task, from setup()) to the task watchdog
+     */
+    static void begin();
+
+    static void beginIteration();
+    static void endStage(LoopStage stage);
+    static void endIteration();
+
+    /**
+     * Clear all statistics (the "loop reset" serial command)
+     */
+    static void reset();
+
+    /**
+     * Print max, p50 and p99 per stage (the "loop" serial command)
+     */
+    static void printReport();
+
+    static const StageStats& stats(uint8_t index) { return _stats[index]; }
+    static const char* stageName(uint8_t index);
+
+    /**
+     * @return Upper bound of the pct-th percentile duration (capped at the maximum)
+     */
+    static uint32_t percentileUs(const StageStats& stats, uint8_t pct);
+
+    /**
+     * @return Stage that was running when the watchdog last reset the
+     *         board (LOOP_STAGE_COUNT: between iterations), or NO_STAGE
+     *         if the last reset was not a watchdog reset
+     */
+    static uint8_t watchdogStage() { return _watchdogStage; }
+
+private:
+    static StageStats _stats[LOOP_STAGE_COUNT + 1];
+    static uint32_t _iterationStartUs;
+    static uint32_t _stageStartUs;
+    static uint8_t _watchdogStage;
+    static bool _watchdogActive;
+
+    static void record(uint8_t index, uint32_t us);
+};
+
+#endif // LOOP_MONITOR_H
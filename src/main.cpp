@@ -1,6 +1,7 @@
 #include <Arduino.h>
-#include <Preferences.h>
 #include "config.h"
+#include "board_profile.h"
+#include "settings_store.h"
 #include "time_manager.h"
 #include "display_manager.h"
 #include "ble_time_sync.h"
@@ -9,24 +10,34 @@
 #include "audio_test.h"
 #include "file_manager.h"
 #include "frontlight_manager.h"
+#include "timer_wheel.h"
+#include "profile_scheduler.h"
+#include "boot_timeline.h"
+#include "log.h"
+#include "loop_monitor.h"
+#include "metrics.h"
+#include "trace.h"
+#include "task_monitor.h"
+#include <freertos/event_groups.h>
 
 // ============================================
 // Global Objects
 // ============================================
+SettingsStore settings;
 TimeManager timeManager;
 DisplayManager displayManager;
 BLETimeSync bleSync;
 AlarmManager alarmManager;
-Button button(BUTTON_PIN, 1);  // 1ms debounce for better sensitivity
+Button button(Board::PINS.button, 1);  // 1ms debounce for better sensitivity
 AudioTest audioObj;
 FileManager fileManager;
 FrontlightManager frontlightManager;
+ProfileScheduler profiles;
 
 // ============================================
 // Button Sound State
 // ============================================
-String buttonSoundFile = "";  // Filename of button press sound (empty = disabled)
-String buttonSoundPath = "";  // Full path to button sound file (cached for performance)
+SoundName buttonSoundFile;  // Filename of button press sound (empty = disabled)
 uint8_t savedBrightnessBeforeAlarm = 255;  // Saved brightness before alarm boost (255 = not set)
 
 // Button sound PCM buffer (for instant playback of preloaded WAV files)
@@ -36,161 +47,82 @@ uint32_t buttonSoundSampleRate = 44100;   // Sample rate
 uint8_t buttonSoundBits = 16;             // Bits per sample (8 or 16)
 uint8_t buttonSoundChannels = 2;          // Channels (1=mono, 2=stereo)
 
+// Minutes until the next alarm, updated by loop() for the storage maintenance task
+volatile uint16_t minutesUntilAlarm = AlarmManager::NO_ALARM_DUE;
+
 // ============================================
-// WAV File Parsing Structures
+// Alarm Control Timers
 // ============================================
-struct WAVHeader {
-    // RIFF chunk
-    char riffID[4];       // "RIFF"
-    uint32_t riffSize;    // File size - 8
-    char waveID[4];       // "WAVE"
-
-    // fmt chunk
-    char fmtID[4];        // "fmt "
-    uint32_t fmtSize;     // fmt chunk size (16 for PCM)
-    uint16_t audioFormat; // Audio format (1 = PCM)
-    uint16_t numChannels; // Number of channels
-    uint32_t sampleRate;  // Sample rate
-    uint32_t byteRate;    // Byte rate
-    uint16_t blockAlign;  // Block align
-    uint16_t bitsPerSample; // Bits per sample
-
-    // data chunk
-    char dataID[4];       // "data"
-    uint32_t dataSize;    // Size of PCM data
-};
-
-/**
- * Parse WAV file header and extract PCM parameters
- * Returns true if valid WAV file, false otherwise
- */
-bool parseWAVHeader(File& file, uint32_t& sampleRate, uint8_t& bits, uint8_t& channels, size_t& pcmDataSize, size_t& pcmDataOffset) {
-    // Read RIFF header
-    char riffID[4];
-    file.read((uint8_t*)riffID, 4);
-    if (memcmp(riffID, "RIFF", 4) != 0) {
-        Serial.println("ERROR: Not a RIFF file");
-        return false;
-    }
-
-    file.read((uint8_t*)&pcmDataSize, 4);  // File size (not used)
-
-    char waveID[4];
-    file.read((uint8_t*)waveID, 4);
-    if (memcmp(waveID, "WAVE", 4) != 0) {
-        Serial.println("ERROR: Not a WAVE file");
-        return false;
-    }
-
-    // Find fmt chunk
-    char chunkID[4];
-    uint32_t chunkSize;
-    bool foundFmt = false;
-
-    while (file.available()) {
-        file.read((uint8_t*)chunkID, 4);
-        file.read((uint8_t*)&chunkSize, 4);
-
-        if (memcmp(chunkID, "fmt ", 4) == 0) {
-            foundFmt = true;
-
-            // Read fmt chunk data
-            uint16_t audioFormat;
-            file.read((uint8_t*)&audioFormat, 2);
-            if (audioFormat != 1) {
-                Serial.printf("ERROR: Unsupported audio format: %d (only PCM supported)\n", audioFormat);
-                return false;
-            }
-
-            uint16_t numChannels;
-            file.read((uint8_t*)&numChannels, 2);
-            channels = (uint8_t)numChannels;
-
-            file.read((uint8_t*)&sampleRate, 4);
-
-            uint32_t byteRate;
-            file.read((uint8_t*)&byteRate, 4);
-
-            uint16_t blockAlign;
-            file.read((uint8_t*)&blockAlign, 2);
-
-            uint16_t bitsPerSample;
-            file.read((uint8_t*)&bitsPerSample, 2);
-            bits = (uint8_t)bitsPerSample;
-
-            // Skip any extra fmt bytes
-            if (chunkSize > 16) {
-                file.seek(file.position() + (chunkSize - 16));
-            }
-
-            break;
-        } else {
-            // Skip this chunk
-            file.seek(file.position() + chunkSize);
-        }
-    }
+TimerWheel timers;                    // Polled from loop()
+TimerHandle snoozeDecisionTimer = 0;  // Pending single press (snooze unless a second click comes)
+TimerHandle toneBurstTimer = 0;       // Built-in tone bursts while an alarm rings
+uint8_t alarmStartVolume = 0;         // Volume captured when the alarm started
 
-    if (!foundFmt) {
-        Serial.println("ERROR: fmt chunk not found");
-        return false;
-    }
+// ============================================
+// Runtime Metrics
+// ============================================
+// System gauges are read only when a snapshot is taken ("stats" or BLE)
+TaskHandle_t loopTaskHandle = NULL;
+TaskHandle_t audioTaskHandle = NULL;
+TaskHandle_t storageTaskHandle = NULL;  // Cleared if the task exits
 
-    // Find data chunk
-    while (file.available()) {
-        file.read((uint8_t*)chunkID, 4);
-        file.read((uint8_t*)&chunkSize, 4);
+static int32_t stackFree(TaskHandle_t task) {
+    return task ? (int32_t)uxTaskGetStackHighWaterMark(task) : -1;
+}
 
-        if (memcmp(chunkID, "data", 4) == 0) {
-            pcmDataSize = chunkSize;
-            pcmDataOffset = file.position();
+static Gauge uptime("uptime_s", []() -> int32_t { return millis() / 1000; });
+static Gauge heapFree("heap.free", []() -> int32_t { return ESP.getFreeHeap(); });
+static Gauge heapMinFree("heap.min_free", []() -> int32_t { return ESP.getMinFreeHeap(); });
+static Gauge heapLargest("heap.largest_block", []() -> int32_t { return ESP.getMaxAllocHeap(); });
+static Gauge heapFragmentation("heap.frag_pct", []() -> int32_t {
+    // Share of free heap not usable by the largest single allocation
+    uint32_t free = ESP.getFreeHeap();
+    return free ? 100 - (int32_t)((uint64_t)ESP.getMaxAllocHeap() * 100 / free) : 0;
+});
+static Gauge psramFree("psram.free", []() -> int32_t { return ESP.getFreePsram(); });
+static Gauge loopStack("stack.loop_free", []() -> int32_t { return stackFree(loopTaskHandle); });
+static Gauge audioStack("stack.audio_free", []() -> int32_t { return stackFree(audioTaskHandle); });
+static Gauge storageStack("stack.storage_free", []() -> int32_t { return stackFree(storageTaskHandle); });
+static Gauge logDropped("log.dropped", []() -> int32_t { return Log::getStats().dropped; });
+
+// loop() normally runs every ~10 ms; long periods are display refreshes or blocking work
+static const uint32_t LOOP_PERIOD_BOUNDS_MS[] = { 11, 15, 20, 50, 100, 500, 2000 };
+static Histogram loopPeriod("loop.period_ms", LOOP_PERIOD_BOUNDS_MS, 7);
 
-            Serial.printf("WAV: %dHz, %d-bit, %d-channel, %d bytes PCM\n",
-                         sampleRate, bits, channels, pcmDataSize);
-            return true;
-        } else {
-            // Skip this chunk
-            file.seek(file.position() + chunkSize);
-        }
-    }
-
-    Serial.println("ERROR: data chunk not found");
-    return false;
-}
+// ============================================
+// Button Sound Preloading
+// ============================================
 
 /**
- * Load WAV file into PSRAM buffer for instant playback
+ * Read a located WAV sound into a PSRAM buffer
  * Returns true if successful, false otherwise
  */
-bool loadButtonSoundWAV(const String& filePath) {
-    // Free any existing buffer
-    if (buttonSoundPCMBuffer != nullptr) {
-        free(buttonSoundPCMBuffer);
-        buttonSoundPCMBuffer = nullptr;
-        buttonSoundPCMSize = 0;
-    }
-
-    // Strip /spiffs prefix if present
-    String spiffsPath = filePath;
-    if (spiffsPath.startsWith("/spiffs")) {
-        spiffsPath = spiffsPath.substring(7);
-    }
-
-    // Open file
-    File file = SPIFFS.open(spiffsPath, "r");
+static bool readButtonSoundWAV(const char* soundName, const SoundLocation& sound) {
+    // Open file and seek to the sound (bank payload or loose file)
+    File file = SPIFFS.open(sound.path.c_str(), "r");
     if (!file) {
-        Serial.printf("ERROR: Could not open WAV file: %s\n", spiffsPath.c_str());
+        Serial.printf("ERROR: Could not open WAV file: %s\n", sound.path.c_str());
         return false;
     }
 
-    // Parse WAV header
-    uint32_t sampleRate;
-    uint8_t bits, channels;
-    size_t pcmDataSize, pcmDataOffset;
-
-    if (!parseWAVHeader(file, sampleRate, bits, channels, pcmDataSize, pcmDataOffset)) {
+    // Parse WAV header (bounded by the sound, which may sit inside the bank file)
+    WavFormat format;
+    WavResult result = SoundCatalog::parseWav(file, sound.offset, sound.length, format);
+    if (result != WAV_OK) {
+        Serial.printf("ERROR: %s: %s\n", soundName, WavParser::describe(result));
         file.close();
         return false;
     }
+    if (format.audioFormat != 1) {
+        Serial.printf("ERROR: Unsupported audio format: %d (only PCM supported)\n", format.audioFormat);
+        file.close();
+        return false;
+    }
+    uint32_t sampleRate = format.sampleRate;
+    uint8_t bits = format.bits;
+    uint8_t channels = format.channels;
+    size_t pcmDataSize = format.dataSize;
+    Serial.printf("WAV: %dHz, %d-bit, %d-channel, %d bytes PCM\n", sampleRate, bits, channels, pcmDataSize);
 
     // Validate parameters
     if (bits != 8 && bits != 16) {
@@ -222,7 +154,7 @@ bool loadButtonSoundWAV(const String& filePath) {
     }
 
     // Read PCM data into buffer
-    file.seek(pcmDataOffset);
+    file.seek(sound.offset + format.dataOffset);
     size_t bytesRead = file.read(buttonSoundPCMBuffer, pcmDataSize);
     file.close();
 
@@ -244,6 +176,28 @@ bool loadButtonSoundWAV(const String& filePath) {
     return true;
 }
 
+/**
+ * Load WAV file into PSRAM buffer for instant playback
+ * Returns true if successful, false otherwise
+ */
+bool loadButtonSoundWAV(const char* soundName) {
+    // Free any existing buffer
+    if (buttonSoundPCMBuffer != nullptr) {
+        free(buttonSoundPCMBuffer);
+        buttonSoundPCMBuffer = nullptr;
+        buttonSoundPCMSize = 0;
+    }
+
+    SoundLocation sound;
+    if (!fileManager.locateSound(soundName, sound)) {
+        Serial.printf("ERROR: WAV sound not found: %s\n", soundName);
+        return false;
+    }
+    bool loaded = readButtonSoundWAV(soundName, sound);
+    fileManager.unpinSound(sound);  // Compaction may move the payload again
+    return loaded;
+}
+
 // ============================================
 // FreeRTOS Audio Task
 // ============================================
@@ -258,57 +212,196 @@ void audioTask(void* pvParameters) {
 }
 
 // ============================================
-// Setup Function
+// Boot Tasks
 // ============================================
-void setup() {
-    // Initialize Serial communication
-    Serial.begin(SERIAL_BAUD);
-    delay(1000);
-
-    // Print startup banner
-    Serial.println("\n\n========================================");
-    Serial.println(PROJECT_NAME);
-    Serial.print("Version: ");
-    Serial.println(PROJECT_VERSION);
-    Serial.println("========================================");
-    Serial.println("Phase 2: BLE Time Sync Test");
-    Serial.println("========================================\n");
-
-    // Initialize TimeManager
-    Serial.println("Initializing TimeManager...");
-    if (timeManager.begin()) {
-        Serial.println("TimeManager initialized!");
+// Staged boot: setup() brings up clock and alarms, then draws the first
+// frame while BLE and storage initialize in these tasks
+EventGroupHandle_t bootEvents = NULL;
+#define BOOT_BLE_DONE      (1 << 0)  // BLE advertising (or failed)
+#define BOOT_STORAGE_DONE  (1 << 1)  // Storage mounted and file list published (or failed)
+
+void bleBootTask(void* pvParameters) {
+    TaskMonitor::watch(xTaskGetCurrentTaskHandle(), BLE_BOOT_TASK_STACK);  // Here, as the task exits
+    if (bleSync.begin(BLE_DEVICE_NAME)) {
+        bleSync.setTimeZoneValue(timeManager.getTimeZone());
+        BootTimeline::mark("ble_advertising");
     } else {
-        Serial.println("ERROR: Failed to initialize TimeManager!");
+        Serial.println("ERROR: Failed to initialize BLE Time Sync!");
     }
 
-    // Initialize DisplayManager
-    Serial.println("\nInitializing DisplayManager...");
-    if (displayManager.begin()) {
-        Serial.println("DisplayManager initialized!");
+    xEventGroupSetBits(bootEvents, BOOT_BLE_DONE);
+    TaskMonitor::taskExiting();
+    vTaskDelete(NULL);
+}
+
+// ============================================
+// FreeRTOS Storage Task
+// ============================================
+// Mounts SPIFFS at boot, then runs GC and sound bank compaction in idle
+// time so they don't happen inside an upload or while an alarm streams
+// from flash
+void storageTask(void* pvParameters) {
+    TaskMonitor::watch(xTaskGetCurrentTaskHandle(), STORAGE_TASK_STACK);
+    bool mounted = fileManager.begin();
+    if (mounted) {
+        BootTimeline::mark("storage_ready");
+
+        // Preload a WAV button sound into PSRAM for instant playback
+        if (buttonSoundFile.length() > 0 &&
+            SoundCatalog::codecFromName(buttonSoundFile.c_str()) == SOUND_CODEC_WAV &&
+            !loadButtonSoundWAV(buttonSoundFile.c_str())) {
+            Serial.println("WAV preloading failed - will use normal file playback");
+        }
     } else {
-        Serial.println("ERROR: Failed to initialize DisplayManager!");
+        Serial.println("ERROR: Failed to initialize FileManager!");
     }
 
-    // Initialize BLE Time Sync
-    Serial.println("\nInitializing BLE Time Sync...");
-    if (bleSync.begin(BLE_DEVICE_NAME)) {
-        Serial.println("BLE Time Sync initialized!");
-    } else {
-        Serial.println("ERROR: Failed to initialize BLE Time Sync!");
+    // The file list characteristic exists once BLE is up; publish it once
+    xEventGroupWaitBits(bootEvents, BOOT_BLE_DONE, pdFALSE, pdTRUE, portMAX_DELAY);
+    bleSync.updateFileList();
+    xEventGroupSetBits(bootEvents, BOOT_STORAGE_DONE);
+    BootTimeline::mark("boot_done");
+    BootTimeline::print();
+
+    while (mounted) {
+        vTaskDelay(pdMS_TO_TICKS(STORAGE_MAINT_INTERVAL_MS));
+
+        if (minutesUntilAlarm > STORAGE_MAINT_ALARM_GUARD_MIN &&
+            !bleSync.isFileTransferring() &&
+            audioObj.getCurrentSoundType() == SOUND_TYPE_NONE &&
+            !alarmManager.isAlarmRinging() && !alarmManager.isAlarmSnoozed()) {
+            fileManager.runMaintenance();
+        }
     }
+    storageTaskHandle = NULL;
+    TaskMonitor::taskExiting();
+    vTaskDelete(NULL);
+}
 
-    // Set BLE callback to update time
-    bleSync.setTimeSyncCallback([](time_t timestamp) {
-        timeManager.setTimestamp(timestamp);
-        Serial.println(">>> Time synchronized from BLE!");
-    });
+// ============================================
+// Alarm Timer Callbacks
+// ============================================
+// Single press with no second click inside the double-click window: snooze
+void confirmSnooze(void* arg) {
+    snoozeDecisionTimer = 0;
+
+    // Only execute if alarm is still ringing (not already dismissed)
+    if (alarmManager.isAlarmRinging()) {
+        alarmManager.snoozeAlarm();
+        audioObj.stop();
+        LOG_I(MAIN, "Alarm snoozed (single press confirmed after timeout), audio stopped");
+
+        // Restore brightness
+        if (savedBrightnessBeforeAlarm != 255) {
+            frontlightManager.setBrightnessTemporary(savedBrightnessBeforeAlarm, FRONTLIGHT_FADE_MS);
+            LOG_D(MAIN, "Alarm snoozed: brightness restored to %d%%", savedBrightnessBeforeAlarm);
+            savedBrightnessBeforeAlarm = 255;  // Reset to "not set"
+        }
+    }
+}
+
+// Apply a day/night profile as transient overrides (nothing is saved to NVS)
+void applyProfile(const DeviceProfile& profile) {
+    // The profile caps brightness, it never lights up a frontlight the user dimmed
+    uint8_t brightness = settings.getBrightness();
+    if (brightness > profile.brightnessMax) {
+        brightness = profile.brightnessMax;
+    }
 
-    // Initialize AlarmManager
-    Serial.println("\nInitializing AlarmManager...");
-    if (alarmManager.begin()) {
-        Serial.println("AlarmManager initialized!");
+    if (savedBrightnessBeforeAlarm != 255) {
+        // Alarm or sunrise owns the frontlight: restore to the new level afterwards
+        savedBrightnessBeforeAlarm = brightness;
     } else {
+        frontlightManager.setBrightnessTemporary(brightness, FRONTLIGHT_FADE_MS);
+    }
+
+    displayManager.setShowSeconds(profile.secondsRefresh);
+    Serial.printf(">>> PROFILE: %s (brightness %d%%, button sound max %d%%, %s refresh)\n",
+                  profile.name, brightness, profile.clickVolumeMax,
+                  profile.secondsRefresh ? "per-second" : "per-minute");
+}
+
+// Start the pre-alarm sunrise ramp inside its window, or restore brightness when
+// the upcoming alarm went away (disabled, deleted or moved) during the ramp
+void updateSunrise(int32_t minutesToAlarm, int second) {
+    if (alarmManager.isAlarmRinging() || alarmManager.isAlarmSnoozed()) {
+        return;  // The alarm owns the frontlight until snooze/dismiss restores it
+    }
+
+    bool inWindow = SUNRISE_DURATION_MIN > 0 &&
+                    minutesToAlarm > 0 && minutesToAlarm <= SUNRISE_DURATION_MIN &&
+                    timeManager.getConfidence() != TIME_CONFIDENCE_UNKNOWN;
+
+    if (frontlightManager.isSunriseActive()) {
+        if (!inWindow) {
+            frontlightManager.cancelSunrise();
+            if (savedBrightnessBeforeAlarm != 255) {
+                frontlightManager.setBrightnessTemporary(savedBrightnessBeforeAlarm, FRONTLIGHT_FADE_MS);
+                Serial.printf(">>> SUNRISE: Alarm no longer due, brightness restored to %d%%\n", savedBrightnessBeforeAlarm);
+            }
+            savedBrightnessBeforeAlarm = 255;
+        }
+        return;
+    }
+
+    if (savedBrightnessBeforeAlarm != 255) {
+        // Brightness was changed during the ramp: keep the user's setting
+        savedBrightnessBeforeAlarm = 255;
+        return;
+    }
+
+    if (inWindow && frontlightManager.getBrightness() < SUNRISE_TARGET_PERCENT) {
+        savedBrightnessBeforeAlarm = frontlightManager.getBrightness();
+        frontlightManager.startSunrise(SUNRISE_TARGET_PERCENT, (uint32_t)(minutesToAlarm * 60 - second) * 1000);
+        Serial.printf(">>> SUNRISE: Alarm in %ld min, ramping from %d%%\n", (long)minutesToAlarm, savedBrightnessBeforeAlarm);
+    }
+}
+
+// Restart a built-in tone burst every ALARM_TONE_BURST_MS (file alarms loop by themselves)
+void playToneBurst(void* arg) {
+    if (!alarmManager.isAlarmRinging()) {
+        return;
+    }
+
+    uint8_t alarmId = alarmManager.getRingingAlarmId();
+    AlarmData alarm;
+    if (alarmManager.getAlarm(alarmId, alarm)) {
+        // Only play bursts for built-in tones (file playback handles looping)
+        if (alarm.sound == "tone1" || alarm.sound == "tone2" || alarm.sound == "tone3") {
+            // Use distinct frequencies: low (262), middle (440), high (880)
+            uint16_t frequency = (alarm.sound == "tone2") ? 440 :
+                               (alarm.sound == "tone3") ? 880 : 262;
+
+            // 50ms burst at the volume captured when the alarm started; the
+            // saved volume setting is not touched
+            audioObj.playTone(frequency, 50, alarmStartVolume);
+        }
+    }
+}
+
+// ============================================
+// Setup Function
+// ============================================
+void setup() {
+    BootTimeline::mark("setup");
+    Serial.begin(SERIAL_BAUD);
+    Serial.printf("\n\n%s v%s\n", PROJECT_NAME, PROJECT_VERSION);
+    Log::begin();
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+#ifdef CONFIG_ARDUINO_LOOP_STACK_SIZE
+    TaskMonitor::watch(loopTaskHandle, CONFIG_ARDUINO_LOOP_STACK_SIZE);
+#endif
+
+    // ---- Stage 1: clock and alarm state (everything an alarm needs to ring) ----
+
+    // Load user settings first; the managers below read them in begin()
+    settings.begin();
+
+    if (!timeManager.begin()) {
+        Serial.println("ERROR: Failed to initialize TimeManager!");
+    }
+
+    if (!alarmManager.begin()) {
         Serial.println("ERROR: Failed to initialize AlarmManager!");
     }
 
@@ -319,12 +412,13 @@ void setup() {
         Serial.println(" is ringing!");
 
         // Boost brightness to 100% during alarm (temporarily, without saving to NVS)
-        // Only save brightness if not already saved (prevents overwriting with boosted value)
+        // Only save brightness if not already saved (prevents overwriting with boosted value,
+        // or with the sunrise level when the ramp already saved it)
         if (savedBrightnessBeforeAlarm == 255) {
             savedBrightnessBeforeAlarm = frontlightManager.getBrightness();
             Serial.printf(">>> ALARM: Saved current brightness: %d%%\n", savedBrightnessBeforeAlarm);
         }
-        frontlightManager.setBrightnessTemporary(100);
+        frontlightManager.setBrightnessTemporary(100, FRONTLIGHT_FADE_MS);
         Serial.printf(">>> ALARM: Brightness boosted to 100%%\n");
 
         // Get alarm data to determine which sound to play
@@ -349,10 +443,10 @@ void setup() {
                 Serial.println(" Hz (50ms burst)");
             } else {
                 // Try to play custom sound file from SPIFFS
-                String filePath = String(ALARM_SOUNDS_DIR) + "/" + alarm.sound;
-                if (fileManager.fileExists(filePath)) {
+                SoundLocation sound;
+                if (fileManager.locateSound(alarm.sound.c_str(), sound)) {
                     Serial.printf(">>> AUDIO: Playing custom sound file: %s\n", alarm.sound.c_str());
-                    audioObj.playFile(filePath, true);  // Loop continuously
+                    audioObj.playFile(sound, true);  // Loop continuously
                     // Give audio task 100ms to prime the decoder
                     delay(100);
                     Serial.println(">>> AUDIO: File playback started, audio task priming decoder");
@@ -365,139 +459,117 @@ void setup() {
         }
     });
 
-    // Initialize Button
-    Serial.println("\nInitializing Button...");
     button.begin();
-    Serial.println("Button initialized!");
 
-    // Initialize Audio
-    Serial.println("\nInitializing Audio...");
     if (audioObj.begin()) {
-        Serial.println("Audio initialized!");
-
         // Create dedicated FreeRTOS task for continuous MP3 decoding
-        // Task name: "AudioTask", Stack: 8KB, Priority: 2 (higher than idle)
+        // Task name: "AudioTask", Stack: AUDIO_TASK_STACK, Priority: 2 (higher than idle)
         xTaskCreate(
             audioTask,      // Task function
             "AudioTask",    // Task name (for debugging)
-            8192,           // Stack size (8KB) - increased from 4KB to prevent stack overflow
+            AUDIO_TASK_STACK,  // Stack size (see "tasks" for measured use)
             NULL,           // Task parameters (none)
             2,              // Priority (2 = above normal, below critical tasks)
-            NULL            // Task handle (not needed)
+            &audioTaskHandle  // Task handle (stack metric)
         );
-        Serial.println("Audio task created!");
+        TaskMonitor::watch(audioTaskHandle, AUDIO_TASK_STACK);
     } else {
         Serial.println("ERROR: Failed to initialize Audio!");
     }
 
-    // Initialize FileManager (for custom alarm sounds)
-    Serial.println("\nInitializing FileManager (SPIFFS)...");
-    if (fileManager.begin()) {
-        Serial.println("FileManager initialized!");
-        // List available sound files
-        std::vector<String> sounds = fileManager.listSounds();
-        if (sounds.size() > 0) {
-            Serial.printf("Found %d custom sound file(s):\n", sounds.size());
-            for (const String& sound : sounds) {
-                Serial.printf("  - %s\n", sound.c_str());
-            }
-        } else {
-            Serial.println("No custom sound files found (upload via PlatformIO)");
-        }
-
-        // Update BLE file list now that FileManager is ready
-        Serial.println("\nUpdating BLE file list...");
-        bleSync.updateFileList();
-    } else {
-        Serial.println("ERROR: Failed to initialize FileManager!");
+    if (!frontlightManager.begin()) {
+        Serial.println("ERROR: Failed to initialize FrontlightManager!");
     }
 
-    // Initialize FrontlightManager (PWM control for e-ink frontlight)
-    Serial.println("\nInitializing FrontlightManager...");
-    if (frontlightManager.begin()) {
-        Serial.println("FrontlightManager initialized!");
+    // WAV button sounds are preloaded by the storage task once SPIFFS is mounted
+    settings.getButtonSound(buttonSoundFile);
+    BootTimeline::mark("alarms_ready");
+
+    // ---- Stage 2: BLE and storage come up in their own tasks ----
+
+    // BLE time and zone writes run on the BLE task; loop() applies them
+    // (TimeManager::applyPending()) so the clock never sees a half-built zone
+    bleSync.setTimeSyncCallback([](time_t timestamp) {
+        timeManager.postTimestamp(timestamp);
+    });
+    bleSync.setTimeZoneCallback([](const char* tz) {
+        timeManager.postTimeZone(tz);
+    });
+
+    bootEvents = xEventGroupCreate();
+    xTaskCreate(bleBootTask, "BleBootTask", BLE_BOOT_TASK_STACK, NULL, 2, NULL);
+    xTaskCreate(storageTask, "StorageTask", STORAGE_TASK_STACK, NULL, 1, &storageTaskHandle);
+
+    // ---- Stage 3: first clock frame, drawn while BLE and storage initialize ----
+
+    if (displayManager.begin()) {
+        displayManager.setBLEStatus(false);     // Will update when connected
+        displayManager.setTimeConfidence(timeManager.getConfidence());  // Restored or unknown
+
+        const TimeSnapshot& bootTime = timeManager.snapshot();
+        displayManager.showClock(bootTime.time12, bootTime.date, bootTime.dayName, bootTime.tm.tm_sec);
+        BootTimeline::mark("first_frame");
     } else {
-        Serial.println("ERROR: Failed to initialize FrontlightManager!");
+        Serial.println("ERROR: Failed to initialize DisplayManager!");
     }
 
-    // Load button sound from NVS
-    Serial.println("\nLoading button sound setting from NVS...");
-    Preferences buttonPrefs;
-    buttonPrefs.begin("button", true);  // Read-only
-    buttonSoundFile = buttonPrefs.getString("sound", "");
-    buttonPrefs.end();
-    if (buttonSoundFile.length() > 0) {
-        // Cache the full path for fast playback (avoid file system checks in hot path)
-        buttonSoundPath = String(ALARM_SOUNDS_DIR) + "/" + buttonSoundFile;
-        Serial.printf("Button sound loaded: %s\n", buttonSoundFile.c_str());
-
-        // Check if it's a WAV file - preload into PSRAM for instant playback
-        String lowerPath = buttonSoundFile;
-        lowerPath.toLowerCase();
-        if (lowerPath.endsWith(".wav")) {
-            Serial.println("Preloading WAV file into PSRAM for instant playback...");
-            if (loadButtonSoundWAV(buttonSoundPath)) {
-                Serial.println("WAV preloading successful!");
-            } else {
-                Serial.println("WAV preloading failed - will use normal file playback");
+    // Stack and heap watermarks ("tasks" prints the sizing report)
+    timers.schedule(TASK_MONITOR_INTERVAL_MS, [](void*) { TaskMonitor::sample(); },
+                    nullptr, TASK_MONITOR_INTERVAL_MS);
+
+    // Stage latency and the task watchdog on loop() ("loop" prints the report)
+    LoopMonitor::begin();
+
+    Serial.println("READY - set the time over BLE (DateTime: YYYY-MM-DD HH:MM:SS), 'help' for serial commands");
+}
+
+// ============================================
+// Serial Command Input
+// ============================================
+/**
+ * Collect serial input without blocking (readStringUntil() would hold
+ * loop() for up to a second waiting for the newline)
+ * @return true when line holds a complete, trimmed command; clear it after use
+ */
+static bool readSerialLine(StringBuilder& line) {
+    while (Serial.available()) {
+        char c = (char)Serial.read();
+        if (c == '\n') {
+            size_t length = line.length();
+            while (length > 0 && isspace((unsigned char)line.c_str()[length - 1])) {
+                length--;  // Trailing spaces and the \r of CRLF terminals
             }
-        } else if (lowerPath.endsWith(".mp3")) {
-            Serial.println("MP3 file - will use streaming playback (~2 second delay)");
+            line.truncate(length);
+            return true;
         }
-    } else {
-        buttonSoundPath = "";
-        Serial.println("Button sound: disabled (no sound set)");
-    }
-
-    // Set initial status indicators
-    displayManager.setBLEStatus(false);     // Will update when connected
-    displayManager.setTimeSyncStatus(false); // Not synced yet
-
-    // Display initial clock (will show default time)
-    Serial.println("\nDisplaying initial clock...");
-    uint8_t hour, minute, second;
-    timeManager.getTime(hour, minute, second);
-    displayManager.showClock(
-        timeManager.getTimeString(true),  // 12-hour format with AM/PM
-        timeManager.getDateString(),
-        timeManager.getDayOfWeekString(),
-        second
-    );
-
-    Serial.println("\n========================================");
-    Serial.println("READY - Waiting for BLE time sync!");
-    Serial.println("========================================");
-    Serial.println("Instructions:");
-    Serial.println("1. Open BLE app on your phone (LightBlue or nRF Connect)");
-    Serial.println("2. Scan for 'ESP32-L Alarm'");
-    Serial.println("3. Connect to the device");
-    Serial.println("4. Find 'DateTime' characteristic");
-    Serial.println("5. Write: YYYY-MM-DD HH:MM:SS");
-    Serial.println("   Example: 2026-01-14 15:30:00");
-    Serial.println("\nDisplay shows:");
-    Serial.println("  - BLE: --- (not connected)");
-    Serial.println("  - SYNC: ???? (not synced)");
-    Serial.println("\nAfter sync, will show:");
-    Serial.println("  - BLE: BLE (connected)");
-    Serial.println("  - SYNC: SYNC (synced)");
-    Serial.println("========================================\n");
+        if (!line.isEmpty() || !isspace((unsigned char)c)) {
+            line += c;  // Overlong commands are cut off (and reported)
+        }
+    }
+    return false;
 }
 
 // ============================================
 // Loop Function
 // ============================================
 void loop() {
-    static unsigned long lastUpdate = 0;
+    static time_t lastClockTick = 0;  // Snapshot epoch of the last clock update
+    static uint32_t lastLoopMs = 0;
     static bool lastBLEStatus = false;
-    static unsigned long lastToneStart = 0;  // Track when tone was started
     static bool wasRingingLastLoop = false;  // Track alarm state
     static bool displayUpdatedForAlarm = false;  // Track if alarm display shown
-    static unsigned long pendingSingleClickTime = 0;  // Track pending snooze
-    static uint8_t alarmStartVolume = 0;  // Capture volume when alarm starts
-    unsigned long now = millis();
+    static bool clockRedrawPending = false;  // Clock must replace another screen at the next update
+
+    uint32_t loopStartMs = millis();
+    if (lastLoopMs != 0) {
+        loopPeriod.record(loopStartMs - lastLoopMs);
+    }
+    lastLoopMs = loopStartMs;
+    LoopMonitor::beginIteration();
 
     // Update BLE
     bleSync.update();
+    LoopMonitor::endStage(LOOP_STAGE_BLE);
 
     // Update button
     button.update();
@@ -515,8 +587,8 @@ void loop() {
         }
     }
 
-    // Update time sync status
-    displayManager.setTimeSyncStatus(timeManager.isSynced());
+    // Update time confidence marker
+    displayManager.setTimeConfidence(timeManager.getConfidence());
 
     // Update alarm status display (replaces sync indicator)
     if (alarmManager.isAlarmSnoozed()) {
@@ -526,6 +598,7 @@ void loop() {
     } else {
         displayManager.setAlarmStatus("");
     }
+    LoopMonitor::endStage(LOOP_STAGE_INPUT);
 
     // Handle button presses for alarm control
     // Store button states to avoid consuming flags multiple times
@@ -534,7 +607,7 @@ void loop() {
 
     // Play button sound on any button press (if configured)
     // Each button press interrupts the previous sound
-    if ((buttonWasPressed || buttonWasDoubleClicked) && buttonSoundPath.length() > 0) {
+    if ((buttonWasPressed || buttonWasDoubleClicked) && buttonSoundFile.length() > 0) {
         // Stop any currently playing audio (PCM, tone, or file)
         audioObj.stop();
 
@@ -543,12 +616,17 @@ void loop() {
             // Instant playback from PSRAM (~10-30ms latency)
             // playPCMBuffer handles mutex synchronization and buffer clearing
             audioObj.playPCMBuffer(buttonSoundPCMBuffer, buttonSoundPCMSize,
-                                  buttonSoundSampleRate, buttonSoundBits, buttonSoundChannels);
-            Serial.printf(">>> BUTTON SOUND: Playing WAV from PSRAM (%d bytes)\n", buttonSoundPCMSize);
+                                  buttonSoundSampleRate, buttonSoundBits, buttonSoundChannels,
+                                  profiles.active().clickVolumeMax);
+            LOG_D(MAIN, "Button sound: Playing WAV from PSRAM (%u bytes)", buttonSoundPCMSize);
         } else {
             // Fall back to file playback (MP3 or WAV that failed to preload)
-            audioObj.playFile(buttonSoundPath, false);  // Non-looping
-            Serial.printf(">>> BUTTON SOUND: Playing file %s (streaming)\n", buttonSoundFile.c_str());
+            // Catalog lookup is a RAM hash probe, so resolve on each press
+            SoundLocation sound;
+            if (fileManager.locateSound(buttonSoundFile.c_str(), sound)) {
+                audioObj.playFile(sound, false, profiles.active().clickVolumeMax);  // Non-looping
+                LOG_D(MAIN, "Button sound: Playing file %s (streaming)", buttonSoundFile.c_str());
+            }
         }
     }
 
@@ -558,113 +636,86 @@ void loop() {
         if (alarmManager.isAlarmRinging() || alarmManager.isAlarmSnoozed()) {
             alarmManager.dismissAlarm();
             audioObj.stop();
-            lastToneStart = 0;
-            pendingSingleClickTime = 0;  // Cancel any pending snooze
-            Serial.println("\n>>> BUTTON: ===== ALARM DISMISSED (double-click) =====");
-            Serial.println(">>> AUDIO: Stopped");
+            timers.cancel(snoozeDecisionTimer);  // Cancel any pending snooze
+            LOG_I(MAIN, "Alarm dismissed (double-click), audio stopped");
 
             // Restore brightness
             if (savedBrightnessBeforeAlarm != 255) {
-                frontlightManager.setBrightness(savedBrightnessBeforeAlarm);
-                Serial.printf(">>> ALARM DISMISSED: Brightness restored to %d%%\n", savedBrightnessBeforeAlarm);
+                frontlightManager.setBrightnessTemporary(savedBrightnessBeforeAlarm, FRONTLIGHT_FADE_MS);
+                LOG_D(MAIN, "Alarm dismissed: brightness restored to %d%%", savedBrightnessBeforeAlarm);
                 savedBrightnessBeforeAlarm = 255;  // Reset to "not set"
             }
         }
     }
     else if (alarmManager.isAlarmRinging() && buttonWasPressed) {
-        // Single press detected - record time but DON'T execute snooze yet
-        // Wait 700ms to see if a second click comes (double-click)
-        pendingSingleClickTime = now;
-        Serial.println("\n>>> BUTTON: Single press detected - waiting for potential double-click...");
+        // Single press detected - DON'T execute snooze yet
+        // Wait out the double-click window to see if a second click comes
+        timers.cancel(snoozeDecisionTimer);
+        snoozeDecisionTimer = timers.schedule(button.getDoubleClickWindow(), confirmSnooze);
+        LOG_D(MAIN, "Single press - waiting for a possible double-click");
+    }
+    LoopMonitor::endStage(LOOP_STAGE_BUTTON);
+
+    // Pending snooze decision, tone bursts
+    timers.poll();
+    frontlightManager.update();
+    settings.update();
+
+    // Time and zone written over BLE
+    uint8_t timeUpdates = timeManager.applyPending();
+    if (timeUpdates & TIME_PENDING_TIMESTAMP) {
+        Serial.println(">>> Time synchronized from BLE!");
     }
-
-    // Execute pending snooze if 700ms has passed without a double-click
-    if (pendingSingleClickTime > 0 && (now - pendingSingleClickTime) >= 700) {
-        // Only execute if alarm is still ringing (not already dismissed)
-        if (alarmManager.isAlarmRinging()) {
-            alarmManager.snoozeAlarm();
-            audioObj.stop();
-            lastToneStart = 0;
-            Serial.println(">>> BUTTON: Alarm snoozed for 5 minutes (single press confirmed after timeout)");
-            Serial.println(">>> AUDIO: Stopped");
-
-            // Restore brightness
-            if (savedBrightnessBeforeAlarm != 255) {
-                frontlightManager.setBrightness(savedBrightnessBeforeAlarm);
-                Serial.printf(">>> ALARM SNOOZED: Brightness restored to %d%%\n", savedBrightnessBeforeAlarm);
-                savedBrightnessBeforeAlarm = 255;  // Reset to "not set"
-            }
-        }
-        pendingSingleClickTime = 0;  // Clear pending state
+    if (timeUpdates & TIME_PENDING_ZONE) {
+        bleSync.setTimeZoneValue(timeManager.getTimeZone());  // Characteristic shows the zone in effect
     }
+    LoopMonitor::endStage(LOOP_STAGE_TIMERS);
 
     // Handle alarm audio (runs every loop for responsiveness)
     if (alarmManager.isAlarmRinging()) {
         // If alarm just started, initialize timer and show alarm display
         if (!wasRingingLastLoop) {
             alarmStartVolume = audioObj.getVolume();  // Capture volume at alarm start
-            lastToneStart = 0;  // Force immediate play
+            toneBurstTimer = timers.schedule(0, playToneBurst, nullptr, ALARM_TONE_BURST_MS);  // First burst immediately
             wasRingingLastLoop = true;
             displayUpdatedForAlarm = false;  // Need to show alarm screen
 
             // Show alarm screen immediately (only once)
-            uint8_t hour, minute, second;
-            timeManager.getTime(hour, minute, second);
-            String timeStr = timeManager.getTimeString(true);
+            const TimeSnapshot& t = timeManager.snapshot();
 
             // Get alarm label and bottom row label to display
             uint8_t alarmId = alarmManager.getRingingAlarmId();
             AlarmData alarm;
-            String alarmLabel = "ALARM";  // Default fallback
-            String bottomRowLabel = "";    // Default empty (shows instructions)
+            const char* alarmLabel = "ALARM";  // Default fallback
+            const char* bottomRowLabel = "";    // Default empty (shows instructions)
             if (alarmManager.getAlarm(alarmId, alarm)) {
-                alarmLabel = alarm.label;
-                bottomRowLabel = alarm.bottomRowLabel;
+                alarmLabel = alarm.label.c_str();
+                bottomRowLabel = alarm.bottomRowLabel.c_str();
             }
 
-            displayManager.showAlarmRinging(timeStr, alarmLabel, bottomRowLabel);
+            displayManager.showAlarmRinging(t.time12, alarmLabel, bottomRowLabel);
             displayUpdatedForAlarm = true;
         }
-
-        // Play audio bursts for tone alarms (file alarms loop automatically)
-        if (now - lastToneStart >= 60) {  // Restart every 60ms
-            uint8_t alarmId = alarmManager.getRingingAlarmId();
-            AlarmData alarm;
-            if (alarmManager.getAlarm(alarmId, alarm)) {
-                // Only play bursts for built-in tones (file playback handles looping)
-                if (alarm.sound == "tone1" || alarm.sound == "tone2" || alarm.sound == "tone3") {
-                    // Temporarily set volume to what it was when alarm started
-                    uint8_t currentUserVolume = audioObj.getVolume();
-                    audioObj.setVolume(alarmStartVolume);
-
-                    // Use distinct frequencies: low (262), middle (440), high (880)
-                    uint16_t frequency = (alarm.sound == "tone2") ? 440 :
-                                       (alarm.sound == "tone3") ? 880 : 262;
-                    audioObj.playTone(frequency, 50);  // 50ms burst
-
-                    // Restore user's current volume setting
-                    audioObj.setVolume(currentUserVolume);
-                }
-                // For file playback, Audio library handles looping automatically
-            }
-            lastToneStart = now;
-        }
     } else {
         // Reset state when alarm stops
         if (wasRingingLastLoop) {
             wasRingingLastLoop = false;
-            lastToneStart = 0;
+            timers.cancel(toneBurstTimer);
             displayUpdatedForAlarm = false;
 
-            // Force display update to return to clock
-            lastUpdate = 0;
+            // Return to the clock now, not at the next minute under the night profile
+            lastClockTick = 0;
+            clockRedrawPending = true;
         }
     }
 
+    LoopMonitor::endStage(LOOP_STAGE_ALARM);
+
     // Handle test sound requests from BLE (queued to prevent stack overflow in BLE callback)
     if (bleSync.hasTestSoundRequest()) {
-        String soundFile = bleSync.getPendingTestSound();
-        Serial.printf(">>> MAIN: Processing test sound request: %s\n", soundFile.c_str());
+        SoundName soundFile;
+        bleSync.getPendingTestSound(soundFile);
+        LOG_D(MAIN, "Processing test sound request: %s", soundFile.c_str());
 
         // Stop any current playback first
         audioObj.stop();
@@ -673,35 +724,38 @@ void loop() {
         }
 
         // Play the test sound
-        String filePath = String(ALARM_SOUNDS_DIR) + "/" + soundFile;
-        if (fileManager.fileExists(filePath)) {
-            Serial.printf(">>> MAIN: Playing test file: %s\n", soundFile.c_str());
-            audioObj.playFile(filePath, false);  // Don't loop test sounds
+        SoundLocation sound;
+        if (fileManager.locateSound(soundFile.c_str(), sound)) {
+            LOG_I(MAIN, "Playing test file: %s", soundFile.c_str());
+            audioObj.playFile(sound, false);  // Don't loop test sounds
             // Give audio task 100ms to prime the decoder (task runs every 1ms)
             delay(100);
-            Serial.println(">>> MAIN: File playback started, audio task priming decoder");
+            LOG_D(MAIN, "File playback started, audio task priming decoder");
         } else {
-            Serial.printf(">>> MAIN: Test file not found: %s\n", soundFile.c_str());
+            LOG_W(MAIN, "Test file not found: %s", soundFile.c_str());
         }
     }
 
-    // Handle serial commands for debugging
-    if (Serial.available()) {
-        String command = Serial.readStringUntil('\n');
-        command.trim();
+    LoopMonitor::endStage(LOOP_STAGE_TEST_SOUND);
 
-        if (command.startsWith("b")) {
+    // Handle serial commands for debugging
+    static FixedString<SERIAL_COMMAND_MAX> command;
+    if (readSerialLine(command)) {
+        if (command.truncated()) {
+            Serial.printf(">>> SERIAL: ERROR - Command too long (max %d characters)\n", SERIAL_COMMAND_MAX);
+        // b<n>/v<n> need a digit so words like "boot" reach their own handlers
+        } else if (command.startsWith("b") && isDigit(command.c_str()[1])) {
             // Brightness command: b0 to b100
-            int brightness = command.substring(1).toInt();
+            int brightness = command.view().substring(1).toUInt();
             if (brightness >= 0 && brightness <= 100) {
                 frontlightManager.setBrightness(brightness);
                 Serial.printf(">>> SERIAL: Set brightness to %d%%\n", brightness);
             } else {
                 Serial.println(">>> SERIAL: ERROR - Brightness must be 0-100");
             }
-        } else if (command.startsWith("v")) {
+        } else if (command.startsWith("v") && isDigit(command.c_str()[1])) {
             // Volume command: v0 to v100
-            int volume = command.substring(1).toInt();
+            int volume = command.view().substring(1).toUInt();
             if (volume >= 0 && volume <= 100) {
                 audioObj.setVolume(volume);
                 Serial.printf(">>> SERIAL: Set volume to %d%%\n", volume);
@@ -710,55 +764,107 @@ void loop() {
             }
         } else if (command == "restart" || command == "r") {
             Serial.println(">>> SERIAL: Restarting ESP32...");
+            Log::flush();
             delay(500);
             ESP.restart();
+        } else if (command == "boot") {
+            BootTimeline::print();
+        } else if (command == "stats") {
+            Metrics::print();
+        } else if (command == "log") {
+            const LogStats& stats = Log::getStats();
+            Serial.printf("Log: %u written, %u dropped, peak %u/%d queued\n",
+                          stats.written, stats.dropped, stats.highWater, LOG_RING_RECORDS);
+            Serial.printf("Log: %u cycles per call on average, %u worst\n",
+                          stats.written ? stats.totalCycles / stats.written : 0, stats.maxCycles);
+        } else if (command == "tasks") {
+            TaskMonitor::printReport();
+        } else if (command == "loop") {
+            LoopMonitor::printReport();
+        } else if (command == "loop reset") {
+            LoopMonitor::reset();
+            Serial.println(">>> SERIAL: Loop statistics cleared");
+        } else if (command == "trace") {
+            Trace::printStatus();
+        } else if (command == "trace dump") {
+            Trace::dump();
+        } else if (command == "trace clear") {
+            Trace::clear();
+            Serial.println(">>> SERIAL: Trace cleared");
+        } else if (command == "trace on" || command == "trace off") {
+            Trace::setEnabled(command == "trace on");
+            Trace::printStatus();
         } else if (command == "help") {
             Serial.println(">>> SERIAL COMMANDS:");
             Serial.println("  b<0-100>  - Set brightness (e.g., b50 for 50%)");
             Serial.println("  v<0-100>  - Set volume (e.g., v75 for 75%)");
             Serial.println("  restart   - Restart ESP32 (clears BLE cache)");
+            Serial.println("  boot      - Show boot timeline");
+            Serial.println("  stats     - Show runtime metrics");
+            Serial.println("  log       - Show logging statistics");
+            Serial.println("  trace     - Trace status (trace dump|clear|on|off)");
+            Serial.println("  tasks     - Stack/heap watermarks and stack sizing report");
+            Serial.println("  loop      - loop() latency by stage, stalls, watchdog (loop reset)");
             Serial.println("  help      - Show this help message");
         }
+        command.clear();
     }
 
-    // Update display every second (only for normal clock, not alarm screen)
+    LoopMonitor::endStage(LOOP_STAGE_SERIAL);
+
+    // Update display when the second rolls over (only for normal clock, not alarm screen)
     // Skip display updates during file transfers to avoid blocking BLE
-    if (now - lastUpdate >= 1000 && !bleSync.isFileTransferring()) {
-        lastUpdate = now;
-
-        // Get current time
-        uint8_t hour, minute, second;
-        timeManager.getTime(hour, minute, second);
-        String timeStr = timeManager.getTimeString(true);  // 12-hour with AM/PM
-        String dateStr = timeManager.getDateString();
-        String dayStr = timeManager.getDayOfWeekString();
-
-        // Check alarms (gets day of week from tm struct)
-        struct tm timeinfo;
-        time_t now_t = time(nullptr);
-        localtime_r(&now_t, &timeinfo);
-        alarmManager.checkAlarms(hour, minute, timeinfo.tm_wday);
+    // The snapshot converts RTC time once per second and is shared by everything below
+    const TimeSnapshot& t = timeManager.snapshot();
+    if (t.epoch != lastClockTick && !bleSync.isFileTransferring()) {
+        lastClockTick = t.epoch;
+
+        // Check alarms (not while the clock could be arbitrarily wrong)
+        if (timeManager.getConfidence() != TIME_CONFIDENCE_UNKNOWN) {
+            alarmManager.checkAlarms(t.tm.tm_hour, t.tm.tm_min, t.tm.tm_wday);
+        }
+        if (t.changed & TIME_CHANGED_HOUR) {
+            timeManager.checkpoint();  // Power-loss fallback, rate limited internally
+        }
+        if (t.changed & TIME_CHANGED_MINUTE) {
+            int32_t minutes = alarmManager.minutesUntilNextAlarm(t.tm.tm_hour, t.tm.tm_min, t.tm.tm_wday);
+            if (minutes != AlarmManager::NO_ALARM_DUE) {
+                // Wall-clock minutes differ from elapsed minutes across a DST change
+                TimeZone& zone = timeManager.zone();
+                minutes -= (zone.offsetAt(t.epoch + minutes * 60) - zone.offsetAt(t.epoch)) / 60;
+                if (minutes < 0) minutes = 0;
+            }
+            minutesUntilAlarm = minutes;
+
+            if (profiles.update(t.tm.tm_hour * 60 + t.tm.tm_min)) {
+                applyProfile(profiles.active());
+            }
+            updateSunrise(minutes, t.tm.tm_sec);
+        }
+        LoopMonitor::endStage(LOOP_STAGE_CLOCK);
 
         // Force full refresh at 3 AM to prevent ghosting (once per day)
-        if (hour == 3 && minute == 0) {
+        if ((t.changed & TIME_CHANGED_MINUTE) && t.tm.tm_hour == 3 && t.tm.tm_min == 0) {
             displayManager.forceFullRefresh();
         }
 
         // Only update display if not showing alarm (alarm display updates once above)
-        if (!alarmManager.isAlarmRinging()) {
-            displayManager.showClock(timeStr, dateStr, dayStr, second);
+        // The night profile redraws once a minute instead of every second
+        if (!alarmManager.isAlarmRinging() &&
+            (clockRedrawPending || profiles.active().secondsRefresh || (t.changed & TIME_CHANGED_MINUTE))) {
+            displayManager.showClock(t.time12, t.date, t.dayName, t.tm.tm_sec);
+            clockRedrawPending = false;
         }
 
-        // Print to serial (for debugging)
-        Serial.print("Clock: ");
-        Serial.print(timeStr);
-        Serial.print(" | BLE: ");
-        Serial.print(bleConnected ? "Connected" : "---");
-        Serial.print(" | Sync: ");
-        Serial.print(timeManager.isSynced() ? "YES" : "NO");
-        Serial.print(" | Alarm: ");
-        Serial.println(alarmManager.isAlarmRinging() ? "RINGING" : "---");
+        // Status line (debug level; short words so all four fit in one log record)
+        LOG_D(MAIN, "Clock: %s | BLE: %s | Sync: %s | Alarm: %s",
+              t.time12,
+              bleConnected ? "Conn" : "---",
+              timeManager.isSynced() ? "YES" : (timeManager.getConfidence() == TIME_CONFIDENCE_ESTIMATED ? "EST" : "NO"),
+              alarmManager.isAlarmRinging() ? "RING" : "---");
     }
+    LoopMonitor::endStage(LOOP_STAGE_DISPLAY);
+    LoopMonitor::endIteration();
 
     // Audio decoding now handled by dedicated FreeRTOS task (audioTask)
     // No need to call audioObj.loop() here - task runs continuously
@@ -0,0 +1,138 @@
+#include "metrics.h"
+
+// Zero-initialized before any constructor runs, so metrics defined as
+// globals in other files can register during static initialization
+Metric* Metrics::_metrics[METRICS_MAX];
+uint8_t Metrics::_count = 0;
+uint8_t Metrics::_overflow = 0;
+
+static const uint8_t PAGE_HEADER_BYTES = 8;  // "nn/nn\n" plus slack
+static const size_t LINE_BYTES = 160;
+
+Metric::Metric(const char* name, MetricType type)
+    : _name(name),
+      _type(type) {
+    Metrics::add(this);
+}
+
+// ============================================
+// Histogram
+// ============================================
+
+Histogram::Histogram(const char* name, const uint32_t* bounds, uint8_t boundCount)
+    : Metric(name, METRIC_HISTOGRAM),
+      _bounds(bounds),
+      _boundCount(boundCount < METRICS_HISTOGRAM_BUCKETS ? boundCount : METRICS_HISTOGRAM_BUCKETS - 1),
+      _count(0),
+      _sum(0),
+      _max(0) {
+    for (uint8_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::record(uint32_t value) {
+    uint8_t i = 0;
+    while (i < _boundCount && value > _bounds[i]) {
+        i++;
+    }
+    _buckets[i].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint32_t seen = _max.load(std::memory_order_relaxed);
+    while (value > seen && !_max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+// ============================================
+// Registry
+// ============================================
+
+void Metrics::add(Metric* metric) {
+    if (_count < METRICS_MAX) {
+        _metrics[_count++] = metric;
+    } else {
+        _overflow++;
+    }
+}
+
+size_t Metrics::format(const Metric& metric, char* buffer, size_t size) {
+    int len = 0;
+    switch (metric.type()) {
+        case METRIC_COUNTER:
+            len = snprintf(buffer, size, "%s=%u", metric.name(), ((const Counter&)metric).value());
+            break;
+        case METRIC_GAUGE:
+            len = snprintf(buffer, size, "%s=%d", metric.name(), ((const Gauge&)metric).value());
+            break;
+        case METRIC_HISTOGRAM: {
+            const Histogram& h = (const Histogram&)metric;
+            uint32_t n = h.count();
+            len = snprintf(buffer, size, "%s n=%u avg=%u max=%u", metric.name(), n, n ? h.sum() / n : 0, h.max());
+            for (uint8_t i = 0; i < h.bucketCount() && len > 0 && (size_t)len < size; i++) {
+                if (i + 1 < h.bucketCount()) {
+                    len += snprintf(buffer + len, size - len, " le%u:%u", h.bound(i), h.bucket(i));
+                } else {
+                    len += snprintf(buffer + len, size - len, " inf:%u", h.bucket(i));
+                }
+            }
+            break;
+        }
+    }
+    if (len < 0) {
+        len = 0;
+    }
+    return ((size_t)len < size) ? (size_t)len : size - 1;
+}
+
+void Metrics::print() {
+    char line[LINE_BYTES];
+    Serial.printf("Metrics: %u registered", _count);
+    if (_overflow > 0) {
+        Serial.printf(" (%u dropped, raise METRICS_MAX)", _overflow);
+    }
+    Serial.println();
+    for (uint8_t i = 0; i < _count; i++) {
+        format(*_metrics[i], line, sizeof(line));
+        Serial.printf("  %s\n", line);
+    }
+}
+
+size_t Metrics::formatPage(uint8_t page, char* buffer) {
+    // Lines are packed greedily; a line longer than a page is truncated to fit
+    const size_t capacity = METRICS_PAGE_BYTES - PAGE_HEADER_BYTES;
+    char* body = buffer + PAGE_HEADER_BYTES;
+    char line[LINE_BYTES];
+    uint8_t current = 0;
+    size_t used = 0;
+    size_t bodyLen = 0;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        size_t len = format(*_metrics[i], line, sizeof(line));
+        if (len + 1 > capacity) {
+            len = capacity - 1;
+        }
+        if (used > 0 && used + len + 1 > capacity) {
+            current++;
+            used = 0;
+        }
+        if (current == page) {
+            memcpy(body + used, line, len);
+            body[used + len] = '\n';
+            bodyLen = used + len + 1;
+        }
+        used += len + 1;
+    }
+
+    uint8_t pages = current + 1;
+    char header[PAGE_HEADER_BYTES + 1];
+    int headerLen = snprintf(header, sizeof(header), "%u/%u\n", page, pages);
+    if (page >= pages) {
+        bodyLen = 0;
+    }
+    memmove(buffer + headerLen, body, bodyLen);
+    memcpy(buffer, header, headerLen);
+    buffer[headerLen + bodyLen] = '\0';
+    return headerLen + bodyLen;
+}
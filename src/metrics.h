@@ -0,0 +1,160 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * @brief Kind of a registered metric
+ */
+enum MetricType : uint8_t {
+    METRIC_COUNTER   = 0,
+    METRIC_GAUGE     = 1,
+    METRIC_HISTOGRAM = 2
+};
+
+/**
+ * @brief Base of all metrics; registers itself with Metrics on construction
+ *
+ * Metrics are meant to be global or static objects owned by the subsystem
+ * that updates them, so registration happens once at startup and updating
+ * a metric never allocates or locks.
+ */
+class Metric {
+public:
+    const char* name() const { return _name; }
+    MetricType type() const { return _type; }
+
+protected:
+    Metric(const char* name, MetricType type);
+
+private:
+    const char* _name;
+    MetricType _type;
+
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+};
+
+/**
+ * @brief Monotonic event count (wraps at 2^32)
+ */
+class Counter : public Metric {
+public:
+    explicit Counter(const char* name) : Metric(name, METRIC_COUNTER), _value(0) {}
+
+    void add(uint32_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> _value;
+};
+
+/**
+ * @brief Current level of something, either set by its owner or read on demand
+ *
+ * A reader function is only called when a snapshot is taken, which suits
+ * values that are cheap to query but pointless to track continuously
+ * (free heap, stack high-water marks).
+ */
+class Gauge : public Metric {
+public:
+    typedef int32_t (*Reader)();
+
+    explicit Gauge(const char* name, Reader reader = nullptr)
+        : Metric(name, METRIC_GAUGE), _reader(reader), _value(0) {}
+
+    void set(int32_t value) { _value.store(value, std::memory_order_relaxed); }
+    int32_t value() const { return _reader ? _reader() : _value.load(std::memory_order_relaxed); }
+
+private:
+    Reader _reader;
+    std::atomic<int32_t> _value;
+};
+
+/**
+ * @brief Distribution of samples over fixed buckets
+ *
+ * Bucket i counts samples <= bounds[i]; one more bucket counts samples
+ * above the last bound. Also keeps count, sum and maximum.
+ */
+class Histogram : public Metric {
+public:
+    /**
+     * @param name Metric name, including the unit (e.g. "loop.period_ms")
+     * @param bounds Ascending upper bounds (static array)
+     * @param boundCount Number of bounds (at most METRICS_HISTOGRAM_BUCKETS - 1)
+     */
+    Histogram(const char* name, const uint32_t* bounds, uint8_t boundCount);
+
+    /**
+     * Add a sample (safe from any task)
+     */
+    void record(uint32_t value);
+
+    uint8_t bucketCount() const { return _boundCount + 1; }
+    uint32_t bound(uint8_t bucket) const { return _bounds[bucket]; }
+    uint32_t bucket(uint8_t bucket) const { return _buckets[bucket].load(std::memory_order_relaxed); }
+    uint32_t count() const { return _count.load(std::memory_order_relaxed); }
+    uint32_t sum() const { return _sum.load(std::memory_order_relaxed); }
+    uint32_t max() const { return _max.load(std::memory_order_relaxed); }
+
+private:
+    const uint32_t* _bounds;
+    uint8_t _boundCount;
+    std::atomic<uint32_t> _buckets[METRICS_HISTOGRAM_BUCKETS];
+    std::atomic<uint32_t> _count;
+    std::atomic<uint32_t> _sum;
+    std::atomic<uint32_t> _max;
+};
+
+/**
+ * @brief Metrics - registry of every counter, gauge and histogram
+ *
+ * Snapshots are formatted one metric per line ("name=value", histograms
+ * as "name n=.. avg=.. max=.. le<bound>:<count> ... inf:<count>") for the
+ * "stats" serial command and, split into pages, for the BLE diagnostics
+ * characteristic.
+ */
+class Metrics {
+public:
+    /**
+     * Called by Metric's constructor (ignored once METRICS_MAX is reached)
+     */
+    static void add(Metric* metric);
+
+    static uint8_t count() { return _count; }
+    static const Metric& at(uint8_t index) { return *_metrics[index]; }
+
+    /**
+     * Metrics that did not fit in the registry
+     */
+    static uint8_t overflow() { return _overflow; }
+
+    /**
+     * Format one metric as a line (no newline)
+     * @return Length written (truncated to fit)
+     */
+    static size_t format(const Metric& metric, char* buffer, size_t size);
+
+    /**
+     * Print every metric to Serial
+     */
+    static void print();
+
+    /**
+     * Format one page of the snapshot: "<page>/<pages>" then whole lines
+     * @param page 0-based page index (past the end gives an empty page)
+     * @param buffer Output, at least METRICS_PAGE_BYTES + 1 bytes
+     * @return Length written
+     */
+    static size_t formatPage(uint8_t page, char* buffer);
+
+private:
+    static Metric* _metrics[METRICS_MAX];
+    static uint8_t _count;
+    static uint8_t _overflow;
+};
+
+#endif // METRICS_H
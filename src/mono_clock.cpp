@@ -0,0 +1,12 @@
+#include "mono_clock.h"
+#include <esp_timer.h>
+
+MonoClock::Source MonoClock::_source = nullptr;
+
+int64_t MonoClock::nowUs() {
+    return _source ? _source() : esp_timer_get_time();
+}
+
+void MonoClock::setSource(Source source) {
+    _source = source;
+}
@@ -0,0 +1,84 @@
+#ifndef MONO_CLOCK_H
+#define MONO_CLOCK_H
+
+#include <Arduino.h>
+
+/**
+ * MonoClock - Monotonic microsecond clock for deadlines and intervals
+ *
+ * Backed by esp_timer (64-bit, never wraps, unaffected by BLE time sync).
+ * A different source can be injected so timing logic can be driven by a
+ * simulated clock.
+ */
+class MonoClock {
+public:
+    /**
+     * Time source returning microseconds since an arbitrary fixed point
+     */
+    typedef int64_t (*Source)();
+
+    /**
+     * Current time in microseconds
+     */
+    static int64_t nowUs();
+
+    /**
+     * Current time in milliseconds (wraps like millis(); use unsigned differences)
+     */
+    static uint32_t nowMs() { return (uint32_t)(nowUs() / 1000); }
+
+    /**
+     * Replace the time source
+     * @param source New source, or nullptr to restore esp_timer
+     */
+    static void setSource(Source source);
+
+private:
+    static Source _source;
+};
+
+/**
+ * Deadline - One-shot timeout measured on MonoClock
+ */
+class Deadline {
+public:
+    Deadline() : _at(0), _armed(false) {}
+
+    /**
+     * Arm the deadline
+     * @param ms Milliseconds from now
+     */
+    void start(uint32_t ms) {
+        _at = MonoClock::nowUs() + (int64_t)ms * 1000;
+        _armed = true;
+    }
+
+    /**
+     * Disarm without expiring
+     */
+    void cancel() { _armed = false; }
+
+    /**
+     * Check if the deadline is armed
+     */
+    bool isArmed() const { return _armed; }
+
+    /**
+     * Check if an armed deadline has passed
+     */
+    bool hasExpired() const { return _armed && MonoClock::nowUs() >= _at; }
+
+    /**
+     * Milliseconds left (0 if expired or not armed)
+     */
+    uint32_t remainingMs() const {
+        int64_t left = _armed ? _at - MonoClock::nowUs() : 0;
+        return (left > 0) ? (uint32_t)((left + 999) / 1000) : 0;
+    }
+
+private:
+    int64_t _at;
+    bool _armed;
+};
+
+#endif // MONO_CLOCK_H
@@ -0,0 +1,59 @@
+#ifndef OBJECT_SLOT_H
+#define OBJECT_SLOT_H
+
+#include <stdint.h>
+#include <new>
+#include <utility>
+
+/**
+ * ObjectSlot - Reserved storage for one T, constructed in place on demand
+ *
+ * For objects that are created and destroyed over and over (audio
+ * decoders, file sources): the bytes are reserved once, where the slot
+ * itself lives, and create() uses placement new, so playing, stopping
+ * and looping never go through the heap.
+ *
+ * Usage: static ObjectSlot<AudioGeneratorWAV> wavSlot;
+ *        AudioGeneratorWAV* wav = wavSlot.create();
+ *        ...
+ *        wavSlot.destroy();
+ */
+template <typename T>
+class ObjectSlot {
+public:
+    ObjectSlot() : _object(nullptr) {}
+    ~ObjectSlot() { destroy(); }
+
+    /**
+     * Construct a T in the slot, destroying the previous one first
+     * @return The new object (never null)
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        destroy();
+        _object = new (_storage) T(std::forward<Args>(args)...);
+        return _object;
+    }
+
+    /**
+     * Run the destructor of the current object (no effect if empty)
+     */
+    void destroy() {
+        if (_object != nullptr) {
+            _object->~T();
+            _object = nullptr;
+        }
+    }
+
+    T* get() const { return _object; }
+    bool isEmpty() const { return _object == nullptr; }
+
+private:
+    ObjectSlot(const ObjectSlot&) = delete;
+    ObjectSlot& operator=(const ObjectSlot&) = delete;
+
+    alignas(T) uint8_t _storage[sizeof(T)];
+    T* _object;
+};
+
+#endif // OBJECT_SLOT_H
@@ -0,0 +1,71 @@
+#include "profile_scheduler.h"
+
+static const uint16_t MINUTES_PER_DAY = 1440;
+
+// Profiles by start time; each runs until the next one starts
+static const DeviceProfile PROFILES[] = {
+    { "day",   NIGHT_END_MINUTE,   100,              100,                    true },
+    { "night", NIGHT_START_MINUTE, NIGHT_BRIGHTNESS, NIGHT_CLICK_VOLUME_MAX, NIGHT_SECONDS_REFRESH },
+};
+static const uint8_t PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+static_assert(NIGHT_START_MINUTE < MINUTES_PER_DAY && NIGHT_END_MINUTE < MINUTES_PER_DAY,
+              "Profile boundaries must be minutes of the day");
+static_assert(NIGHT_START_MINUTE != NIGHT_END_MINUTE, "Night profile must have a length");
+
+ProfileScheduler::ProfileScheduler()
+    : _active(-1),
+      _nextBoundary(0),
+      _lastMinute(-1) {
+}
+
+bool ProfileScheduler::update(uint16_t minuteOfDay) {
+    bool jumped = _lastMinute < 0 || minuteOfDay != (_lastMinute + 1) % MINUTES_PER_DAY;
+    _lastMinute = minuteOfDay;
+
+    if (!jumped && minuteOfDay != _nextBoundary) {
+        return false;
+    }
+
+    // Latest start at or before now; before the earliest start, yesterday's last profile
+    int8_t selected = -1;
+    for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+        if (PROFILES[i].startMinute <= minuteOfDay &&
+            (selected < 0 || PROFILES[i].startMinute > PROFILES[selected].startMinute)) {
+            selected = i;
+        }
+    }
+    if (selected < 0) {
+        for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+            if (selected < 0 || PROFILES[i].startMinute > PROFILES[selected].startMinute) {
+                selected = i;
+            }
+        }
+    }
+
+    // Next start after now (wrapping past midnight)
+    uint16_t wait = MINUTES_PER_DAY;
+    for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+        uint16_t delta = (PROFILES[i].startMinute + MINUTES_PER_DAY - minuteOfDay) % MINUTES_PER_DAY;
+        if (delta > 0 && delta < wait) {
+            wait = delta;
+            _nextBoundary = PROFILES[i].startMinute;
+        }
+    }
+
+    if (!PROFILES_ENABLED) {
+        selected = 0;  // Day settings only
+    }
+    if (selected == _active) {
+        return false;
+    }
+
+    _active = selected;
+    Serial.printf("ProfileScheduler: '%s' profile active until %02d:%02d\n",
+                  PROFILES[_active].name, _nextBoundary / 60, _nextBoundary % 60);
+    return true;
+}
+
+const DeviceProfile& ProfileScheduler::active() const {
+    return PROFILES[(_active < 0) ? 0 : _active];
+}
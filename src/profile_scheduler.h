@@ -0,0 +1,55 @@
+#ifndef PROFILE_SCHEDULER_H
+#define PROFILE_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Time-of-day device behaviour
+ *
+ * Applied as transient overrides: nothing here is written to NVS, and
+ * the user's settings apply again when the profile ends.
+ */
+struct DeviceProfile {
+    const char* name;
+    uint16_t startMinute;    // Local minute of day the profile begins
+    uint8_t brightnessMax;   // Frontlight cap (100 = user setting)
+    uint8_t clickVolumeMax;  // Button sound volume cap (100 = user setting)
+    bool secondsRefresh;     // true = redraw every second, false = once a minute
+};
+
+/**
+ * @brief ProfileScheduler - selects the day or night profile
+ *
+ * The profile is only re-evaluated at the next boundary, or when the
+ * clock jumps (time sync, DST). Between boundaries update() is a single
+ * comparison.
+ */
+class ProfileScheduler {
+public:
+    ProfileScheduler();
+
+    /**
+     * @brief Pick the profile for the current minute (call once per minute)
+     * @param minuteOfDay Local time, 0-1439
+     * @return true if the active profile changed (always on the first call)
+     */
+    bool update(uint16_t minuteOfDay);
+
+    /**
+     * @brief The profile in effect
+     */
+    const DeviceProfile& active() const;
+
+    /**
+     * @brief Local minute of day at which the profile changes next
+     */
+    uint16_t nextBoundary() const { return _nextBoundary; }
+
+private:
+    int8_t _active;          // Index into the profile table (-1 = not evaluated yet)
+    uint16_t _nextBoundary;  // Minute of day of the next profile start
+    int16_t _lastMinute;     // Detects clock jumps (-1 = none yet)
+};
+
+#endif // PROFILE_SCHEDULER_H
@@ -0,0 +1,249 @@
+#include "settings_store.h"
+#include <Preferences.h>
+#include <esp_system.h>
+#include "trace.h"
+
+// NVS key of each setting (max 15 chars)
+static const char* const SETTING_KEYS[SETTING_COUNT] = {
+    "brightness",   // SETTING_BRIGHTNESS
+    "volume",       // SETTING_VOLUME
+    "customMsg",    // SETTING_CUSTOM_MESSAGE
+    "bottomLabel",  // SETTING_BOTTOM_LABEL
+    "btnSound"      // SETTING_BUTTON_SOUND
+};
+
+SettingsStore* SettingsStore::_instance = nullptr;
+
+SettingsStore::SettingsStore()
+    : _dirty(0),
+      _handle(0),
+      _open(false),
+      _mutex(NULL) {
+    memset(&_values, 0, sizeof(_values));
+    _values.brightness = 50;  // Default 50%
+    _values.volume = 70;      // Default 70%
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool SettingsStore::begin() {
+    _mutex = xSemaphoreCreateMutex();
+    _instance = this;
+
+    esp_err_t err = nvs_open(SETTINGS_NAMESPACE, NVS_READWRITE, &_handle);
+    _open = (err == ESP_OK);
+    if (!_open) {
+        Serial.printf("SettingsStore: ERROR - Failed to open NVS (%s), using defaults\n", esp_err_to_name(err));
+        return false;
+    }
+
+    loadByte(SETTING_BRIGHTNESS, _values.brightness, "frontlight");
+    loadByte(SETTING_VOLUME, _values.volume, "audio");
+    loadText(SETTING_CUSTOM_MESSAGE, _values.customMessage, sizeof(_values.customMessage), "display", "customMsg");
+    loadText(SETTING_BOTTOM_LABEL, _values.bottomLabel, sizeof(_values.bottomLabel), "display", "bottomLabel");
+    loadText(SETTING_BUTTON_SOUND, _values.buttonSound, sizeof(_values.buttonSound), "button", "sound");
+
+    if (_dirty != 0) {
+        _commitDue.start(SETTINGS_COMMIT_DELAY_MS);
+    }
+
+    // Flush pending writes when esp_restart() is called from anywhere
+    esp_register_shutdown_handler(onShutdown);
+
+    Serial.printf("SettingsStore: Loaded (brightness %d%%, volume %d%%%s)\n",
+                  _values.brightness, _values.volume, _dirty ? ", migrating old settings" : "");
+    return true;
+}
+
+void SettingsStore::setBrightness(uint8_t brightness) {
+    setByte(SETTING_BRIGHTNESS, _values.brightness, brightness);
+}
+
+void SettingsStore::setVolume(uint8_t volume) {
+    setByte(SETTING_VOLUME, _values.volume, volume);
+}
+
+void SettingsStore::setCustomMessage(const char* message) {
+    setText(SETTING_CUSTOM_MESSAGE, _values.customMessage, sizeof(_values.customMessage), message);
+}
+
+void SettingsStore::setBottomRowLabel(const char* label) {
+    setText(SETTING_BOTTOM_LABEL, _values.bottomLabel, sizeof(_values.bottomLabel), label);
+}
+
+void SettingsStore::setButtonSound(const char* soundName) {
+    setText(SETTING_BUTTON_SOUND, _values.buttonSound, sizeof(_values.buttonSound), soundName);
+}
+
+void SettingsStore::update() {
+    if (_dirty != 0 && _commitDue.hasExpired()) {
+        commit();
+    }
+}
+
+bool SettingsStore::commit() {
+    if (!_open || _mutex == NULL) {
+        return false;
+    }
+
+    // Snapshot dirty values so setters aren't blocked by the flash write
+    Values values;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    uint8_t dirty = _dirty;
+    _dirty = 0;
+    _commitDue.cancel();
+    if (dirty != 0) {
+        memcpy(&values, &_values, sizeof(values));
+    }
+    xSemaphoreGive(_mutex);
+
+    if (dirty == 0) {
+        return true;
+    }
+
+    Trace::begin(TRACE_NVS_COMMIT);
+    uint8_t failed = 0;
+    uint8_t written = 0;
+    for (uint8_t key = 0; key < SETTING_COUNT; key++) {
+        if (!(dirty & (1 << key))) {
+            continue;
+        }
+
+        esp_err_t err;
+        switch (key) {
+            case SETTING_BRIGHTNESS:     err = nvs_set_u8(_handle, SETTING_KEYS[key], values.brightness); break;
+            case SETTING_VOLUME:         err = nvs_set_u8(_handle, SETTING_KEYS[key], values.volume); break;
+            case SETTING_CUSTOM_MESSAGE: err = nvs_set_str(_handle, SETTING_KEYS[key], values.customMessage); break;
+            case SETTING_BOTTOM_LABEL:   err = nvs_set_str(_handle, SETTING_KEYS[key], values.bottomLabel); break;
+            default:                     err = nvs_set_str(_handle, SETTING_KEYS[key], values.buttonSound); break;
+        }
+
+        if (err == ESP_OK) {
+            written++;
+        } else {
+            failed |= (1 << key);
+        }
+    }
+
+    if (nvs_commit(_handle) != ESP_OK) {
+        failed = dirty;
+    }
+    Trace::end(TRACE_NVS_COMMIT, written);
+
+    _stats.commits++;
+    _stats.keyWrites += written;
+    if (failed != 0) {
+        // Keep the values dirty and try again after another delay
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        _stats.failures++;
+        _dirty |= failed;
+        _commitDue.start(SETTINGS_COMMIT_DELAY_MS);
+        xSemaphoreGive(_mutex);
+        Serial.printf("SettingsStore: ERROR - Commit failed (dirty mask 0x%02x)\n", failed);
+        return false;
+    }
+
+    Serial.printf("SettingsStore: Committed %d key(s) (%lu commits, %lu key writes for %lu changes)\n",
+                  written, (unsigned long)_stats.commits, (unsigned long)_stats.keyWrites,
+                  (unsigned long)_stats.changes);
+    return true;
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void SettingsStore::setByte(SettingKey key, uint8_t& field, uint8_t value) {
+    if (_mutex == NULL) {
+        field = value;
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (field != value) {
+        field = value;
+        markDirty(key);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void SettingsStore::setText(SettingKey key, char* field, size_t size, const char* value) {
+    if (value == NULL) {
+        value = "";
+    }
+    if (_mutex == NULL) {
+        strncpy(field, value, size - 1);
+        field[size - 1] = '\0';
+        return;
+    }
+
+    // Longer values are truncated to the buffer, like the callers already do
+    size_t length = strlen(value);
+    if (length > size - 1) {
+        length = size - 1;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (strlen(field) != length || memcmp(field, value, length) != 0) {
+        memcpy(field, value, length);
+        field[length] = '\0';
+        markDirty(key);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void SettingsStore::getText(const char* field, StringBuilder& out) {
+    if (_mutex == NULL) {
+        out.assign(field);
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    out.assign(field);
+    xSemaphoreGive(_mutex);
+}
+
+void SettingsStore::markDirty(SettingKey key) {
+    _dirty |= (1 << key);
+    _stats.changes++;
+    _commitDue.start(SETTINGS_COMMIT_DELAY_MS);
+}
+
+void SettingsStore::loadByte(SettingKey key, uint8_t& field, const char* legacyNamespace) {
+    if (nvs_get_u8(_handle, SETTING_KEYS[key], &field) == ESP_OK) {
+        return;
+    }
+
+    // Not in the settings namespace yet: migrate from the old per-module one
+    Preferences legacy;
+    if (legacy.begin(legacyNamespace, true)) {
+        if (legacy.isKey(SETTING_KEYS[key])) {
+            field = legacy.getUChar(SETTING_KEYS[key], field);
+            _dirty |= (1 << key);
+        }
+        legacy.end();
+    }
+}
+
+void SettingsStore::loadText(SettingKey key, char* field, size_t size, const char* legacyNamespace, const char* legacyKey) {
+    size_t length = size;
+    if (nvs_get_str(_handle, SETTING_KEYS[key], field, &length) == ESP_OK) {
+        return;
+    }
+    field[0] = '\0';
+
+    Preferences legacy;
+    if (legacy.begin(legacyNamespace, true)) {
+        if (legacy.isKey(legacyKey)) {
+            strncpy(field, legacy.getString(legacyKey, "").c_str(), size - 1);
+            field[size - 1] = '\0';
+            _dirty |= (1 << key);
+        }
+        legacy.end();
+    }
+}
+
+void SettingsStore::onShutdown() {
+    if (_instance != nullptr && _instance->isDirty()) {
+        _instance->commit();
+    }
+}
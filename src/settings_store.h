@@ -0,0 +1,123 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <Arduino.h>
+#include <nvs.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "fixed_string.h"
+#include "mono_clock.h"
+
+/**
+ * @brief Persisted user settings
+ */
+enum SettingKey : uint8_t {
+    SETTING_BRIGHTNESS = 0,
+    SETTING_VOLUME,
+    SETTING_CUSTOM_MESSAGE,
+    SETTING_BOTTOM_LABEL,
+    SETTING_BUTTON_SOUND,
+    SETTING_COUNT
+};
+
+/**
+ * @brief Settings write statistics since boot
+ */
+struct SettingsStats {
+    uint32_t changes;     // Setter calls that changed a value
+    uint32_t commits;     // NVS commits
+    uint32_t keyWrites;   // Keys written to NVS
+    uint32_t failures;    // Failed writes (retried on the next commit)
+};
+
+/**
+ * @brief SettingsStore - write-behind cache of user settings in NVS
+ *
+ * Settings are read once at boot and served from RAM. Setters only mark
+ * the value dirty; dirty values are written through one NVS handle kept
+ * open, SETTINGS_COMMIT_DELAY_MS after the last change (or at restart),
+ * so dragging a slider in the app costs one flash write instead of dozens.
+ * Setters may be called from the BLE task.
+ */
+class SettingsStore {
+public:
+    SettingsStore();
+
+    /**
+     * @brief Open the settings namespace and load all values
+     *
+     * Values missing from the namespace are taken from the per-module
+     * namespaces used by earlier firmware and written back on the first commit.
+     * @return true if NVS is available (defaults are used otherwise)
+     */
+    bool begin();
+
+    uint8_t getBrightness() const { return _values.brightness; }
+    void setBrightness(uint8_t brightness);
+
+    uint8_t getVolume() const { return _values.volume; }
+    void setVolume(uint8_t volume);
+
+    // Text getters copy into the caller's string (cut to its capacity)
+    void getCustomMessage(StringBuilder& out) { getText(_values.customMessage, out); }
+    void setCustomMessage(const char* message);
+
+    void getBottomRowLabel(StringBuilder& out) { getText(_values.bottomLabel, out); }
+    void setBottomRowLabel(const char* label);
+
+    void getButtonSound(StringBuilder& out) { getText(_values.buttonSound, out); }
+    void setButtonSound(const char* soundName);
+
+    /**
+     * @brief Commit once changes have settled (call from loop)
+     */
+    void update();
+
+    /**
+     * @brief Write all dirty settings now
+     * @return true if nothing was dirty or everything was written
+     */
+    bool commit();
+
+    /**
+     * @brief Check if changes are waiting to be written
+     */
+    bool isDirty() const { return _dirty != 0; }
+
+    /**
+     * @brief Write statistics since boot
+     */
+    const SettingsStats& getStats() const { return _stats; }
+
+private:
+    struct Values {
+        uint8_t brightness;
+        uint8_t volume;
+        char customMessage[CUSTOM_MESSAGE_MAX + 1];
+        char bottomLabel[BOTTOM_LABEL_MAX + 1];
+        char buttonSound[SOUND_NAME_BUFFER_LEN];
+    };
+
+    Values _values;
+    uint8_t _dirty;         // Bit per SettingKey
+    Deadline _commitDue;    // Restarted by every change
+    nvs_handle_t _handle;
+    bool _open;
+    SemaphoreHandle_t _mutex;
+    SettingsStats _stats;
+
+    static SettingsStore* _instance;  // For the shutdown handler
+
+    void setByte(SettingKey key, uint8_t& field, uint8_t value);
+    void setText(SettingKey key, char* field, size_t size, const char* value);
+    void getText(const char* field, StringBuilder& out);
+    void markDirty(SettingKey key);
+
+    void loadByte(SettingKey key, uint8_t& field, const char* legacyNamespace);
+    void loadText(SettingKey key, char* field, size_t size, const char* legacyNamespace, const char* legacyKey);
+
+    static void onShutdown();
+};
+
+#endif // SETTINGS_STORE_H
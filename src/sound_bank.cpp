@@ -0,0 +1,568 @@
+#include "sound_bank.h"
+#include <SPIFFS.h>
+
+static const uint32_t BANK_MAGIC = 0x4B4E4253;  // "SBNK"
+static const uint16_t BANK_VERSION = 2;  // v2: SHA-256 digest per entry
+static const uint32_t JOURNAL_MAGIC = 0x4C4E4A53;  // "SJNL"
+
+// Entries that cannot be played or deduplicated against
+static const uint8_t OUT_OF_SERVICE = SOUND_BANK_FLAG_DELETED | SOUND_BANK_FLAG_QUARANTINED;
+
+// Zero fill for alignment padding
+static const uint8_t PADDING[256] = { 0 };
+
+SoundBank::SoundBank() : _count(0), _appending(false), _appendStart(0), _appendLength(0) {
+    // Header and full index must fit in front of the first payload
+    static_assert(sizeof(Header) + sizeof(SoundBankEntry) * MAX_SOUND_FILES <= SOUND_BANK_ALIGN,
+                  "Sound bank index does not fit in the first aligned block");
+    reset();
+}
+
+bool SoundBank::load() {
+    reset();
+
+    File file = SPIFFS.open(SOUND_BANK_PATH, "r");
+    if (!file) {
+        return false;
+    }
+
+    Header header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != BANK_MAGIC || header.version != BANK_VERSION ||
+        header.count > MAX_SOUND_FILES) {
+        Serial.println("SoundBank: Bank header invalid");
+        file.close();
+        return false;
+    }
+
+    size_t bytes = header.count * sizeof(SoundBankEntry);
+    size_t bytesRead = file.read((uint8_t*)_entries, bytes);
+    file.close();
+
+    if (bytesRead != bytes || SoundCatalog::updateCrc(0, (const uint8_t*)_entries, bytes) != header.indexCrc) {
+        Serial.println("SoundBank: Bank index CRC mismatch");
+        reset();
+        return false;
+    }
+
+    _header = header;
+    _count = header.count;
+    for (uint8_t i = 0; i < _count; i++) {
+        _entries[i].name[SOUND_NAME_BUFFER_LEN - 1] = '\0';
+    }
+
+    // A payload was half moved when power was lost
+    resumeMove();
+
+    Serial.printf("SoundBank: Loaded %d entries (%u bytes live, %u bytes reclaimable)\n",
+                  _count, liveBytes(), deadBytes());
+    return true;
+}
+
+const SoundBankEntry* SoundBank::find(uint16_t id) const {
+    int index = indexOf(id);
+    if (index < 0 || (_entries[index].flags & OUT_OF_SERVICE)) {
+        return nullptr;
+    }
+    return &_entries[index];
+}
+
+const SoundBankEntry* SoundBank::findByDigest(const uint8_t* digest, uint32_t length) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        const SoundBankEntry& entry = _entries[i];
+        if (!(entry.flags & OUT_OF_SERVICE) && entry.length == length &&
+            memcmp(entry.digest, digest, SOUND_DIGEST_LEN) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool SoundBank::locate(uint16_t id, SoundLocation& location) const {
+    const SoundBankEntry* entry = find(id);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    location.path = StoragePath(SOUND_BANK_PATH);
+    location.offset = entry->offset;
+    location.length = entry->length;
+    location.codec = entry->codec;
+    return true;
+}
+
+bool SoundBank::beginAppend() {
+    if (_appending) {
+        abortAppend();
+    }
+
+    // Tombstones keep their index slot until the next idle compaction step;
+    // compacting here would block the BLE upload callback
+    if (_count >= MAX_SOUND_FILES) {
+        Serial.println("SoundBank: ERROR - Bank index full");
+        return false;
+    }
+
+    if (!SPIFFS.exists(SOUND_BANK_PATH) && !create()) {
+        return false;
+    }
+
+    _file = SPIFFS.open(SOUND_BANK_PATH, "r+");
+    if (!_file) {
+        Serial.println("SoundBank: ERROR - Cannot open bank for writing");
+        return false;
+    }
+
+    // SPIFFS cannot seek past end of file, so pad up to the aligned start.
+    // Bytes already past dataEnd are slack from an aborted append and are overwritten.
+    uint32_t start = alignUp(_header.dataEnd);
+    uint32_t fileSize = _file.size();
+    if (fileSize < start) {
+        _file.seek(fileSize);
+        while (fileSize < start) {
+            size_t chunk = (start - fileSize < sizeof(PADDING)) ? start - fileSize : sizeof(PADDING);
+            if (_file.write(PADDING, chunk) != chunk) {
+                Serial.println("SoundBank: ERROR - Cannot pad bank");
+                _file.close();
+                return false;
+            }
+            fileSize += chunk;
+        }
+    } else {
+        _file.seek(start);
+    }
+
+    _appendStart = start;
+    _appendLength = 0;
+    _appending = true;
+    return true;
+}
+
+size_t SoundBank::append(const uint8_t* data, size_t len) {
+    if (!_appending) {
+        return 0;
+    }
+
+    size_t written = _file.write(data, len);
+    _appendLength += written;
+    return written;
+}
+
+void SoundBank::flushAppend() {
+    if (_appending) {
+        _file.flush();
+    }
+}
+
+uint16_t SoundBank::finishAppend(const char* name, SoundCodec codec, const uint8_t* digest, SoundProbe& probe) {
+    if (!_appending || _appendLength == 0) {
+        abortAppend();
+        return 0;
+    }
+
+    _file.flush();
+    SoundCatalog::probe(_file, _appendStart, _appendLength, codec, probe);
+
+    SoundBankEntry& entry = _entries[_count];
+    memset(&entry, 0, sizeof(entry));
+    entry.id = _header.nextId;
+    entry.codec = codec;
+    strncpy(entry.name, name, SOUND_NAME_BUFFER_LEN - 1);
+    entry.offset = _appendStart;
+    entry.length = _appendLength;
+    entry.sampleRate = probe.sampleRate;
+    entry.channels = probe.channels;
+    entry.bits = probe.bits;
+    memcpy(entry.digest, digest, SOUND_DIGEST_LEN);
+
+    Header header = _header;
+    header.nextId++;
+    header.dataEnd = _appendStart + _appendLength;
+
+    bool ok = writeIndex(_file, header, _entries, _count + 1);
+    _file.close();
+    _appending = false;
+
+    if (!ok) {
+        Serial.println("SoundBank: ERROR - Index write failed");
+        return 0;
+    }
+
+    _header = header;
+    _count++;
+    return entry.id;
+}
+
+void SoundBank::abortAppend() {
+    if (!_appending) {
+        return;
+    }
+
+    // dataEnd is unchanged, so the next append overwrites this payload
+    _file.close();
+    _appending = false;
+    _appendLength = 0;
+}
+
+bool SoundBank::remove(uint16_t id) {
+    return setFlag(id, SOUND_BANK_FLAG_DELETED);
+}
+
+bool SoundBank::quarantine(uint16_t id, const char* path) {
+    const SoundBankEntry* entry = find(id);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    File src = SPIFFS.open(SOUND_BANK_PATH, "r");
+    File dst = SPIFFS.open(path, "w");
+    bool copied = src && dst && src.seek(entry->offset);
+
+    uint8_t buffer[512];
+    uint32_t remaining = entry->length;
+    while (copied && remaining > 0) {
+        size_t n = src.read(buffer, (remaining < sizeof(buffer)) ? remaining : sizeof(buffer));
+        copied = n > 0 && dst.write(buffer, n) == n;
+        remaining -= n;
+    }
+    if (src) src.close();
+    if (dst) dst.close();
+
+    if (copied) {
+        Serial.printf("SoundBank: Quarantined sound %d -> %s\n", id, path);
+        return setFlag(id, SOUND_BANK_FLAG_DELETED);
+    }
+
+    SPIFFS.remove(path);
+    Serial.printf("SoundBank: Could not copy sound %d to %s, quarantined in the bank\n", id, path);
+    return setFlag(id, SOUND_BANK_FLAG_QUARANTINED);
+}
+
+uint32_t SoundBank::payloadCrc(uint16_t id) {
+    const SoundBankEntry* entry = find(id);
+    if (entry == nullptr) {
+        return 0;
+    }
+
+    File file = SPIFFS.open(SOUND_BANK_PATH, "r");
+    if (!file) {
+        return 0;
+    }
+    uint32_t crc = SoundCatalog::computeCrc(file, entry->offset, entry->length);
+    file.close();
+    return crc;
+}
+
+bool SoundBank::compactStep() {
+    if (_appending) {
+        return false;
+    }
+
+    // Finish a move that failed or was cut short first: restarting it
+    // from the beginning would read source bytes it already overwrote
+    if (!resumeMove()) {
+        return false;
+    }
+
+    // Tombstones only leave the index; their bytes become a gap
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (!(_entries[i].flags & SOUND_BANK_FLAG_DELETED)) {
+            _entries[count++] = _entries[i];
+        }
+    }
+    if (count < _count) {
+        uint8_t dropped = _count - count;
+        _count = count;
+        Header header = _header;
+        header.dataEnd = lastPayloadEnd();
+        File file = SPIFFS.open(SOUND_BANK_PATH, "r+");
+        bool ok = file && writeIndex(file, header, _entries, _count);
+        if (file) {
+            file.close();
+        }
+        if (!ok) {
+            Serial.println("SoundBank: ERROR - Could not drop tombstones");
+            load();  // Back to the index on flash
+            return false;
+        }
+        _header = header;
+        Serial.printf("SoundBank: Dropped %d deleted sounds from the index\n", dropped);
+        return true;
+    }
+
+    // Slide the first payload that has a gap in front of it
+    uint32_t expected = dataStart();
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].offset > expected) {
+            return movePayload(i, expected, 0);
+        }
+        expected = alignUp(_entries[i].offset + _entries[i].length);
+    }
+
+    // Packed; drop any space still counted past the last payload
+    if (_header.dataEnd != lastPayloadEnd()) {
+        Header header = _header;
+        header.dataEnd = lastPayloadEnd();
+        File file = SPIFFS.open(SOUND_BANK_PATH, "r+");
+        bool ok = file && writeIndex(file, header, _entries, _count);
+        if (file) {
+            file.close();
+        }
+        if (!ok) {
+            return false;
+        }
+        _header = header;
+    }
+    return true;
+}
+
+uint32_t SoundBank::deadBytes() const {
+    uint32_t used = alignUp(_header.dataEnd);
+    uint32_t kept = dataStart() + liveBytes();
+    return (used > kept) ? used - kept : 0;
+}
+
+uint32_t SoundBank::liveBytes() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (!(_entries[i].flags & SOUND_BANK_FLAG_DELETED)) {
+            total += alignUp(_entries[i].length);
+        }
+    }
+    return total;
+}
+
+bool SoundBank::parseDigest(const char* hex, uint8_t* digest) {
+    for (size_t i = 0; i < SOUND_DIGEST_LEN * 2; i++) {
+        char c = hex[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else {
+            return false;  // Also catches a string shorter than 64 chars
+        }
+
+        if (i & 1) {
+            digest[i / 2] |= nibble;
+        } else {
+            digest[i / 2] = nibble << 4;
+        }
+    }
+    return hex[SOUND_DIGEST_LEN * 2] == '\0';
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+bool SoundBank::writeIndex(File& file, Header& header, const SoundBankEntry* entries, uint8_t count) {
+    size_t bytes = count * sizeof(SoundBankEntry);
+    header.count = count;
+    header.indexCrc = SoundCatalog::updateCrc(0, (const uint8_t*)entries, bytes);
+
+    file.seek(0);
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    if (bytes > 0) {
+        written += file.write((const uint8_t*)entries, bytes);
+    }
+    file.flush();
+
+    return written == sizeof(header) + bytes;
+}
+
+bool SoundBank::create() {
+    File file = SPIFFS.open(SOUND_BANK_PATH, "w");
+    if (!file) {
+        Serial.println("SoundBank: ERROR - Cannot create bank");
+        return false;
+    }
+
+    reset();
+    bool ok = writeIndex(file, _header, _entries, 0);
+    file.close();
+
+    Serial.println(ok ? "SoundBank: Created empty bank" : "SoundBank: ERROR - Cannot write bank header");
+    return ok;
+}
+
+void SoundBank::reset() {
+    memset(&_header, 0, sizeof(_header));
+    _header.magic = BANK_MAGIC;
+    _header.version = BANK_VERSION;
+    _header.nextId = 1;
+    _header.dataEnd = sizeof(Header) + sizeof(SoundBankEntry) * MAX_SOUND_FILES;
+    _count = 0;
+    memset(_entries, 0, sizeof(_entries));
+}
+
+int SoundBank::indexOf(uint16_t id) const {
+    // Index is sorted by ID (IDs are assigned in increasing order)
+    int lo = 0;
+    int hi = (int)_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (_entries[mid].id == id) {
+            return mid;
+        }
+        if (_entries[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+bool SoundBank::setFlag(uint16_t id, uint8_t flag) {
+    SoundBankEntry* entry = const_cast<SoundBankEntry*>(find(id));
+    if (entry == nullptr) {
+        return false;
+    }
+
+    entry->flags |= flag;
+
+    bool ok;
+    if (_appending) {
+        ok = writeIndex(_file, _header, _entries, _count);
+        _file.seek(_appendStart + _appendLength);
+    } else {
+        File file = SPIFFS.open(SOUND_BANK_PATH, "r+");
+        ok = file && writeIndex(file, _header, _entries, _count);
+        if (file) {
+            file.close();
+        }
+    }
+
+    if (!ok) {
+        Serial.printf("SoundBank: ERROR - Could not update index entry of sound %d\n", id);
+        entry->flags &= ~flag;
+    }
+    return ok;
+}
+
+bool SoundBank::movePayload(uint8_t index, uint32_t to, uint32_t done) {
+    SoundBankEntry& entry = _entries[index];
+    Journal journal;
+    memset(&journal, 0, sizeof(journal));
+    journal.magic = JOURNAL_MAGIC;
+    journal.id = entry.id;
+    journal.from = entry.offset;
+    journal.to = to;
+    journal.length = entry.length;
+    journal.done = done;
+
+    uint32_t startTime = millis();
+    File file = SPIFFS.open(SOUND_BANK_PATH, "r+");
+    if (!file || !writeJournal(journal)) {
+        Serial.printf("SoundBank: ERROR - Cannot start moving sound %d\n", entry.id);
+        if (file) {
+            file.close();
+        }
+        return false;
+    }
+
+    // Copy forward in spans no longer than the gap. A span then never
+    // overwrites source bytes past journal.done, so after an interruption
+    // the unfinished span is simply copied again.
+    uint32_t gap = journal.from - journal.to;
+    uint8_t buffer[512];
+    bool ok = true;
+    while (ok && journal.done < journal.length) {
+        uint32_t remaining = journal.length - journal.done;
+        uint32_t span = (remaining < gap) ? remaining : gap;
+        for (uint32_t copied = 0; ok && copied < span;) {
+            size_t chunk = (span - copied < sizeof(buffer)) ? span - copied : sizeof(buffer);
+            uint32_t position = journal.done + copied;
+            ok = file.seek(journal.from + position) && file.read(buffer, chunk) == chunk &&
+                 file.seek(journal.to + position) && file.write(buffer, chunk) == chunk;
+            copied += chunk;
+        }
+        file.flush();
+        journal.done += span;
+        ok = ok && writeJournal(journal);
+        delay(1);  // Let lower-priority tasks (idle) run between spans
+    }
+
+    if (ok) {
+        entry.offset = journal.to;
+        Header header = _header;
+        header.dataEnd = lastPayloadEnd();
+        ok = writeIndex(file, header, _entries, _count);
+        if (ok) {
+            _header = header;
+        } else {
+            entry.offset = journal.from;  // The journal still describes the move
+        }
+    }
+    file.close();
+
+    if (!ok) {
+        Serial.printf("SoundBank: ERROR - Move of sound %d failed, will be resumed\n", journal.id);
+        return false;
+    }
+
+    SPIFFS.remove(SOUND_BANK_JOURNAL_PATH);
+    Serial.printf("SoundBank: Moved sound %d (%u bytes) down %u bytes in %lu ms\n",
+                  journal.id, journal.length, journal.from - journal.to, millis() - startTime);
+    return true;
+}
+
+bool SoundBank::resumeMove() {
+    Journal journal;
+    if (!readJournal(journal)) {
+        return true;  // No move pending
+    }
+
+    int index = indexOf(journal.id);
+    if (index >= 0 && _entries[index].offset == journal.from && _entries[index].length == journal.length &&
+        journal.to < journal.from && journal.done <= journal.length) {
+        Serial.printf("SoundBank: Resuming move of sound %d at byte %u\n", journal.id, journal.done);
+        return movePayload(index, journal.to, journal.done);
+    }
+
+    // The index was written before the journal could be removed
+    SPIFFS.remove(SOUND_BANK_JOURNAL_PATH);
+    return true;
+}
+
+uint32_t SoundBank::lastPayloadEnd() const {
+    if (_count == 0) {
+        return dataStart();
+    }
+    return _entries[_count - 1].offset + _entries[_count - 1].length;
+}
+
+bool SoundBank::readJournal(Journal& journal) {
+    File file = SPIFFS.open(SOUND_BANK_JOURNAL_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    bool ok = file.read((uint8_t*)&journal, sizeof(journal)) == sizeof(journal);
+    file.close();
+
+    if (!ok || journal.magic != JOURNAL_MAGIC ||
+        journal.check != SoundCatalog::updateCrc(0, (const uint8_t*)&journal, offsetof(Journal, check))) {
+        Serial.println("SoundBank: WARNING - Discarding damaged move journal");
+        SPIFFS.remove(SOUND_BANK_JOURNAL_PATH);
+        return false;
+    }
+    return true;
+}
+
+bool SoundBank::writeJournal(Journal& journal) {
+    journal.check = SoundCatalog::updateCrc(0, (const uint8_t*)&journal, offsetof(Journal, check));
+
+    // Rewritten in place; SPIFFS replaces the page as a whole
+    File file = SPIFFS.open(SOUND_BANK_JOURNAL_PATH, SPIFFS.exists(SOUND_BANK_JOURNAL_PATH) ? "r+" : "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = file.write((const uint8_t*)&journal, sizeof(journal)) == sizeof(journal);
+    file.close();
+    return ok;
+}
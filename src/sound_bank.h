@@ -0,0 +1,240 @@
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "sound_catalog.h"
+#include "storage_path.h"
+
+/**
+ * @brief Where a sound's bytes live: a byte range of one SPIFFS file
+ *
+ * Loose files are a range covering the whole file; bank sounds are a
+ * payload inside SOUND_BANK_PATH.
+ */
+struct SoundLocation {
+    StoragePath path;   // File holding the sound
+    uint32_t offset;    // Start of the sound within the file
+    uint32_t length;    // Sound length in bytes (0 = invalid)
+    uint8_t codec;      // SoundCodec
+    bool pinned;        // Holds a bank reader pin (see FileManager::locateSound)
+
+    SoundLocation() : offset(0), length(0), codec(SOUND_CODEC_UNKNOWN), pinned(false) {}
+    bool isValid() const { return length > 0; }
+};
+
+#define SOUND_DIGEST_LEN  32  // SHA-256
+
+/**
+ * @brief One record of the bank index (fixed size, stored verbatim on flash)
+ */
+struct SoundBankEntry {
+    uint16_t id;                       // Stable sound ID (never reused)
+    uint8_t codec;                     // SoundCodec
+    uint8_t flags;                     // SOUND_BANK_FLAG_*
+    char name[SOUND_NAME_BUFFER_LEN];  // Sound name, not limited by SPIFFS path length
+    uint32_t offset;                   // Payload offset (multiple of SOUND_BANK_ALIGN)
+    uint32_t length;                   // Payload length in bytes
+    uint32_t sampleRate;               // Hz (0 = unknown)
+    uint8_t channels;
+    uint8_t bits;
+    uint16_t reserved;
+    uint8_t digest[SOUND_DIGEST_LEN];  // SHA-256 of the payload (content address)
+};
+
+// Bank entry flags
+#define SOUND_BANK_FLAG_DELETED      0x01  // Tombstone: payload reclaimed by compactStep()
+#define SOUND_BANK_FLAG_QUARANTINED  0x02  // Corrupted payload kept in the bank (could not be copied out)
+
+/**
+ * @brief SoundBank - single packed container for uploaded sounds
+ *
+ * Layout: header, index sorted by ID, then payloads each starting on a
+ * SOUND_BANK_ALIGN boundary. The header and index share the first aligned
+ * block, so opening a sound is one seek into an already-open file.
+ *
+ * Uploads append after the last payload (reusing slack left by aborted
+ * uploads). Deleting marks the index entry as a tombstone; compactStep()
+ * reclaims the space in place, one payload at a time, while idle.
+ *
+ * Payloads are content-addressed by SHA-256 so identical uploads can share
+ * one payload. The bank does not count references; FileManager only
+ * removes a payload once no catalog name refers to it.
+ */
+class SoundBank {
+public:
+    SoundBank();
+
+    /**
+     * @brief Load header and index, finishing an interrupted payload move
+     * @return true if a valid bank exists
+     */
+    bool load();
+
+    /**
+     * @brief Look up a live entry by ID (binary search)
+     * @return Pointer to entry, or nullptr if not found or deleted
+     */
+    const SoundBankEntry* find(uint16_t id) const;
+
+    /**
+     * @brief Look up a live entry by content
+     * @param digest SHA-256 of the payload
+     * @param length Payload length in bytes
+     * @return Pointer to entry, or nullptr if no identical payload is stored
+     */
+    const SoundBankEntry* findByDigest(const uint8_t* digest, uint32_t length) const;
+
+    /**
+     * @brief Location of a live entry for playback
+     * @return true if the ID exists
+     */
+    bool locate(uint16_t id, SoundLocation& location) const;
+
+    /**
+     * @brief Start appending a new payload
+     * @return true if the bank is open for writing
+     */
+    bool beginAppend();
+
+    /**
+     * @brief Append payload data
+     * @return Bytes written
+     */
+    size_t append(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Flush appended data to flash
+     */
+    void flushAppend();
+
+    /**
+     * @brief Add the appended payload to the index
+     * @param name Sound name
+     * @param codec Sound codec
+     * @param digest SHA-256 of the appended payload
+     * @param probe Output: duration and sample format read from the payload
+     * @return New sound ID, 0 on failure
+     */
+    uint16_t finishAppend(const char* name, SoundCodec codec, const uint8_t* digest, SoundProbe& probe);
+
+    /**
+     * @brief Discard the appended payload (its space is reused by the next append)
+     */
+    void abortAppend();
+
+    /**
+     * @brief Tombstone an entry (payload is reclaimed by compactStep())
+     * @return true if the entry existed
+     */
+    bool remove(uint16_t id);
+
+    /**
+     * @brief Take a corrupted payload out of service without deleting it
+     *
+     * Copies the payload to path, then tombstones the entry. If the copy
+     * fails (e.g. flash full), the entry is flagged
+     * SOUND_BANK_FLAG_QUARANTINED instead and its bytes stay in the bank.
+     * @param path Loose file to copy the payload to
+     * @return true if quarantined either way
+     */
+    bool quarantine(uint16_t id, const char* path);
+
+    /**
+     * @brief CRC-32 of an entry's payload (reads from flash)
+     */
+    uint32_t payloadCrc(uint16_t id);
+
+    /**
+     * @brief Reclaim deleted space in place, one step per call
+     *
+     * The first step drops tombstones from the index; each later step
+     * slides the next payload down over the gap in front of it. Needs no
+     * free space. The move in progress is journaled (SOUND_BANK_JOURNAL_PATH),
+     * so an interrupted move is finished by the next step or load().
+     * @return true if a step was done (or nothing is left), false on error
+     */
+    bool compactStep();
+
+    /**
+     * @brief Bytes in gaps between payloads (reclaimable by compactStep())
+     */
+    uint32_t deadBytes() const;
+
+    /**
+     * @brief Bytes held by kept payloads (live or quarantined), including alignment padding
+     */
+    uint32_t liveBytes() const;
+
+    /**
+     * @brief True while an append is in progress
+     */
+    bool isAppending() const { return _appending; }
+
+    /**
+     * @brief Parse a 64-character hex SHA-256 string
+     * @return true if hex was valid
+     */
+    static bool parseDigest(const char* hex, uint8_t* digest);
+
+    size_t count() const { return _count; }
+    const SoundBankEntry& at(size_t index) const { return _entries[index]; }
+
+private:
+    struct Header {
+        uint32_t magic;     // BANK_MAGIC
+        uint16_t version;   // BANK_VERSION
+        uint16_t count;     // Index entries (including tombstones)
+        uint16_t nextId;    // Next ID to assign
+        uint16_t reserved;
+        uint32_t dataEnd;   // End of the last payload
+        uint32_t indexCrc;  // CRC-32 of the index records
+    };
+
+    /**
+     * Payload move in progress (SOUND_BANK_JOURNAL_PATH)
+     */
+    struct Journal {
+        uint32_t magic;   // JOURNAL_MAGIC
+        uint16_t id;      // Entry being moved
+        uint16_t reserved;
+        uint32_t from;    // Offset in the index until the move completes
+        uint32_t to;      // New offset (below from)
+        uint32_t length;
+        uint32_t done;    // Bytes already copied
+        uint32_t check;   // CRC-32 of the fields above
+    };
+
+    Header _header;
+    SoundBankEntry _entries[MAX_SOUND_FILES];
+    uint8_t _count;
+
+    File _file;              // Open read/write while appending
+    bool _appending;
+    uint32_t _appendStart;   // Payload offset of the append in progress
+    uint32_t _appendLength;
+
+    bool writeIndex(File& file, Header& header, const SoundBankEntry* entries, uint8_t count);
+    bool create();
+    void reset();
+    int indexOf(uint16_t id) const;
+    bool setFlag(uint16_t id, uint8_t flag);
+    bool movePayload(uint8_t index, uint32_t to, uint32_t done);
+    bool resumeMove();
+    uint32_t lastPayloadEnd() const;
+
+    static bool readJournal(Journal& journal);
+    static bool writeJournal(Journal& journal);
+
+    static uint32_t alignUp(uint32_t value) {
+        return (value + SOUND_BANK_ALIGN - 1) & ~(uint32_t)(SOUND_BANK_ALIGN - 1);
+    }
+
+    // Offset of the first payload (the index block is reserved for MAX_SOUND_FILES)
+    static uint32_t dataStart() {
+        return alignUp(sizeof(Header) + sizeof(SoundBankEntry) * MAX_SOUND_FILES);
+    }
+};
+
+#endif // SOUND_BANK_H
@@ -0,0 +1,422 @@
+#include "sound_catalog.h"
+#include <SPIFFS.h>
+#include <esp32/rom/crc.h>
+
+// On-flash layout: CatalogHeader followed by `count` SoundCatalogEntry records
+struct CatalogHeader {
+    uint32_t magic;     // CATALOG_MAGIC
+    uint16_t version;   // CATALOG_VERSION
+    uint16_t count;     // Number of entries that follow
+    uint32_t crc32;     // CRC-32 of the entry records
+};
+
+static const uint32_t CATALOG_MAGIC = 0x54414353;  // "SCAT"
+static const uint16_t CATALOG_VERSION = 1;
+
+// MP3 Layer III bitrates in kbps, indexed by header bitrate field
+static const uint16_t MP3_BITRATES_V1[16] = {
+    0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0
+};
+static const uint16_t MP3_BITRATES_V2[16] = {
+    0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0
+};
+
+// MPEG-1 sample rates in Hz, indexed by header sample rate field (MPEG-2 halves, 2.5 quarters)
+static const uint16_t MP3_SAMPLE_RATES_V1[4] = { 44100, 48000, 32000, 0 };
+
+SoundCatalog::SoundCatalog() : _count(0) {
+    memset(_entries, 0, sizeof(_entries));
+    memset(_slots, EMPTY_SLOT, sizeof(_slots));
+}
+
+bool SoundCatalog::load() {
+    File file = SPIFFS.open(SOUND_CATALOG_PATH, "r");
+    if (!file) {
+        return false;
+    }
+
+    CatalogHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != CATALOG_MAGIC || header.version != CATALOG_VERSION ||
+        header.count > MAX_SOUND_FILES) {
+        Serial.println("SoundCatalog: Catalog header invalid");
+        file.close();
+        return false;
+    }
+
+    size_t bytes = header.count * sizeof(SoundCatalogEntry);
+    size_t bytesRead = file.read((uint8_t*)_entries, bytes);
+    file.close();
+
+    if (bytesRead != bytes || updateCrc(0, (const uint8_t*)_entries, bytes) != header.crc32) {
+        Serial.println("SoundCatalog: Catalog CRC mismatch");
+        _count = 0;
+        rehash();
+        return false;
+    }
+
+    _count = header.count;
+    for (uint8_t i = 0; i < _count; i++) {
+        _entries[i].name[SOUND_NAME_BUFFER_LEN - 1] = '\0';
+        _entries[i].flags &= ~SOUND_FLAG_VERIFIED;
+    }
+    rehash();
+
+    Serial.printf("SoundCatalog: Loaded %d entries\n", _count);
+    return true;
+}
+
+bool SoundCatalog::save() {
+    // RAM-only flags must not reach flash, otherwise the CRC changes every boot
+    SoundCatalogEntry records[MAX_SOUND_FILES];
+    for (uint8_t i = 0; i < _count; i++) {
+        records[i] = _entries[i];
+        records[i].flags &= ~SOUND_FLAG_VERIFIED;
+    }
+
+    size_t bytes = _count * sizeof(SoundCatalogEntry);
+    CatalogHeader header;
+    header.magic = CATALOG_MAGIC;
+    header.version = CATALOG_VERSION;
+    header.count = _count;
+    header.crc32 = updateCrc(0, (const uint8_t*)records, bytes);
+
+    File file = SPIFFS.open(SOUND_CATALOG_PATH, "w");
+    if (!file) {
+        Serial.println("SoundCatalog: ERROR - Cannot write catalog");
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    if (bytes > 0) {
+        written += file.write((const uint8_t*)records, bytes);
+    }
+    file.close();
+
+    if (written != sizeof(header) + bytes) {
+        Serial.println("SoundCatalog: ERROR - Catalog write incomplete");
+        return false;
+    }
+    return true;
+}
+
+size_t SoundCatalog::rebuild() {
+    _count = 0;
+    rehash();
+
+    File root = SPIFFS.open(ALARM_SOUNDS_SPIFFS_DIR);
+    if (!root || !root.isDirectory()) {
+        Serial.println("SoundCatalog: ERROR - Cannot open alarm sounds directory");
+        return 0;
+    }
+
+    File file = root.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) {
+            // Entry names may include the directory, keep only the filename
+            const char* name = file.name();
+            const char* slash = strrchr(name, '/');
+            if (slash != nullptr) {
+                name = slash + 1;
+            }
+
+            if (codecFromName(name) != SOUND_CODEC_UNKNOWN &&
+                strlen(name) < SOUND_NAME_BUFFER_LEN) {
+                SoundCatalogEntry entry;
+                describe(file, name, entry);
+                entry.flags |= SOUND_FLAG_VERIFIED;
+                if (!put(entry)) {
+                    Serial.println("SoundCatalog: WARNING - Catalog full, ignoring remaining files");
+                    file.close();
+                    break;
+                }
+            }
+        }
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+
+    Serial.printf("SoundCatalog: Rebuilt from directory scan (%d sounds)\n", _count);
+    return _count;
+}
+
+const SoundCatalogEntry* SoundCatalog::find(const char* name) const {
+    int index = findIndex(name);
+    return (index >= 0) ? &_entries[index] : nullptr;
+}
+
+bool SoundCatalog::put(const SoundCatalogEntry& entry) {
+    int index = findIndex(entry.name);
+    if (index >= 0) {
+        _entries[index] = entry;
+        return true;
+    }
+
+    if (_count >= MAX_SOUND_FILES) {
+        return false;
+    }
+
+    _entries[_count++] = entry;
+    rehash();
+    return true;
+}
+
+bool SoundCatalog::remove(const char* name) {
+    int index = findIndex(name);
+    if (index < 0) {
+        return false;
+    }
+
+    // Keep entries packed; order is not significant
+    _count--;
+    if (index != _count) {
+        _entries[index] = _entries[_count];
+    }
+    rehash();
+    return true;
+}
+
+uint8_t SoundCatalog::countBankRefs(uint16_t bankId) const {
+    uint8_t refs = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].bankId == bankId) {
+            refs++;
+        }
+    }
+    return refs;
+}
+
+bool SoundCatalog::verify(const char* name) {
+    int index = findIndex(name);
+    if (index < 0) {
+        return false;
+    }
+
+    SoundCatalogEntry& entry = _entries[index];
+    if ((entry.flags & SOUND_FLAG_VERIFIED) || entry.bankId != 0) {
+        return true;
+    }
+
+    char path[SOUND_NAME_BUFFER_LEN + sizeof(ALARM_SOUNDS_SPIFFS_DIR) + 1];
+    snprintf(path, sizeof(path), "%s/%s", ALARM_SOUNDS_SPIFFS_DIR, entry.name);
+
+    File file = SPIFFS.open(path, "r");
+    bool ok = file && file.size() == entry.size;
+    if (file) {
+        file.close();
+    }
+
+    if (!ok) {
+        Serial.printf("SoundCatalog: Dropping stale entry: %s\n", entry.name);
+        remove(name);
+        save();
+        return false;
+    }
+
+    entry.flags |= SOUND_FLAG_VERIFIED;
+    return true;
+}
+
+void SoundCatalog::checkAll(bool verifyCrc, SoundCheckResult& result) {
+    memset(&result, 0, sizeof(result));
+
+    // Walk backwards: remove() moves the last entry into the freed slot
+    for (int i = (int)_count - 1; i >= 0; i--) {
+        SoundCatalogEntry& entry = _entries[i];
+        if ((entry.flags & SOUND_FLAG_VERIFIED) || entry.bankId != 0) {
+            continue;
+        }
+        result.checked++;
+
+        char path[SOUND_NAME_BUFFER_LEN + sizeof(ALARM_SOUNDS_SPIFFS_DIR) + 1];
+        snprintf(path, sizeof(path), "%s/%s", ALARM_SOUNDS_SPIFFS_DIR, entry.name);
+
+        File file = SPIFFS.open(path, "r");
+        if (!file) {
+            Serial.printf("SoundCatalog: Missing file: %s\n", entry.name);
+            result.missing++;
+            remove(entry.name);
+            continue;
+        }
+
+        bool ok = file.size() == entry.size;
+        if (ok && verifyCrc) {
+            ok = computeCrc(file, 0, entry.size) == entry.crc32;
+        }
+        file.close();
+
+        if (ok) {
+            entry.flags |= SOUND_FLAG_VERIFIED;
+            continue;
+        }
+
+        char quarantinePath[SOUND_NAME_BUFFER_LEN + sizeof(SOUND_QUARANTINE_DIR) + 1];
+        snprintf(quarantinePath, sizeof(quarantinePath), "%s/%s", SOUND_QUARANTINE_DIR, entry.name);
+        if (SPIFFS.rename(path, quarantinePath)) {
+            Serial.printf("SoundCatalog: Quarantined corrupted file: %s -> %s\n", path, quarantinePath);
+        } else {
+            Serial.printf("SoundCatalog: WARNING - Could not quarantine %s, left in place\n", path);
+        }
+        result.quarantined++;
+        remove(entry.name);
+    }
+
+    if (result.missing > 0 || result.quarantined > 0) {
+        save();
+    }
+}
+
+void SoundCatalog::describe(File& file, const char* name, SoundCatalogEntry& entry, const uint32_t* knownCrc) {
+    memset(&entry, 0, sizeof(entry));
+    strncpy(entry.name, name, SOUND_NAME_BUFFER_LEN - 1);
+    entry.size = file.size();
+    entry.codec = codecFromName(name);
+
+    entry.crc32 = (knownCrc != nullptr) ? *knownCrc : computeCrc(file, 0, entry.size);
+
+    SoundProbe info;
+    probe(file, 0, entry.size, (SoundCodec)entry.codec, info);
+    entry.durationMs = info.durationMs;
+}
+
+SoundCodec SoundCatalog::codecFromName(const char* name) {
+    const char* dot = strrchr(name, '.');
+    if (dot == nullptr) {
+        return SOUND_CODEC_UNKNOWN;
+    }
+    if (strcasecmp(dot, ".mp3") == 0) return SOUND_CODEC_MP3;
+    if (strcasecmp(dot, ".wav") == 0) return SOUND_CODEC_WAV;
+    if (strcasecmp(dot, ".m4a") == 0) return SOUND_CODEC_M4A;
+    return SOUND_CODEC_UNKNOWN;
+}
+
+uint32_t SoundCatalog::updateCrc(uint32_t crc, const uint8_t* data, size_t len) {
+    // ROM implementation, table-driven
+    return crc32_le(crc, data, len);
+}
+
+uint32_t SoundCatalog::computeCrc(File& file, uint32_t base, uint32_t length) {
+    uint8_t buffer[512];
+    uint32_t crc = 0;
+
+    file.seek(base);
+    while (length > 0) {
+        size_t n = file.read(buffer, (length < sizeof(buffer)) ? length : sizeof(buffer));
+        if (n == 0) {
+            break;
+        }
+        crc = updateCrc(crc, buffer, n);
+        length -= n;
+    }
+    return crc;
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void SoundCatalog::rehash() {
+    memset(_slots, EMPTY_SLOT, sizeof(_slots));
+    for (uint8_t i = 0; i < _count; i++) {
+        uint32_t slot = hashName(_entries[i].name) % HASH_SLOTS;
+        while (_slots[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) % HASH_SLOTS;
+        }
+        _slots[slot] = i;
+    }
+}
+
+int SoundCatalog::findIndex(const char* name) const {
+    uint32_t slot = hashName(name) % HASH_SLOTS;
+    for (uint8_t probes = 0; probes < HASH_SLOTS; probes++) {
+        uint8_t index = _slots[slot];
+        if (index == EMPTY_SLOT) {
+            return -1;
+        }
+        if (strcmp(_entries[index].name, name) == 0) {
+            return index;
+        }
+        slot = (slot + 1) % HASH_SLOTS;
+    }
+    return -1;
+}
+
+uint32_t SoundCatalog::hashName(const char* name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Lets WavParser read a sound stored at an offset within a file
+struct FileRange {
+    File* file;
+    uint32_t base;
+};
+
+static size_t readFileRange(void* context, uint32_t offset, uint8_t* buffer, size_t length) {
+    FileRange* range = (FileRange*)context;
+    if (!range->file->seek(range->base + offset)) {
+        return 0;
+    }
+    return range->file->read(buffer, length);
+}
+
+WavResult SoundCatalog::parseWav(File& file, uint32_t base, uint32_t size, WavFormat& format) {
+    FileRange range = { &file, base };
+    return WavParser::parse(readFileRange, &range, size, format);
+}
+
+void SoundCatalog::probe(File& file, uint32_t base, uint32_t size, SoundCodec codec, SoundProbe& probe) {
+    memset(&probe, 0, sizeof(probe));
+    uint8_t header[12];
+
+    if (codec == SOUND_CODEC_WAV) {
+        WavFormat format;
+        if (parseWav(file, base, size, format) == WAV_OK) {
+            probe.durationMs = WavParser::durationMs(format);
+            probe.sampleRate = format.sampleRate;
+            probe.channels = format.channels;
+            probe.bits = format.bits;
+        }
+        return;
+    }
+
+    if (codec == SOUND_CODEC_MP3) {
+        // Skip ID3v2 tag (size is a 28-bit syncsafe integer)
+        uint32_t offset = 0;
+        file.seek(base);
+        if (file.read(header, 10) == 10 && memcmp(header, "ID3", 3) == 0) {
+            offset = 10 + ((((uint32_t)header[6] & 0x7F) << 21) | ((header[7] & 0x7F) << 14) |
+                           ((header[8] & 0x7F) << 7) | (header[9] & 0x7F));
+        }
+
+        // Find first frame sync within 2 KB and assume CBR
+        uint8_t buffer[256];
+        file.seek(base + offset);
+        for (uint32_t scanned = 0; scanned < 2048 && offset + scanned < size; scanned += sizeof(buffer) - 3) {
+            size_t n = file.read(buffer, sizeof(buffer));
+            for (size_t i = 0; i + 3 < n; i++) {
+                if (buffer[i] != 0xFF || (buffer[i + 1] & 0xE6) != 0xE2) continue;  // sync + Layer III
+                uint8_t version = (buffer[i + 1] >> 3) & 0x03;  // 3 = MPEG-1, 2 = MPEG-2, 0 = MPEG-2.5
+                uint16_t kbps = (version == 3 ? MP3_BITRATES_V1 : MP3_BITRATES_V2)[buffer[i + 2] >> 4];
+                uint16_t rate = MP3_SAMPLE_RATES_V1[(buffer[i + 2] >> 2) & 0x03];
+                if (kbps == 0 || rate == 0 || version == 1) continue;
+
+                uint32_t frameStart = offset + scanned + i;
+                if (frameStart >= size) return;
+                probe.sampleRate = (version == 3) ? rate : (version == 2) ? rate / 2 : rate / 4;
+                probe.channels = ((buffer[i + 3] >> 6) == 3) ? 1 : 2;
+                probe.bits = 16;
+                probe.durationMs = (uint32_t)((uint64_t)(size - frameStart) * 8 / kbps);
+                return;
+            }
+            if (n < sizeof(buffer)) break;
+            file.seek(file.position() - 3);
+        }
+    }
+}
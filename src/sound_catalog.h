@@ -0,0 +1,199 @@
+#ifndef SOUND_CATALOG_H
+#define SOUND_CATALOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "fixed_string.h"
+#include "wav_parser.h"
+
+// Sound file name held inline (alarm sounds, button sound, uploads)
+typedef FixedString<SOUND_NAME_BUFFER_LEN - 1> SoundName;
+
+/**
+ * @brief Audio codec of a catalogued sound file
+ */
+enum SoundCodec : uint8_t {
+    SOUND_CODEC_UNKNOWN = 0,
+    SOUND_CODEC_MP3     = 1,
+    SOUND_CODEC_WAV     = 2,
+    SOUND_CODEC_M4A     = 3
+};
+
+/**
+ * @brief One catalogued sound file (fixed size, stored verbatim on flash)
+ */
+struct SoundCatalogEntry {
+    char name[SOUND_NAME_BUFFER_LEN];  // Filename without directory, e.g. "alarm1.mp3"
+    uint32_t size;                     // File size in bytes
+    uint32_t durationMs;               // Estimated play time (0 = unknown)
+    uint32_t crc32;                    // CRC-32 of the file contents
+    uint8_t codec;                     // SoundCodec
+    uint8_t flags;                     // SOUND_FLAG_* (RAM-only bits are cleared on save)
+    uint16_t bankId;                   // Sound bank ID, 0 = loose file in the alarm directory
+};
+
+/**
+ * @brief Stream parameters read from a sound file header
+ */
+struct SoundProbe {
+    uint32_t durationMs;  // Estimated play time (0 = unknown)
+    uint32_t sampleRate;  // Hz (0 = unknown)
+    uint8_t channels;
+    uint8_t bits;
+};
+
+// Entry flags
+#define SOUND_FLAG_VERIFIED  0x01  // RAM only: size checked against SPIFFS this boot
+
+/**
+ * @brief Outcome of a catalog integrity check
+ */
+struct SoundCheckResult {
+    uint8_t checked;      // Entries examined
+    uint8_t missing;      // Files gone from SPIFFS (entry dropped)
+    uint8_t quarantined;  // Files failing size/CRC check (moved to SOUND_QUARANTINE_DIR)
+};
+
+/**
+ * @brief SoundCatalog - compact index of the alarm sound directory
+ *
+ * Keeps name, size, codec, duration and checksum of every sound file in RAM
+ * and mirrors it to a single small file on SPIFFS. Listing sounds and
+ * checking for a file become RAM operations; the directory is only scanned
+ * when the catalog file is missing or fails its CRC.
+ */
+class SoundCatalog {
+public:
+    SoundCatalog();
+
+    /**
+     * @brief Load catalog from SPIFFS
+     * @return true if the catalog file exists and is valid
+     */
+    bool load();
+
+    /**
+     * @brief Write catalog to SPIFFS
+     * @return true if successful
+     */
+    bool save();
+
+    /**
+     * @brief Rebuild catalog by scanning the alarm sound directory
+     * @return Number of sound files found
+     */
+    size_t rebuild();
+
+    /**
+     * @brief Look up an entry by filename (hash lookup, no flash access)
+     * @param name Filename without directory
+     * @return Pointer to entry, or nullptr if not catalogued
+     */
+    const SoundCatalogEntry* find(const char* name) const;
+
+    /**
+     * @brief Add or replace an entry (RAM only, call save() to persist)
+     * @return true if successful, false if catalog is full
+     */
+    bool put(const SoundCatalogEntry& entry);
+
+    /**
+     * @brief Remove an entry (RAM only, call save() to persist)
+     * @return true if the entry existed
+     */
+    bool remove(const char* name);
+
+    /**
+     * @brief Check entry against the file on SPIFFS (once per boot)
+     *
+     * Cheap existence/size check done the first time an entry is used.
+     * Stale entries are dropped from the catalog. Bank entries are checked
+     * against the bank index by FileManager and are not handled here.
+     * @return true if the file matches its catalog entry
+     */
+    bool verify(const char* name);
+
+    /**
+     * @brief Check every unverified loose-file entry against SPIFFS
+     *
+     * Read-only unless a problem is found: missing files are dropped and
+     * corrupted files are moved to SOUND_QUARANTINE_DIR, then the catalog
+     * is saved. A clean check performs no flash writes.
+     * @param verifyCrc true to re-read each file and compare CRC-32, false for size only
+     * @param result Counts of checked, missing and quarantined entries
+     */
+    void checkAll(bool verifyCrc, SoundCheckResult& result);
+
+    /**
+     * @brief Number of catalog names referring to a sound bank payload
+     */
+    uint8_t countBankRefs(uint16_t bankId) const;
+
+    /**
+     * @brief Number of catalogued sounds
+     */
+    size_t count() const { return _count; }
+
+    /**
+     * @brief Entry at index (0 <= index < count())
+     */
+    const SoundCatalogEntry& at(size_t index) const { return _entries[index]; }
+
+    /**
+     * @brief Fill an entry by reading an existing sound file
+     * @param file Open file positioned anywhere
+     * @param name Filename without directory
+     * @param entry Output entry
+     * @param knownCrc CRC-32 if already known (e.g. computed while uploading), nullptr to compute
+     */
+    static void describe(File& file, const char* name, SoundCatalogEntry& entry, const uint32_t* knownCrc = nullptr);
+
+    /**
+     * @brief Read duration and sample format from a WAV or MP3 header
+     * @param file Open file
+     * @param base Offset of the sound within the file
+     * @param size Length of the sound in bytes
+     * @param codec Codec of the sound
+     * @param probe Output parameters (zeroed if unknown)
+     */
+    static void probe(File& file, uint32_t base, uint32_t size, SoundCodec codec, SoundProbe& probe);
+
+    /**
+     * @brief Parse the WAV header of a sound stored within a file
+     * @param file Open file
+     * @param base Offset of the sound within the file
+     * @param size Length of the sound in bytes (the parser never reads past it)
+     * @param format Output; dataOffset is relative to base
+     */
+    static WavResult parseWav(File& file, uint32_t base, uint32_t size, WavFormat& format);
+
+    /**
+     * @brief Derive codec from a filename extension
+     */
+    static SoundCodec codecFromName(const char* name);
+
+    /**
+     * @brief Incremental CRC-32 (start with crc = 0)
+     */
+    static uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t len);
+
+    /**
+     * @brief CRC-32 of a byte range of a file
+     */
+    static uint32_t computeCrc(File& file, uint32_t base, uint32_t length);
+
+private:
+    static const uint8_t HASH_SLOTS = MAX_SOUND_FILES * 2;  // Load factor <= 0.5
+    static const uint8_t EMPTY_SLOT = 0xFF;
+
+    SoundCatalogEntry _entries[MAX_SOUND_FILES];
+    uint8_t _count;
+    uint8_t _slots[HASH_SLOTS];  // Open addressing: index into _entries or EMPTY_SLOT
+
+    void rehash();
+    int findIndex(const char* name) const;
+    static uint32_t hashName(const char* name);
+};
+
+#endif // SOUND_CATALOG_H
@@ -0,0 +1,82 @@
+#include "storage_path.h"
+
+StoragePath::StoragePath() : _length(0), _truncated(false) {
+    _path[0] = '\0';
+}
+
+StoragePath::StoragePath(const char* path) : _length(0), _truncated(false) {
+    _path[0] = '\0';
+    if (path == nullptr) {
+        return;
+    }
+
+    // Single canonical form: strip the VFS mount point
+    size_t mountLen = strlen(SPIFFS_MOUNT_POINT);
+    if (strncmp(path, SPIFFS_MOUNT_POINT, mountLen) == 0 &&
+        (path[mountLen] == '/' || path[mountLen] == '\0')) {
+        path += mountLen;
+    }
+    append(path);
+}
+
+StoragePath StoragePath::forSound(const char* filename) {
+    return StoragePath(ALARM_SOUNDS_SPIFFS_DIR).join(filename);
+}
+
+StoragePath StoragePath::join(const char* name) const {
+    StoragePath path(*this);
+    path.append("/");
+    path.append(name);
+    return path;
+}
+
+const char* StoragePath::filename() const {
+    const char* slash = strrchr(_path, '/');
+    return (slash != nullptr) ? slash + 1 : _path;
+}
+
+const char* StoragePath::soundName() const {
+    size_t dirLen = sizeof(ALARM_SOUNDS_SPIFFS_DIR) - 1;
+    if (strncmp(_path, ALARM_SOUNDS_SPIFFS_DIR, dirLen) != 0 || _path[dirLen] != '/') {
+        return nullptr;
+    }
+
+    const char* name = _path + dirLen + 1;
+    if (*name == '\0' || strchr(name, '/') != nullptr) {
+        return nullptr;
+    }
+    return name;
+}
+
+bool StoragePath::hasExtension(const char* ext) const {
+    size_t extLen = strlen(ext);
+    if (extLen > _length) {
+        return false;
+    }
+    return strcasecmp(_path + _length - extLen, ext) == 0;
+}
+
+void StoragePath::clear() {
+    _path[0] = '\0';
+    _length = 0;
+    _truncated = false;
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void StoragePath::append(const char* text) {
+    if (text == nullptr) {
+        return;
+    }
+
+    while (*text) {
+        if (_length >= CAPACITY - 1) {
+            _truncated = true;
+            break;
+        }
+        _path[_length++] = *text++;
+    }
+    _path[_length] = '\0';
+}
@@ -0,0 +1,82 @@
+#ifndef STORAGE_PATH_H
+#define STORAGE_PATH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief StoragePath - fixed-capacity SPIFFS path held on the stack
+ *
+ * Paths are normalised once on construction: a leading "/spiffs" mount
+ * prefix is removed so c_str() can be passed straight to SPIFFS.open().
+ * Capacity matches the SPIFFS object name limit, so building, copying and
+ * comparing paths never touches the heap.
+ */
+class StoragePath {
+public:
+    static const size_t CAPACITY = STORAGE_PATH_MAX;
+
+    StoragePath();
+
+    /**
+     * @brief Create from a full path, with or without the /spiffs prefix
+     * @param path e.g. "/spiffs/alarms/alarm1.mp3" or "/alarms/alarm1.mp3"
+     */
+    explicit StoragePath(const char* path);
+
+    /**
+     * @brief Path of a sound file in the alarm sounds directory
+     * @param filename Filename without directory, e.g. "alarm1.mp3"
+     */
+    static StoragePath forSound(const char* filename);
+
+    /**
+     * @brief Path of an entry inside this directory
+     * @param name Entry name without leading '/'
+     */
+    StoragePath join(const char* name) const;
+
+    /**
+     * @brief Path as passed to SPIFFS (never includes the mount prefix)
+     */
+    const char* c_str() const { return _path; }
+
+    size_t length() const { return _length; }
+    bool isEmpty() const { return _length == 0; }
+
+    /**
+     * @brief False if the input did not fit and was truncated
+     */
+    bool isValid() const { return _length > 0 && !_truncated; }
+
+    /**
+     * @brief Filename component (after the last '/')
+     */
+    const char* filename() const;
+
+    /**
+     * @brief Filename if the path is directly inside the alarm sounds directory
+     * @return Pointer into this path, or nullptr for other paths
+     */
+    const char* soundName() const;
+
+    /**
+     * @brief Case-insensitive extension check
+     * @param ext Extension including the dot, e.g. ".wav"
+     */
+    bool hasExtension(const char* ext) const;
+
+    void clear();
+
+    bool operator==(const StoragePath& other) const { return strcmp(_path, other._path) == 0; }
+    bool operator!=(const StoragePath& other) const { return !(*this == other); }
+
+private:
+    char _path[CAPACITY];
+    uint8_t _length;
+    bool _truncated;
+
+    void append(const char* text);
+};
+
+#endif // STORAGE_PATH_H
@@ -0,0 +1,170 @@
+#include "task_monitor.h"
+#include "alloc_counter.h"
+#include "log.h"
+#include "metrics.h"
+
+TaskMonitor::Entry TaskMonitor::_entries[TASK_MONITOR_MAX_TASKS];
+uint8_t TaskMonitor::_count = 0;
+uint32_t TaskMonitor::_minLargestBlock = UINT32_MAX;
+uint8_t TaskMonitor::_maxFragmentation = 0;
+bool TaskMonitor::_heapFlagged = false;
+uint32_t TaskMonitor::_lastAllocTotal = 0;
+uint32_t TaskMonitor::_lastAllocMs = 0;
+
+// Guards handles against a task clearing its entry while it is sampled
+static portMUX_TYPE entryMux = portMUX_INITIALIZER_UNLOCKED;
+
+static Counter nearOverflows("stack.near_overflow");
+static Gauge allocRate("heap.allocs_per_s");
+
+static uint8_t heapFragmentation(uint32_t freeBytes, uint32_t largestBlock) {
+    // Share of free heap not usable by the largest single allocation
+    return freeBytes ? 100 - (uint8_t)((uint64_t)largestBlock * 100 / freeBytes) : 0;
+}
+
+void TaskMonitor::watch(TaskHandle_t task, uint32_t stackBytes) {
+    if (task == NULL) {
+        return;
+    }
+
+    // Tasks may register themselves, so slots are claimed under the lock
+    portENTER_CRITICAL(&entryMux);
+    uint8_t index = _count;
+    if (index < TASK_MONITOR_MAX_TASKS) {
+        Entry& entry = _entries[index];
+        strncpy(entry.name, pcTaskGetName(task), sizeof(entry.name) - 1);
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.stackBytes = stackBytes;
+        entry.minFree = stackBytes;
+        entry.flagged = false;
+        entry.task = task;
+        _count++;
+    }
+    portEXIT_CRITICAL(&entryMux);
+
+    if (index >= TASK_MONITOR_MAX_TASKS) {
+        LOG_W(MAIN, "TaskMonitor: Table full, %s not watched", pcTaskGetName(task));
+        return;
+    }
+    sampleEntry(_entries[index]);
+}
+
+void TaskMonitor::taskExiting() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].task == self) {
+            sampleEntry(_entries[i]);
+            portENTER_CRITICAL(&entryMux);
+            _entries[i].task = NULL;
+            portEXIT_CRITICAL(&entryMux);
+            return;
+        }
+    }
+}
+
+void TaskMonitor::sampleEntry(Entry& entry) {
+    // The stack scan runs under the lock (one task at a time, a few us)
+    // so an exiting task cannot be deleted between the check and the read
+    portENTER_CRITICAL(&entryMux);
+    bool alive = (entry.task != NULL);
+    uint32_t freeBytes = alive ? uxTaskGetStackHighWaterMark(entry.task) : entry.minFree;
+    portEXIT_CRITICAL(&entryMux);
+
+    if (freeBytes < entry.minFree) {
+        entry.minFree = freeBytes;
+    }
+    if (alive && !entry.flagged && entry.minFree < TASK_STACK_WARN_BYTES) {
+        entry.flagged = true;
+        nearOverflows.add();
+        LOG_W(MAIN, "TaskMonitor: %s stack nearly full (%u of %u bytes free)",
+              entry.name, entry.minFree, entry.stackBytes);
+    }
+}
+
+void TaskMonitor::sample() {
+    for (uint8_t i = 0; i < _count; i++) {
+        sampleEntry(_entries[i]);
+    }
+
+    uint32_t freeBytes = ESP.getFreeHeap();
+    uint32_t largest = ESP.getMaxAllocHeap();
+    uint8_t fragmentation = heapFragmentation(freeBytes, largest);
+    if (largest < _minLargestBlock) {
+        _minLargestBlock = largest;
+    }
+    if (fragmentation > _maxFragmentation) {
+        _maxFragmentation = fragmentation;
+    }
+    if (!_heapFlagged && largest < HEAP_LARGEST_WARN_BYTES) {
+        _heapFlagged = true;
+        LOG_W(MAIN, "TaskMonitor: Largest free heap block down to %u bytes (%u free, %u%% fragmented)",
+              largest, freeBytes, fragmentation);
+    }
+
+    // Allocation rate since the previous sample (first sample: since boot)
+    uint32_t now = millis();
+    uint32_t allocs = AllocCounter::total();
+    uint32_t elapsedMs = now - _lastAllocMs;
+    if (elapsedMs > 0) {
+        allocRate.set((int32_t)((uint64_t)(allocs - _lastAllocTotal) * 1000 / elapsedMs));
+    }
+    _lastAllocTotal = allocs;
+    _lastAllocMs = now;
+}
+
+uint32_t TaskMonitor::suggestStackBytes(uint32_t peakUsedBytes) {
+    uint32_t margin = peakUsedBytes * TASK_STACK_MARGIN_PCT / 100;
+    if (margin < TASK_STACK_WARN_BYTES) {
+        margin = TASK_STACK_WARN_BYTES;  // A suggested size must not itself be flagged
+    }
+    return (peakUsedBytes + margin + 255) & ~(uint32_t)255;
+}
+
+void TaskMonitor::printReport() {
+    sample();
+
+    Serial.println("TaskMonitor: Stack sizing (bytes; peak = size - lowest free)");
+    Serial.println("  task             size   peak   free  suggest  change");
+    int32_t reclaimable = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        const Entry& entry = _entries[i];
+        uint32_t peak = entry.stackBytes - entry.minFree;
+        uint32_t suggested = suggestStackBytes(peak);
+        int32_t change = (int32_t)suggested - (int32_t)entry.stackBytes;
+        if (change < 0) {
+            reclaimable -= change;
+        }
+        Serial.printf("  %-15s %5u  %5u  %5u    %5u  %+6d%s%s\n", entry.name, entry.stackBytes, peak,
+                      entry.minFree, suggested, change, entry.flagged ? "  NEAR OVERFLOW" : "",
+                      entry.task ? "" : "  (exited)");
+    }
+    Serial.printf("  Reclaimable by resizing: %d bytes\n", reclaimable);
+
+#if configUSE_TRACE_FACILITY
+    // Tasks not created by the firmware (BLE stack, timers, idle): free stack only
+    UBaseType_t total = uxTaskGetNumberOfTasks();
+    TaskStatus_t* tasks = (TaskStatus_t*)malloc(total * sizeof(TaskStatus_t));
+    if (tasks != NULL) {
+        total = uxTaskGetSystemState(tasks, total, NULL);
+        Serial.println("  Other tasks (lowest free stack):");
+        for (UBaseType_t i = 0; i < total; i++) {
+            bool watched = false;
+            for (uint8_t j = 0; j < _count && !watched; j++) {
+                watched = (_entries[j].task == tasks[i].xHandle);
+            }
+            if (!watched) {
+                Serial.printf("  %-15s %5u\n", tasks[i].pcTaskName, (uint32_t)tasks[i].usStackHighWaterMark);
+            }
+        }
+        free(tasks);
+    }
+#endif
+
+    uint32_t freeBytes = ESP.getFreeHeap();
+    uint32_t largest = ESP.getMaxAllocHeap();
+    Serial.printf("TaskMonitor: Heap free=%u (min %u), largest block=%u (min %u), fragmentation=%u%% (max %u%%)\n",
+                  freeBytes, ESP.getMinFreeHeap(), largest, _minLargestBlock,
+                  heapFragmentation(freeBytes, largest), _maxFragmentation);
+    Serial.printf("TaskMonitor: Heap allocations %u since boot, %d/s recently\n",
+                  AllocCounter::total(), allocRate.value());
+}
@@ -0,0 +1,74 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * TaskMonitor - Stack and heap watermark tracking with sizing advice
+ *
+ * Tasks created by the firmware are registered with their configured
+ * stack size. sample() (every TASK_MONITOR_INTERVAL_MS from loop) reads
+ * each task's stack high-water mark and the heap's free space, largest
+ * free block and fragmentation, keeping the worst values seen since
+ * boot. A task whose free stack drops below TASK_STACK_WARN_BYTES, or a
+ * largest heap block below HEAP_LARGEST_WARN_BYTES, is logged once.
+ *
+ * printReport() ("tasks" command) lists every task with its peak use and
+ * a suggested stack size (peak plus TASK_STACK_MARGIN_PCT, rounded up),
+ * so the *_TASK_STACK settings can be trimmed from measurements.
+ *
+ * ESP-IDF reports high-water marks in bytes; all sizes here are bytes.
+ */
+class TaskMonitor {
+public:
+    /**
+     * Track a task (call once after creating it)
+     * @param task Task handle
+     * @param stackBytes Stack size the task was created with
+     */
+    static void watch(TaskHandle_t task, uint32_t stackBytes);
+
+    /**
+     * Record the calling task's final watermark before it deletes itself
+     * (its handle is not touched afterwards; it stays in the report)
+     */
+    static void taskExiting();
+
+    /**
+     * Update watermarks and heap low points; flags near-overflows
+     */
+    static void sample();
+
+    /**
+     * Print the sizing report (takes a fresh sample first)
+     */
+    static void printReport();
+
+    /**
+     * Suggested stack size for a measured peak use
+     * @return Peak + margin (at least TASK_STACK_WARN_BYTES), rounded up to 256 bytes
+     */
+    static uint32_t suggestStackBytes(uint32_t peakUsedBytes);
+
+private:
+    struct Entry {
+        TaskHandle_t task;   // NULL once the task has exited
+        char name[configMAX_TASK_NAME_LEN];
+        uint32_t stackBytes;
+        uint32_t minFree;    // Lowest free stack seen (bytes)
+        bool flagged;        // Near-overflow already logged
+    };
+
+    static Entry _entries[TASK_MONITOR_MAX_TASKS];
+    static uint8_t _count;
+    static uint32_t _minLargestBlock;  // Smallest "largest free block" seen
+    static uint8_t _maxFragmentation;  // Worst fragmentation seen (percent)
+    static bool _heapFlagged;
+    static uint32_t _lastAllocTotal;   // AllocCounter total at the previous sample
+    static uint32_t _lastAllocMs;
+
+    static void sampleEntry(Entry& entry);
+};
+
+#endif // TASK_MONITOR_H
@@ -1,4 +1,7 @@
 #include "time_manager.h"
+#include "config.h"
+#include <esp_system.h>
+#include <esp32/rtc.h>
 
 // Day and month names for formatting
 static const char* DAYS_OF_WEEK[] = {
@@ -10,28 +13,81 @@ static const char* MONTHS[] = {
     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
 };
 
+// ============================================
+// Reset-Surviving Time Record
+// ============================================
+// Pairs a wall-clock time with the RTC timer, which keeps counting through
+// soft resets. RTC_NOINIT memory is not cleared at boot, so the record is
+// only trusted when magic and checksum match.
+#define RTC_TIME_MAGIC 0x54494D45  // "TIME"
+
+struct RtcTimeRecord {
+    uint32_t magic;
+    uint32_t epoch;       // Wall-clock seconds at rtcUs
+    uint64_t rtcUs;       // esp_rtc_get_time_us() when epoch was recorded
+    uint32_t confidence;  // TimeConfidence at the time of recording
+    uint32_t check;
+};
+
+RTC_NOINIT_ATTR static RtcTimeRecord rtcTimeRecord;
+
+static uint32_t rtcRecordCheck(const RtcTimeRecord& record) {
+    return record.magic ^ record.epoch ^ (uint32_t)record.rtcUs ^
+           (uint32_t)(record.rtcUs >> 32) ^ (record.confidence * 0x9E3779B9u);
+}
+
 TimeManager::TimeManager()
-    : _synced(false),
-      _lastSyncMillis(0) {
+    : _confidence(TIME_CONFIDENCE_UNKNOWN),
+      _lastSyncMillis(0),
+      _lastCheckpoint(0),
+      _pendingLock(portMUX_INITIALIZER_UNLOCKED),
+      _pendingFlags(0),
+      _pendingTimestamp(0) {
+    _pendingTz[0] = '\0';
     memset(&_timeinfo, 0, sizeof(struct tm));
+    memset(&_snapshot, 0, sizeof(_snapshot));
+    _snapshot.dayName = DAYS_OF_WEEK[0];
+    invalidateSnapshot();
 }
 
 bool TimeManager::begin() {
-    // Initialize with default time (Jan 1, 2026, 00:00:00)
-    _timeinfo.tm_year = 2026 - 1900;  // Years since 1900
-    _timeinfo.tm_mon = 0;             // January (0-11)
-    _timeinfo.tm_mday = 1;            // Day 1
-    _timeinfo.tm_hour = 0;
-    _timeinfo.tm_min = 0;
-    _timeinfo.tm_sec = 0;
-    _timeinfo.tm_wday = 3;            // Wednesday (0=Sunday)
-
-    // Set ESP32 RTC
-    time_t t = mktime(&_timeinfo);
-    struct timeval now = { .tv_sec = t };
-    settimeofday(&now, NULL);
+    time_t timestamp;
+    const char* source;
+
+    // Time zone first so restored time is shown in local time
+    char tz[TZ_SPEC_MAX];
+    Preferences prefs;
+    strncpy(tz, TIME_DEFAULT_TZ, sizeof(tz));
+    if (prefs.begin("time", true)) {  // Read-only
+        if (prefs.isKey("tz")) {
+            prefs.getString("tz", tz, sizeof(tz));
+        }
+        prefs.end();
+    }
+    if (!applyTimeZone(tz)) {
+        Serial.printf("TimeManager: Invalid stored TZ '%s', using %s\n", tz, TIME_DEFAULT_TZ);
+        applyTimeZone(TIME_DEFAULT_TZ);
+    }
+
+    if (restoreFromRtc(timestamp, _confidence)) {
+        source = "RTC memory";
+    } else if (restoreFromNvs(timestamp)) {
+        _confidence = TIME_CONFIDENCE_UNKNOWN;
+        source = "NVS checkpoint";
+    } else {
+        // Initialize with default time (Jan 1, 2026, 00:00:00)
+        timestamp = TIME_DEFAULT_EPOCH;
+        _confidence = TIME_CONFIDENCE_UNKNOWN;
+        source = "default";
+    }
+
+    applyTimestamp(timestamp);
+    _lastCheckpoint = timestamp;
+    saveRtcRecord();
 
-    Serial.println("TimeManager: Initialized with default time (2026-01-01 00:00:00)");
+    const TimeSnapshot& snap = snapshot();
+    Serial.printf("TimeManager: Restored %s %s from %s (reset reason %d, confidence %d)\n",
+                  snap.date, snap.time24, source, (int)esp_reset_reason(), (int)_confidence);
     return true;
 }
 
@@ -45,13 +101,8 @@ void TimeManager::setTime(uint8_t hour, uint8_t minute, uint8_t second) {
     _timeinfo.tm_sec = second;
 
     // Update ESP32 RTC
-    time_t t = mktime(&_timeinfo);
-    struct timeval now = { .tv_sec = t };
-    settimeofday(&now, NULL);
-
-    // Mark as synced
-    _synced = true;
-    _lastSyncMillis = millis();
+    applyTimestamp(_zone.toUtc(_timeinfo));
+    markSynced();
 
     Serial.printf("TimeManager: Time set to %02d:%02d:%02d\n", hour, minute, second);
 }
@@ -66,44 +117,119 @@ void TimeManager::setDate(uint8_t day, uint8_t month, uint16_t year) {
     _timeinfo.tm_year = year - 1900;  // Years since 1900
 
     // Update ESP32 RTC
-    time_t t = mktime(&_timeinfo);
-    struct timeval now = { .tv_sec = t };
-    settimeofday(&now, NULL);
-
-    // Mark as synced
-    _synced = true;
-    _lastSyncMillis = millis();
+    applyTimestamp(_zone.toUtc(_timeinfo));
+    markSynced();
 
     Serial.printf("TimeManager: Date set to %04d-%02d-%02d\n", year, month, day);
 }
 
 void TimeManager::setTimestamp(time_t timestamp) {
     // Set RTC from Unix timestamp
-    struct timeval now = { .tv_sec = timestamp };
-    settimeofday(&now, NULL);
+    applyTimestamp(timestamp);
 
     // Update local timeinfo
     updateTimeinfo();
-
-    // Mark as synced
-    _synced = true;
-    _lastSyncMillis = millis();
+    markSynced();
 
     Serial.printf("TimeManager: Timestamp set to %ld\n", (long)timestamp);
 }
 
+void TimeManager::postTimestamp(time_t timestamp) {
+    portENTER_CRITICAL(&_pendingLock);
+    _pendingTimestamp = timestamp;
+    _pendingFlags |= TIME_PENDING_TIMESTAMP;
+    portEXIT_CRITICAL(&_pendingLock);
+}
+
+void TimeManager::postTimeZone(const char* tz) {
+    portENTER_CRITICAL(&_pendingLock);
+    strncpy(_pendingTz, tz, sizeof(_pendingTz) - 1);
+    _pendingTz[sizeof(_pendingTz) - 1] = '\0';
+    _pendingFlags |= TIME_PENDING_ZONE;
+    portEXIT_CRITICAL(&_pendingLock);
+}
+
+uint8_t TimeManager::applyPending() {
+    if (_pendingFlags == 0) {  // Racy read; a post just missed is applied next time
+        return 0;
+    }
+
+    char tz[TZ_SPEC_MAX];
+    portENTER_CRITICAL(&_pendingLock);
+    uint8_t flags = _pendingFlags;
+    time_t timestamp = _pendingTimestamp;
+    memcpy(tz, _pendingTz, sizeof(tz));
+    _pendingFlags = 0;
+    portEXIT_CRITICAL(&_pendingLock);
+
+    // Zone first, so the sync is logged and checkpointed in the new local time
+    if (flags & TIME_PENDING_ZONE) {
+        setTimeZone(tz);
+    }
+    if (flags & TIME_PENDING_TIMESTAMP) {
+        setTimestamp(timestamp);
+    }
+    return flags;
+}
+
+const TimeSnapshot& TimeManager::snapshot() {
+    time_t now;
+    time(&now);
+    if (now == _snapshot.epoch) {
+        return _snapshot;
+    }
+
+    struct tm previous = _snapshot.tm;
+    bool first = (_snapshot.epoch == (time_t)-1);  // Invalidated: previous is meaningless
+    _zone.toLocal(now, _snapshot.tm);
+    const struct tm& t = _snapshot.tm;
+    _snapshot.epoch = now;
+
+    // Record which fields rolled over since the last snapshot
+    if (first || t.tm_mday != previous.tm_mday || t.tm_mon != previous.tm_mon || t.tm_year != previous.tm_year) {
+        _snapshot.changed = TIME_CHANGED_ALL;
+    } else if (t.tm_hour != previous.tm_hour) {
+        _snapshot.changed = TIME_CHANGED_SECOND | TIME_CHANGED_MINUTE | TIME_CHANGED_HOUR;
+    } else if (t.tm_min != previous.tm_min) {
+        _snapshot.changed = TIME_CHANGED_SECOND | TIME_CHANGED_MINUTE;
+    } else {
+        _snapshot.changed = TIME_CHANGED_SECOND;
+    }
+
+    // Reformat only the strings whose fields changed
+    if (_snapshot.changed & TIME_CHANGED_MINUTE) {
+        uint8_t hour12 = t.tm_hour % 12;
+        if (hour12 == 0) hour12 = 12;  // 0:00 becomes 12:00 AM
+        snprintf(_snapshot.time12, sizeof(_snapshot.time12), "%d:%02d %s",
+                 hour12, t.tm_min, (t.tm_hour < 12) ? "AM" : "PM");
+        snprintf(_snapshot.time24, sizeof(_snapshot.time24), "%02d:%02d", t.tm_hour, t.tm_min);
+
+        // Re-anchor the reset-surviving record to the crystal-driven system
+        // time, so after a reset only the last minute is measured by the RC
+        // slow clock (which drifts by minutes over hours)
+        saveRtcRecord();
+    }
+    if (_snapshot.changed & TIME_CHANGED_DAY) {
+        snprintf(_snapshot.date, sizeof(_snapshot.date), "%s %d, %d",
+                 MONTHS[t.tm_mon], t.tm_mday, t.tm_year + 1900);
+        _snapshot.dayName = DAYS_OF_WEEK[t.tm_wday];
+    }
+
+    return _snapshot;
+}
+
 void TimeManager::getTime(uint8_t& hour, uint8_t& minute, uint8_t& second) {
-    updateTimeinfo();
-    hour = _timeinfo.tm_hour;
-    minute = _timeinfo.tm_min;
-    second = _timeinfo.tm_sec;
+    const TimeSnapshot& snap = snapshot();
+    hour = snap.tm.tm_hour;
+    minute = snap.tm.tm_min;
+    second = snap.tm.tm_sec;
 }
 
 void TimeManager::getDate(uint8_t& day, uint8_t& month, uint16_t& year) {
-    updateTimeinfo();
-    day = _timeinfo.tm_mday;
-    month = _timeinfo.tm_mon + 1;     // tm_mon is 0-11
-    year = _timeinfo.tm_year + 1900;  // Years since 1900
+    const TimeSnapshot& snap = snapshot();
+    day = snap.tm.tm_mday;
+    month = snap.tm.tm_mon + 1;     // tm_mon is 0-11
+    year = snap.tm.tm_year + 1900;  // Years since 1900
 }
 
 time_t TimeManager::getTimestamp() {
@@ -112,56 +238,139 @@ time_t TimeManager::getTimestamp() {
     return now;
 }
 
-String TimeManager::getTimeString(bool format12Hour) {
-    updateTimeinfo();
-
-    char buffer[16];
-
-    if (format12Hour) {
-        // 12-hour format with AM/PM
-        uint8_t hour12 = _timeinfo.tm_hour % 12;
-        if (hour12 == 0) hour12 = 12;  // 0:00 becomes 12:00 AM
-        const char* ampm = (_timeinfo.tm_hour < 12) ? "AM" : "PM";
+const char* TimeManager::getTimeString(bool format12Hour) {
+    const TimeSnapshot& snap = snapshot();
+    return format12Hour ? snap.time12 : snap.time24;
+}
 
-        snprintf(buffer, sizeof(buffer), "%d:%02d %s",
-                 hour12, _timeinfo.tm_min, ampm);
-    } else {
-        // 24-hour format
-        snprintf(buffer, sizeof(buffer), "%02d:%02d",
-                 _timeinfo.tm_hour, _timeinfo.tm_min);
-    }
+const char* TimeManager::getDateString() {
+    return snapshot().date;
+}
 
-    return String(buffer);
+const char* TimeManager::getDayOfWeekString() {
+    return snapshot().dayName;
 }
 
-String TimeManager::getDateString() {
-    updateTimeinfo();
+bool TimeManager::isSynced() {
+    return _confidence == TIME_CONFIDENCE_SYNCED;
+}
 
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%s %d, %d",
-             MONTHS[_timeinfo.tm_mon],
-             _timeinfo.tm_mday,
-             _timeinfo.tm_year + 1900);
+bool TimeManager::setTimeZone(const char* tz) {
+    if (!applyTimeZone(tz)) {
+        Serial.printf("TimeManager: Rejected TZ '%s'\n", tz);
+        return false;
+    }
 
-    return String(buffer);
+    Preferences prefs;
+    if (prefs.begin("time", false)) {
+        prefs.putString("tz", tz);
+        prefs.end();
+    }
+    return true;
 }
 
-String TimeManager::getDayOfWeekString() {
-    updateTimeinfo();
-    return String(DAYS_OF_WEEK[_timeinfo.tm_wday]);
-}
+void TimeManager::checkpoint() {
+    if (_confidence == TIME_CONFIDENCE_UNKNOWN) {
+        return;
+    }
 
-bool TimeManager::isSynced() {
-    return _synced;
+    time_t now = getTimestamp();
+    if (now - _lastCheckpoint >= TIME_CHECKPOINT_INTERVAL_S) {
+        saveCheckpoint(now);
+    }
 }
 
 unsigned long TimeManager::getTimeSinceSync() {
-    if (!_synced) return 0;
+    if (_confidence != TIME_CONFIDENCE_SYNCED) return 0;
     return millis() - _lastSyncMillis;
 }
 
 void TimeManager::updateTimeinfo() {
     time_t now;
     time(&now);
-    localtime_r(&now, &_timeinfo);
+    _zone.toLocal(now, _timeinfo);
+}
+
+void TimeManager::invalidateSnapshot() {
+    // Forces a full conversion and reformat on the next snapshot()
+    _snapshot.epoch = (time_t)-1;
+    _snapshot.changed = TIME_CHANGED_ALL;
+}
+
+bool TimeManager::applyTimeZone(const char* tz) {
+    if (!_zone.parse(tz)) {
+        return false;
+    }
+
+    // Keep newlib's localtime()/mktime() in agreement for code that still uses them
+    setenv("TZ", _zone.spec(), 1);
+    tzset();
+    invalidateSnapshot();
+    return true;
+}
+
+void TimeManager::applyTimestamp(time_t timestamp) {
+    struct timeval now = { .tv_sec = timestamp, .tv_usec = 0 };
+    settimeofday(&now, NULL);
+    invalidateSnapshot();
+}
+
+void TimeManager::markSynced() {
+    _confidence = TIME_CONFIDENCE_SYNCED;
+    _lastSyncMillis = millis();
+    saveRtcRecord();
+    saveCheckpoint(getTimestamp());
+}
+
+bool TimeManager::restoreFromRtc(time_t& timestamp, TimeConfidence& confidence) {
+    const RtcTimeRecord& record = rtcTimeRecord;
+    if (record.magic != RTC_TIME_MAGIC || record.check != rtcRecordCheck(record)) {
+        return false;
+    }
+
+    // The RTC timer restarts on power-on and brownout, making it run behind the record
+    uint64_t rtcNow = esp_rtc_get_time_us();
+    if (rtcNow < record.rtcUs) {
+        return false;
+    }
+
+    timestamp = record.epoch + (time_t)((rtcNow - record.rtcUs) / 1000000ULL);
+
+    // A synced clock is only estimated after a reset; an unknown one stays unknown
+    confidence = (record.confidence == TIME_CONFIDENCE_UNKNOWN) ? TIME_CONFIDENCE_UNKNOWN
+                                                                : TIME_CONFIDENCE_ESTIMATED;
+    return true;
+}
+
+bool TimeManager::restoreFromNvs(time_t& timestamp) {
+    Preferences prefs;
+    if (!prefs.begin("time", true)) {  // Read-only
+        return false;
+    }
+    uint64_t saved = prefs.getULong64("epoch", 0);
+    prefs.end();
+
+    if (saved < TIME_DEFAULT_EPOCH) {
+        return false;
+    }
+    timestamp = (time_t)saved;
+    return true;
+}
+
+void TimeManager::saveRtcRecord() {
+    rtcTimeRecord.magic = RTC_TIME_MAGIC;
+    rtcTimeRecord.epoch = (uint32_t)getTimestamp();
+    rtcTimeRecord.rtcUs = esp_rtc_get_time_us();
+    rtcTimeRecord.confidence = _confidence;
+    rtcTimeRecord.check = rtcRecordCheck(rtcTimeRecord);
+}
+
+void TimeManager::saveCheckpoint(time_t timestamp) {
+    Preferences prefs;
+    if (!prefs.begin("time", false)) {
+        return;
+    }
+    prefs.putULong64("epoch", (uint64_t)timestamp);
+    prefs.end();
+    _lastCheckpoint = timestamp;
 }
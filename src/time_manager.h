@@ -3,12 +3,56 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include <Preferences.h>
+#include "time_zone.h"
+
+// TimeSnapshot::changed bits
+#define TIME_CHANGED_SECOND  0x01
+#define TIME_CHANGED_MINUTE  0x02
+#define TIME_CHANGED_HOUR    0x04
+#define TIME_CHANGED_DAY     0x08
+#define TIME_CHANGED_ALL     0x0F
+
+// TimeManager::applyPending() result bits
+#define TIME_PENDING_TIMESTAMP 0x01
+#define TIME_PENDING_ZONE      0x02
+
+/**
+ * How far the current wall-clock time can be trusted
+ */
+enum TimeConfidence : uint8_t {
+    TIME_CONFIDENCE_UNKNOWN   = 0,  // Default or last NVS checkpoint (power was lost)
+    TIME_CONFIDENCE_ESTIMATED = 1,  // Carried across a reset by the RTC timer
+    TIME_CONFIDENCE_SYNCED    = 2   // Set from BLE since this boot
+};
+
+/**
+ * Broken-down local time with preformatted strings
+ *
+ * Produced once per second by TimeManager::snapshot(); all fields describe
+ * the same instant.
+ */
+struct TimeSnapshot {
+    time_t epoch;          // Unix timestamp this snapshot was taken from
+    struct tm tm;          // Local time
+    char time12[12];       // "3:45 PM"
+    char time24[6];        // "15:45"
+    char date[16];         // "Jan 14, 2026"
+    const char* dayName;   // "Wednesday" (static string)
+    uint8_t changed;       // TIME_CHANGED_* fields that differ from the previous snapshot
+};
 
 /**
  * TimeManager - ESP32 RTC-based timekeeping with BLE sync support
  *
  * Uses the ESP32's built-in RTC to maintain time without WiFi/NTP.
  * Time is synchronized via BLE from iOS app.
+ *
+ * The last known time is kept in RTC memory, which survives soft resets,
+ * panics and watchdog resets, so the clock comes back without a BLE sync.
+ * The record is refreshed every minute, so the less accurate RTC timer
+ * only has to bridge the time since then.
+ * An hourly NVS checkpoint covers power loss, with lower confidence.
  */
 class TimeManager {
 public:
@@ -16,6 +60,10 @@ public:
 
     /**
      * Initialize the time manager
+     *
+     * Restores time from RTC memory after a soft reset (ESTIMATED if it was
+     * known before), else from the NVS checkpoint (UNKNOWN), else starts at
+     * TIME_DEFAULT_EPOCH (UNKNOWN).
      * @return true if successful
      */
     bool begin();
@@ -42,6 +90,38 @@ public:
      */
     void setTimestamp(time_t timestamp);
 
+    /**
+     * Queue a timestamp for the next applyPending() (safe from any task)
+     *
+     * BLE callbacks run on the BLE task; setting the time there would
+     * change the zone table and snapshot while loop() is reading them.
+     * @param timestamp Unix timestamp
+     */
+    void postTimestamp(time_t timestamp);
+
+    /**
+     * Queue a POSIX TZ string for the next applyPending() (safe from any task)
+     * @param tz e.g. "CET-1CEST,M3.5.0,M10.5.0/3" (cut to TZ_SPEC_MAX - 1)
+     */
+    void postTimeZone(const char* tz);
+
+    /**
+     * Apply the posted timestamp and time zone (loop task only)
+     * @return TIME_PENDING_* bits of what was posted (an invalid zone is
+     *         reported too, the zone in effect is then unchanged)
+     */
+    uint8_t applyPending();
+
+    /**
+     * Get the current time snapshot
+     *
+     * Converts the RTC time at most once per second; calls within the same
+     * second return the cached snapshot without touching the RTC conversion
+     * or the heap.
+     * @return Snapshot, valid until the next call
+     */
+    const TimeSnapshot& snapshot();
+
     /**
      * Get current time
      * @param hour Output: Hour (0-23)
@@ -67,21 +147,21 @@ public:
     /**
      * Get formatted time string
      * @param format12Hour If true, returns 12-hour format (e.g., "3:45 PM"), otherwise 24-hour (e.g., "15:45")
-     * @return Time string
+     * @return Time string (held by the snapshot; valid until the next second)
      */
-    String getTimeString(bool format12Hour = false);
+    const char* getTimeString(bool format12Hour = false);
 
     /**
      * Get formatted date string
-     * @return Date string (e.g., "Jan 14, 2026")
+     * @return Date string (e.g., "Jan 14, 2026"; valid until the next second)
      */
-    String getDateString();
+    const char* getDateString();
 
     /**
      * Get day of week string
-     * @return Day name (e.g., "Monday")
+     * @return Day name (e.g., "Monday"; static string)
      */
-    String getDayOfWeekString();
+    const char* getDayOfWeekString();
 
     /**
      * Check if time has been synchronized
@@ -89,6 +169,37 @@ public:
      */
     bool isSynced();
 
+    /**
+     * Set and persist the local time zone
+     * @param tz POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+     * @return true if valid (an invalid string leaves the zone unchanged)
+     */
+    bool setTimeZone(const char* tz);
+
+    /**
+     * Get the POSIX TZ string in effect
+     */
+    const char* getTimeZone() const { return _zone.spec(); }
+
+    /**
+     * Get the time zone (UTC offsets and DST transitions)
+     */
+    TimeZone& zone() { return _zone; }
+
+    /**
+     * Get confidence in the current time
+     * @return SYNCED, ESTIMATED or UNKNOWN
+     */
+    TimeConfidence getConfidence() const { return _confidence; }
+
+    /**
+     * Write an NVS checkpoint if TIME_CHECKPOINT_INTERVAL_S has passed
+     *
+     * Call periodically (e.g. on hour change). Never writes while the time
+     * is UNKNOWN, so a bad clock can't overwrite a good checkpoint.
+     */
+    void checkpoint();
+
     /**
      * Get time since last sync
      * @return Milliseconds since last sync, or 0 if never synced
@@ -97,10 +208,27 @@ public:
 
 private:
     struct tm _timeinfo;
-    bool _synced;
+    TimeSnapshot _snapshot;
+    TimeZone _zone;
+    TimeConfidence _confidence;
     unsigned long _lastSyncMillis;
+    time_t _lastCheckpoint;
+
+    // Posted by other tasks, guarded by _pendingLock
+    portMUX_TYPE _pendingLock;
+    uint8_t _pendingFlags;
+    time_t _pendingTimestamp;
+    char _pendingTz[TZ_SPEC_MAX];
 
     void updateTimeinfo();
+    void invalidateSnapshot();
+    bool applyTimeZone(const char* tz);
+    void applyTimestamp(time_t timestamp);
+    void markSynced();
+    bool restoreFromRtc(time_t& timestamp, TimeConfidence& confidence);
+    bool restoreFromNvs(time_t& timestamp);
+    void saveRtcRecord();
+    void saveCheckpoint(time_t timestamp);
 };
 
 #endif // TIME_MANAGER_H
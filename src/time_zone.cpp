@@ -0,0 +1,297 @@
+#include "time_zone.h"
+
+static const int32_t SECONDS_PER_DAY = 86400;
+
+TimeZone::TimeZone()
+    : _stdOffset(0),
+      _dstOffset(0),
+      _hasDst(false),
+      _count(0),
+      _cursor(0),
+      _firstYear(0) {
+    memset(&_start, 0, sizeof(_start));
+    memset(&_end, 0, sizeof(_end));
+    strncpy(_spec, "UTC0", sizeof(_spec));
+}
+
+bool TimeZone::parse(const char* spec) {
+    if (spec == nullptr || strlen(spec) >= TZ_SPEC_MAX) {
+        return false;
+    }
+
+    // std offset [dst [offset] [,start[/time],end[/time]]]
+    const char* p = spec;
+    int32_t stdOffset;
+    int32_t dstOffset = 0;
+    bool hasDst = false;
+    Rule start = { 'M', 3, 2, 0, 0, 7200 };  // US rules when none are given
+    Rule end = { 'M', 11, 1, 0, 0, 7200 };
+
+    if (!parseName(p) || !parseOffset(p, stdOffset)) {
+        return false;
+    }
+    stdOffset = -stdOffset;  // POSIX offsets are west of UTC
+
+    if (*p != '\0') {
+        if (!parseName(p)) {
+            return false;
+        }
+        hasDst = true;
+        dstOffset = stdOffset + 3600;
+        if (*p != ',' && *p != '\0') {
+            if (!parseOffset(p, dstOffset)) {
+                return false;
+            }
+            dstOffset = -dstOffset;
+        }
+        if (*p != '\0') {
+            if (*p++ != ',' || !parseRule(p, start) || *p++ != ',' || !parseRule(p, end) || *p != '\0') {
+                return false;
+            }
+        }
+    }
+
+    strncpy(_spec, spec, sizeof(_spec) - 1);
+    _spec[sizeof(_spec) - 1] = '\0';
+    _stdOffset = stdOffset;
+    _dstOffset = dstOffset;
+    _hasDst = hasDst;
+    _start = start;
+    _end = end;
+    buildTable(yearOf(time(nullptr)));
+
+    Serial.printf("TimeZone: %s (UTC%+ld, DST %s, %d transitions from %d)\n",
+                  _spec, (long)(_stdOffset / 3600), _hasDst ? "yes" : "no", _count, _firstYear);
+    return true;
+}
+
+int32_t TimeZone::offsetAt(time_t utc) {
+    if (!_hasDst) {
+        return _stdOffset;
+    }
+
+    // Outside the table: rebuild only if the year isn't covered any more
+    if (utc < _table[0].utc || utc >= _table[_count - 1].utc) {
+        int year = yearOf(utc);
+        if (year < _firstYear || year >= _firstYear + TZ_TRANSITION_YEARS) {
+            buildTable(year);
+        }
+        if (utc < _table[0].utc) {
+            return (_table[0].offset == _dstOffset) ? _stdOffset : _dstOffset;
+        }
+    }
+
+    // Common case: same entry as last time, or the one after it
+    if (_table[_cursor].utc <= utc && (_cursor + 1 >= _count || utc < _table[_cursor + 1].utc)) {
+        return _table[_cursor].offset;
+    }
+    if (_cursor + 1 < _count && _table[_cursor + 1].utc <= utc &&
+        (_cursor + 2 >= _count || utc < _table[_cursor + 2].utc)) {
+        return _table[++_cursor].offset;
+    }
+
+    // Time jumped: binary search for the last transition at or before utc
+    uint8_t lo = 0;
+    uint8_t hi = _count - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi + 1) / 2;
+        if (_table[mid].utc <= utc) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    _cursor = lo;
+    return _table[_cursor].offset;
+}
+
+void TimeZone::toLocal(time_t utc, struct tm& local) {
+    int32_t offset = offsetAt(utc);
+    time_t shifted = utc + offset;
+    gmtime_r(&shifted, &local);
+    local.tm_isdst = (_hasDst && offset == _dstOffset) ? 1 : 0;
+}
+
+time_t TimeZone::toUtc(const struct tm& local) {
+    int64_t seconds = (int64_t)daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * SECONDS_PER_DAY +
+                      local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+
+    if (_hasDst) {
+        time_t candidate = (time_t)(seconds - _dstOffset);
+        if (offsetAt(candidate) == _dstOffset) {
+            return candidate;
+        }
+    }
+    return (time_t)(seconds - _stdOffset);
+}
+
+int32_t TimeZone::daysFromCivil(int year, int month, int day) {
+    // Howard Hinnant's days_from_civil
+    year -= (month <= 2) ? 1 : 0;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yoe = (uint32_t)(year - era * 400);
+    uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void TimeZone::buildTable(int firstYear) {
+    _count = 0;
+    _cursor = 0;
+    _firstYear = firstYear;
+    if (!_hasDst) {
+        return;
+    }
+
+    for (int year = firstYear; year < firstYear + TZ_TRANSITION_YEARS; year++) {
+        int64_t start = ruleInstant(_start, year, _stdOffset);
+        int64_t end = ruleInstant(_end, year, _dstOffset);
+
+        // Southern hemisphere zones end DST before they start it
+        if (start < end) {
+            _table[_count++] = { start, _dstOffset };
+            _table[_count++] = { end, _stdOffset };
+        } else {
+            _table[_count++] = { end, _stdOffset };
+            _table[_count++] = { start, _dstOffset };
+        }
+    }
+}
+
+int64_t TimeZone::ruleInstant(const Rule& rule, int year, int32_t offsetBefore) const {
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int32_t day;
+
+    if (rule.type == 'J') {
+        // 1-365, February 29 is never counted
+        day = daysFromCivil(year, 1, 1) + rule.day - 1 + ((leap && rule.day >= 60) ? 1 : 0);
+    } else if (rule.type == 'N') {
+        day = daysFromCivil(year, 1, 1) + rule.day;
+    } else {
+        // Weekday of the requested week, week 5 meaning the last one in the month
+        int32_t first = daysFromCivil(year, rule.month, 1);
+        int32_t next = (rule.month == 12) ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, rule.month + 1, 1);
+        int firstWeekday = ((first % 7) + 11) % 7;  // 1970-01-01 was a Thursday
+        day = first + (rule.weekday - firstWeekday + 7) % 7 + (rule.week - 1) * 7;
+        while (day >= next) {
+            day -= 7;
+        }
+    }
+
+    return (int64_t)day * SECONDS_PER_DAY + rule.time - offsetBefore;
+}
+
+bool TimeZone::parseName(const char*& p) {
+    const char* begin = p;
+    if (*p == '<') {
+        // Quoted form allows digits and signs, e.g. "<+03>-3"
+        begin = ++p;
+        while (*p != '\0' && *p != '>') {
+            p++;
+        }
+        if (*p != '>' || p - begin < 3) {
+            return false;
+        }
+        p++;
+        return true;
+    }
+
+    while (isalpha((unsigned char)*p)) {
+        p++;
+    }
+    return p - begin >= 3;
+}
+
+bool TimeZone::parseOffset(const char*& p, int32_t& seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = (*p == '-') ? -1 : 1;
+        p++;
+    }
+    if (!isdigit((unsigned char)*p)) {
+        return false;
+    }
+
+    // hh[:mm[:ss]]
+    int32_t parts[3] = { 0, 0, 0 };
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!isdigit((unsigned char)*p)) {
+            return false;
+        }
+        while (isdigit((unsigned char)*p)) {
+            parts[i] = parts[i] * 10 + (*p++ - '0');
+        }
+        if (*p != ':') {
+            break;
+        }
+        p++;
+    }
+    if (parts[0] > 167 || parts[1] > 59 || parts[2] > 59) {
+        return false;
+    }
+
+    seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+    return true;
+}
+
+bool TimeZone::parseRule(const char*& p, Rule& rule) {
+    memset(&rule, 0, sizeof(rule));
+    rule.time = 7200;  // 02:00 unless given
+
+    if (*p == 'M') {
+        p++;
+        int fields[3] = { 0, 0, 0 };
+        for (uint8_t i = 0; i < 3; i++) {
+            if (i > 0 && *p++ != '.') {
+                return false;
+            }
+            if (!isdigit((unsigned char)*p)) {
+                return false;
+            }
+            while (isdigit((unsigned char)*p)) {
+                fields[i] = fields[i] * 10 + (*p++ - '0');
+            }
+        }
+        if (fields[0] < 1 || fields[0] > 12 || fields[1] < 1 || fields[1] > 5 || fields[2] > 6) {
+            return false;
+        }
+        rule.type = 'M';
+        rule.month = fields[0];
+        rule.week = fields[1];
+        rule.weekday = fields[2];
+    } else {
+        rule.type = 'N';
+        if (*p == 'J') {
+            rule.type = 'J';
+            p++;
+        }
+        if (!isdigit((unsigned char)*p)) {
+            return false;
+        }
+        int day = 0;
+        while (isdigit((unsigned char)*p)) {
+            day = day * 10 + (*p++ - '0');
+        }
+        if ((rule.type == 'J' && (day < 1 || day > 365)) || day > 365) {
+            return false;
+        }
+        rule.day = day;
+    }
+
+    if (*p == '/') {
+        p++;
+        return parseOffset(p, rule.time);
+    }
+    return true;
+}
+
+int TimeZone::yearOf(int64_t utc) {
+    time_t t = (time_t)utc;
+    struct tm parts;
+    gmtime_r(&t, &parts);
+    return parts.tm_year + 1900;
+}
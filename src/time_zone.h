@@ -0,0 +1,110 @@
+#ifndef TIME_ZONE_H
+#define TIME_ZONE_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "config.h"
+
+/**
+ * TimeZone - POSIX TZ rules with a precomputed DST transition table
+ *
+ * Parses strings like "CET-1CEST,M3.5.0,M10.5.0/3" or "EST5EDT" and
+ * expands the DST rule into the UTC instants of the next few years'
+ * transitions. Converting a timestamp to local time is then a table
+ * lookup (normally the cached entry) instead of re-evaluating the rule.
+ */
+class TimeZone {
+public:
+    TimeZone();
+
+    /**
+     * Parse a POSIX TZ string
+     * @param spec e.g. "UTC0", "PST8PDT,M3.2.0,M11.1.0"
+     * @return true if valid; on failure the previous zone is kept
+     */
+    bool parse(const char* spec);
+
+    /**
+     * The TZ string in effect
+     */
+    const char* spec() const { return _spec; }
+
+    /**
+     * Whether the zone observes daylight saving time
+     */
+    bool hasDst() const { return _hasDst; }
+
+    /**
+     * UTC offset in effect at an instant
+     * @param utc Unix timestamp
+     * @return Seconds east of UTC (local = utc + offset)
+     */
+    int32_t offsetAt(time_t utc);
+
+    /**
+     * Convert a Unix timestamp to local broken-down time
+     * @param utc Unix timestamp
+     * @param local Output (tm_isdst set)
+     */
+    void toLocal(time_t utc, struct tm& local);
+
+    /**
+     * Convert local broken-down time to a Unix timestamp
+     *
+     * Times repeated when DST ends resolve to the first (DST) occurrence;
+     * times skipped when DST starts are read with the standard offset.
+     * @param local Local time (tm_isdst ignored)
+     */
+    time_t toUtc(const struct tm& local);
+
+    /**
+     * Days since 1970-01-01 for a proleptic Gregorian date
+     * @param month 1-12
+     */
+    static int32_t daysFromCivil(int year, int month, int day);
+
+private:
+    /**
+     * When DST starts or ends within a year
+     */
+    struct Rule {
+        char type;        // 'M' (month.week.day), 'J' (Julian 1-365, no leap day) or 'N' (0-365)
+        uint8_t month;    // 1-12 ('M')
+        uint8_t week;     // 1-5, 5 = last ('M')
+        uint8_t weekday;  // 0 = Sunday ('M')
+        uint16_t day;     // 'J' and 'N'
+        int32_t time;     // Seconds after local midnight (may be negative or > 24h)
+    };
+
+    /**
+     * Offset change at a UTC instant
+     */
+    struct Transition {
+        int64_t utc;
+        int32_t offset;  // Offset from this instant on
+    };
+
+    static const uint8_t MAX_TRANSITIONS = TZ_TRANSITION_YEARS * 2;
+
+    char _spec[TZ_SPEC_MAX];
+    int32_t _stdOffset;
+    int32_t _dstOffset;
+    bool _hasDst;
+    Rule _start;
+    Rule _end;
+
+    Transition _table[MAX_TRANSITIONS];
+    uint8_t _count;
+    uint8_t _cursor;     // Table entry in effect at the last lookup
+    int16_t _firstYear;  // First year covered by the table
+
+    void buildTable(int firstYear);
+    int64_t ruleInstant(const Rule& rule, int year, int32_t offsetBefore) const;
+
+    static bool parseName(const char*& p);
+    static bool parseOffset(const char*& p, int32_t& seconds);
+    static bool parseRule(const char*& p, Rule& rule);
+    static int yearOf(int64_t utc);
+};
+
+#endif // TIME_ZONE_H
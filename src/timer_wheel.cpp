@@ -0,0 +1,139 @@
+#include "timer_wheel.h"
+
+static const int64_t TICK_US = (int64_t)TIMER_WHEEL_TICK_MS * 1000;
+
+TimerWheel::TimerWheel()
+    : _processedTick(currentTick()) {
+    memset(_timers, 0, sizeof(_timers));
+    for (uint8_t i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+        _slots[i] = NONE;
+    }
+}
+
+TimerHandle TimerWheel::schedule(uint32_t delayMs, Callback callback, void* arg, uint32_t periodMs) {
+    if (callback == nullptr) {
+        return 0;
+    }
+
+    for (int8_t i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        Timer& timer = _timers[i];
+        if (timer.active) {
+            continue;
+        }
+
+        // Round the delay up to whole ticks, never into a tick already handled
+        int64_t ticks = ((int64_t)delayMs + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+        int64_t expiry = currentTick() + ticks;
+        timer.expiryTick = (expiry > _processedTick) ? expiry : _processedTick + 1;
+        timer.periodTicks = (periodMs + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS;
+        if (periodMs > 0 && timer.periodTicks == 0) {
+            timer.periodTicks = 1;
+        }
+        timer.callback = callback;
+        timer.arg = arg;
+        timer.generation++;
+        timer.active = true;
+        link(i);
+
+        return ((TimerHandle)timer.generation << 8) | (uint8_t)(i + 1);
+    }
+
+    Serial.println("TimerWheel: ERROR - No free timers!");
+    return 0;
+}
+
+void TimerWheel::cancel(TimerHandle& handle) {
+    int8_t index = indexOf(handle);
+    if (index != NONE) {
+        unlink(index);
+        _timers[index].active = false;
+    }
+    handle = 0;
+}
+
+bool TimerWheel::isActive(TimerHandle handle) const {
+    return indexOf(handle) != NONE;
+}
+
+void TimerWheel::poll() {
+    int64_t now = currentTick();
+    if (now <= _processedTick) {
+        return;
+    }
+
+    // After a stall longer than one revolution every slot is due once
+    int64_t first = _processedTick + 1;
+    if (now - first >= TIMER_WHEEL_SLOTS) {
+        first = now - TIMER_WHEEL_SLOTS + 1;
+    }
+    _processedTick = now;
+
+    for (int64_t tick = first; tick <= now; tick++) {
+        uint8_t slot = (uint8_t)(tick % TIMER_WHEEL_SLOTS);
+
+        // Rescan from the head after each callback, which may change the list
+        bool fired = true;
+        while (fired) {
+            fired = false;
+            for (int8_t i = _slots[slot]; i != NONE; i = _timers[i].next) {
+                Timer& timer = _timers[i];
+                if (timer.expiryTick > now) {
+                    continue;  // Later revolution
+                }
+
+                unlink(i);
+                if (timer.periodTicks > 0) {
+                    // Stay phase-locked to the original schedule
+                    do {
+                        timer.expiryTick += timer.periodTicks;
+                    } while (timer.expiryTick <= now);
+                    link(i);
+                } else {
+                    timer.active = false;
+                }
+
+                timer.callback(timer.arg);
+                fired = true;
+                break;
+            }
+        }
+    }
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+int64_t TimerWheel::currentTick() {
+    return MonoClock::nowUs() / TICK_US;
+}
+
+void TimerWheel::link(int8_t index) {
+    uint8_t slot = (uint8_t)(_timers[index].expiryTick % TIMER_WHEEL_SLOTS);
+    _timers[index].next = _slots[slot];
+    _slots[slot] = index;
+}
+
+void TimerWheel::unlink(int8_t index) {
+    uint8_t slot = (uint8_t)(_timers[index].expiryTick % TIMER_WHEEL_SLOTS);
+    int8_t* link = &_slots[slot];
+    while (*link != NONE) {
+        if (*link == index) {
+            *link = _timers[index].next;
+            return;
+        }
+        link = &_timers[*link].next;
+    }
+}
+
+int8_t TimerWheel::indexOf(TimerHandle handle) const {
+    uint8_t index = (handle & 0xFF);
+    if (index == 0 || index > TIMER_WHEEL_MAX_TIMERS) {
+        return NONE;
+    }
+    const Timer& timer = _timers[index - 1];
+    if (!timer.active || timer.generation != (uint8_t)(handle >> 8)) {
+        return NONE;
+    }
+    return index - 1;
+}
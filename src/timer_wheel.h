@@ -0,0 +1,82 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "mono_clock.h"
+
+/**
+ * Handle to a scheduled timer (0 = none)
+ */
+typedef uint16_t TimerHandle;
+
+/**
+ * TimerWheel - Hashed timer wheel driven by MonoClock
+ *
+ * Timers are hashed into TIMER_WHEEL_SLOTS buckets of TIMER_WHEEL_TICK_MS
+ * by expiry tick, so poll() only looks at the buckets for ticks that have
+ * passed. Periodic timers are rescheduled from their previous expiry, not
+ * from when poll() ran, so loop jitter doesn't accumulate.
+ *
+ * Callbacks run from poll() in the caller's task. Fixed capacity, no heap.
+ */
+class TimerWheel {
+public:
+    /**
+     * Timer callback
+     * @param arg Value passed to schedule()
+     */
+    typedef void (*Callback)(void* arg);
+
+    TimerWheel();
+
+    /**
+     * Schedule a timer
+     * @param delayMs Delay until the first expiry (0 = next poll)
+     * @param callback Function to call
+     * @param arg Passed to the callback
+     * @param periodMs Repeat interval, 0 for one-shot
+     * @return Handle, or 0 if all TIMER_WHEEL_MAX_TIMERS are in use
+     */
+    TimerHandle schedule(uint32_t delayMs, Callback callback, void* arg = nullptr, uint32_t periodMs = 0);
+
+    /**
+     * Cancel a timer (stale or zero handles are ignored)
+     * @param handle Handle from schedule(); set to 0
+     */
+    void cancel(TimerHandle& handle);
+
+    /**
+     * Check if a timer is still scheduled
+     */
+    bool isActive(TimerHandle handle) const;
+
+    /**
+     * Fire all expired timers (call from loop)
+     */
+    void poll();
+
+private:
+    static const int8_t NONE = -1;
+
+    struct Timer {
+        int64_t expiryTick;
+        uint32_t periodTicks;
+        Callback callback;
+        void* arg;
+        int8_t next;         // Next timer in the same slot
+        uint8_t generation;  // Bumped on every reuse so stale handles can't cancel a new timer
+        bool active;
+    };
+
+    Timer _timers[TIMER_WHEEL_MAX_TIMERS];
+    int8_t _slots[TIMER_WHEEL_SLOTS];  // Head of each slot's list
+    int64_t _processedTick;            // Last tick poll() has handled
+
+    static int64_t currentTick();
+    void link(int8_t index);
+    void unlink(int8_t index);
+    int8_t indexOf(TimerHandle handle) const;
+};
+
+#endif // TIMER_WHEEL_H
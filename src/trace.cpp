@@ -0,0 +1,107 @@
+#include "trace.h"
+#include <esp_timer.h>
+
+static const char* const TRACE_NAMES[TRACE_ID_COUNT] = {
+    "audio.decode", "audio.i2s_write", "display.refresh", "ble.callback",
+    "ble.connect", "nvs.commit", "alarm.fired", "button"
+};
+static const char PHASE_LETTERS[] = { 'B', 'E', 'I' };
+
+Trace::Event Trace::_ring[TRACE_EVENTS];
+std::atomic<uint32_t> Trace::_next(0);
+std::atomic<bool> Trace::_enabled(true);
+TaskHandle_t Trace::_tasks[TRACE_MAX_TASKS];
+char Trace::_taskNames[TRACE_MAX_TASKS][configMAX_TASK_NAME_LEN];
+std::atomic<uint8_t> Trace::_taskCount(0);
+
+static portMUX_TYPE taskMux = portMUX_INITIALIZER_UNLOCKED;
+
+void Trace::clear() {
+    bool wasEnabled = _enabled.exchange(false);
+    _next.store(0, std::memory_order_relaxed);
+    _enabled.store(wasEnabled);
+}
+
+void Trace::dump() {
+    // Pause so the ring is not overwritten while it is printed; a writer
+    // that passed the enabled check just before may still land one event
+    bool wasEnabled = _enabled.exchange(false);
+    delay(1);
+
+    uint32_t next = _next.load(std::memory_order_acquire);
+    uint32_t count = (next < TRACE_EVENTS) ? next : TRACE_EVENTS;
+    uint8_t tasks = _taskCount.load(std::memory_order_acquire);
+
+    // Header: totals, then one line per task and per trace point
+    Serial.printf("TRACE begin events=%u lost=%u\n", count, next - count);
+    for (uint8_t i = 0; i < tasks; i++) {
+        Serial.printf("TRACE task %u %s\n", i, _taskNames[i]);
+    }
+    for (uint8_t i = 0; i < TRACE_ID_COUNT; i++) {
+        Serial.printf("TRACE name %u %s\n", i, TRACE_NAMES[i]);
+    }
+
+    // Events: "TRACE e <us> <phase> <task> <id> <arg>"
+    for (uint32_t i = next - count; i != next; i++) {
+        const Event& event = _ring[i % TRACE_EVENTS];
+        Serial.printf("TRACE e %u %c %u %u %u\n", event.us, PHASE_LETTERS[event.phaseTask >> 6],
+                      event.phaseTask & NO_TASK, event.id, event.arg);
+    }
+    Serial.println("TRACE end");
+
+    _enabled.store(wasEnabled);
+}
+
+void Trace::printStatus() {
+    uint32_t next = _next.load(std::memory_order_relaxed);
+    Serial.printf("Trace: %s, %u events recorded, %u kept (%u bytes), %u tasks\n",
+                  isEnabled() ? "recording" : "paused", next,
+                  (next < TRACE_EVENTS) ? next : TRACE_EVENTS, (unsigned)sizeof(_ring),
+                  _taskCount.load(std::memory_order_relaxed));
+}
+
+// ============================================
+// Private Methods
+// ============================================
+
+void Trace::record(TraceId id, Phase phase, uint16_t arg) {
+    if (!_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    uint32_t slot = _next.fetch_add(1, std::memory_order_relaxed);
+    Event& event = _ring[slot % TRACE_EVENTS];
+    event.us = (uint32_t)esp_timer_get_time();
+    event.arg = arg;
+    event.id = id;
+    event.phaseTask = (phase << 6) | taskIndex();
+}
+
+uint8_t Trace::taskIndex() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    uint8_t count = _taskCount.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < count; i++) {
+        if (_tasks[i] == self) {
+            return i;
+        }
+    }
+
+    // First event from this task: register it (rare, so a critical section is fine)
+    uint8_t index = NO_TASK;
+    portENTER_CRITICAL(&taskMux);
+    count = _taskCount.load(std::memory_order_relaxed);
+    for (uint8_t i = 0; i < count; i++) {
+        if (_tasks[i] == self) {
+            index = i;
+        }
+    }
+    if (index == NO_TASK && count < TRACE_MAX_TASKS) {
+        // The name is copied because the task may be deleted before a dump
+        strncpy(_taskNames[count], pcTaskGetName(self), configMAX_TASK_NAME_LEN - 1);
+        _taskNames[count][configMAX_TASK_NAME_LEN - 1] = '\0';
+        _tasks[count] = self;
+        index = count;
+        _taskCount.store(count + 1, std::memory_order_release);
+    }
+    portEXIT_CRITICAL(&taskMux);
+    return index;
+}
@@ -0,0 +1,100 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * Trace points (names in trace.cpp; keep both lists in the same order)
+ */
+enum TraceId : uint8_t {
+    TRACE_AUDIO_DECODE = 0,   // One MP3/WAV decoder step (AudioTest::loop)
+    TRACE_AUDIO_I2S_WRITE,    // i2s_write of PCM or tone samples; arg = bytes
+    TRACE_DISPLAY_REFRESH,    // Full draw + panel update incl. BUSY wait; arg = 1 full, 0 partial
+    TRACE_BLE_CALLBACK,       // BLE characteristic callback; arg = attribute handle
+    TRACE_BLE_CONNECT,        // Instant; arg = 1 connect, 0 disconnect
+    TRACE_NVS_COMMIT,         // NVS write + commit; arg = keys written
+    TRACE_ALARM_FIRED,        // Instant; arg = alarm id
+    TRACE_BUTTON,             // Instant; arg = button pin
+    TRACE_ID_COUNT
+};
+
+/**
+ * Trace - Flight recorder of timestamped events across tasks
+ *
+ * Each event is 8 bytes (32-bit microsecond timestamp, id, phase, task
+ * index, 16-bit argument) in a ring of TRACE_EVENTS that keeps the most
+ * recent events. Recording is a single atomic increment and a store, so
+ * it is safe from any task (not from ISRs). Tasks are numbered in the
+ * order they first record an event.
+ *
+ * "trace dump" prints the ring as text lines; tools/trace_to_chrome.py
+ * turns a capture into Chrome trace JSON (chrome://tracing, Perfetto).
+ *
+ * Usage: { TraceScope scope(TRACE_DISPLAY_REFRESH); ... }
+ *        Trace::instant(TRACE_ALARM_FIRED, id);
+ */
+class Trace {
+public:
+    enum Phase : uint8_t { PHASE_BEGIN = 0, PHASE_END = 1, PHASE_INSTANT = 2 };
+
+    static void begin(TraceId id, uint16_t arg = 0) { record(id, PHASE_BEGIN, arg); }
+    static void end(TraceId id, uint16_t arg = 0) { record(id, PHASE_END, arg); }
+    static void instant(TraceId id, uint16_t arg = 0) { record(id, PHASE_INSTANT, arg); }
+
+    /**
+     * Pause or resume recording (recording is on from boot)
+     */
+    static void setEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Discard all recorded events
+     */
+    static void clear();
+
+    /**
+     * Print the recorded events, oldest first (recording pauses meanwhile)
+     */
+    static void dump();
+
+    /**
+     * Print event count and memory use
+     */
+    static void printStatus();
+
+private:
+    struct Event {
+        uint32_t us;
+        uint16_t arg;
+        uint8_t id;
+        uint8_t phaseTask;  // Phase in bits 6-7, task index in bits 0-5
+    };
+
+    static const uint8_t NO_TASK = 0x3F;
+
+    static Event _ring[TRACE_EVENTS];
+    static std::atomic<uint32_t> _next;  // Total events recorded (index of the next slot)
+    static std::atomic<bool> _enabled;
+    static TaskHandle_t _tasks[TRACE_MAX_TASKS];
+    static char _taskNames[TRACE_MAX_TASKS][configMAX_TASK_NAME_LEN];
+    static std::atomic<uint8_t> _taskCount;
+
+    static void record(TraceId id, Phase phase, uint16_t arg);
+    static uint8_t taskIndex();
+};
+
+/**
+ * Records a begin event now and the matching end event when it goes out of scope
+ */
+class TraceScope {
+public:
+    explicit TraceScope(TraceId id, uint16_t arg = 0) : _id(id) { Trace::begin(id, arg); }
+    ~TraceScope() { Trace::end(_id); }
+
+private:
+    TraceId _id;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,95 @@
+#include "wav_parser.h"
+#include <string.h>
+
+static uint32_t readLe32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t readLe16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+struct MemorySource {
+    const uint8_t* data;
+    size_t size;
+};
+
+static size_t readMemory(void* context, uint32_t offset, uint8_t* buffer, size_t length) {
+    const MemorySource* source = (const MemorySource*)context;
+    if (offset >= source->size) {
+        return 0;
+    }
+    if (length > source->size - offset) {
+        length = source->size - offset;
+    }
+    memcpy(buffer, source->data + offset, length);
+    return length;
+}
+
+WavResult WavParser::parse(ReadFn read, void* context, uint32_t size, WavFormat& format) {
+    memset(&format, 0, sizeof(format));
+
+    uint8_t header[16];
+    if (size < 12 || read(context, 0, header, 12) != 12 ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return WAV_NOT_RIFF;
+    }
+
+    // Walk chunks: "fmt " must come before "data"; anything else is skipped
+    WavFormat found;
+    memset(&found, 0, sizeof(found));
+    bool haveFormat = false;
+    uint32_t offset = 12;
+
+    while (offset + 8 <= size && read(context, offset, header, 8) == 8) {
+        uint32_t chunkSize = readLe32(header + 4);
+        bool isFormat = memcmp(header, "fmt ", 4) == 0;
+        bool isData = memcmp(header, "data", 4) == 0;
+        offset += 8;
+
+        if (isFormat) {
+            if (chunkSize < 16 || read(context, offset, header, 16) != 16) {
+                return WAV_NO_FORMAT;
+            }
+            found.audioFormat = readLe16(header);
+            found.channels = (uint8_t)readLe16(header + 2);
+            found.sampleRate = readLe32(header + 4);
+            found.byteRate = readLe32(header + 8);
+            found.bits = (uint8_t)readLe16(header + 14);
+            haveFormat = true;
+        } else if (isData) {
+            if (!haveFormat) {
+                return WAV_NO_FORMAT;
+            }
+            found.dataOffset = offset;
+            found.dataSize = (chunkSize < size - offset) ? chunkSize : size - offset;
+            format = found;
+            return WAV_OK;
+        }
+
+        if (chunkSize > size - offset) {
+            break;
+        }
+        offset += chunkSize + (chunkSize & 1);  // Chunks are word aligned
+    }
+    return haveFormat ? WAV_NO_DATA : WAV_NO_FORMAT;
+}
+
+WavResult WavParser::parse(const uint8_t* data, size_t size, WavFormat& format) {
+    MemorySource source = { data, size };
+    return parse(readMemory, &source, (uint32_t)size, format);
+}
+
+uint32_t WavParser::durationMs(const WavFormat& format) {
+    return format.byteRate ? (uint32_t)((uint64_t)format.dataSize * 1000 / format.byteRate) : 0;
+}
+
+const char* WavParser::describe(WavResult result) {
+    switch (result) {
+        case WAV_OK:        return "OK";
+        case WAV_NOT_RIFF:  return "not a RIFF/WAVE file";
+        case WAV_NO_FORMAT: return "fmt chunk not found";
+        case WAV_NO_DATA:   return "data chunk not found";
+    }
+    return "unknown";
+}
@@ -0,0 +1,73 @@
+#ifndef WAV_PARSER_H
+#define WAV_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Stream parameters and PCM location of a WAV file
+ */
+struct WavFormat {
+    uint16_t audioFormat;  // 1 = PCM
+    uint8_t channels;
+    uint8_t bits;
+    uint32_t sampleRate;   // Hz
+    uint32_t byteRate;     // Bytes per second
+    uint32_t dataOffset;   // Start of PCM data, relative to the start of the sound
+    uint32_t dataSize;     // PCM bytes (clamped to the sound's length)
+};
+
+/**
+ * @brief Outcome of WavParser::parse
+ */
+enum WavResult : uint8_t {
+    WAV_OK = 0,
+    WAV_NOT_RIFF,   // No "RIFF....WAVE" header
+    WAV_NO_FORMAT,  // No usable "fmt " chunk before "data"
+    WAV_NO_DATA     // No "data" chunk within the sound
+};
+
+/**
+ * @brief WavParser - RIFF/WAVE chunk walker
+ *
+ * Depends on no hardware or filesystem API: bytes are fetched through a
+ * read callback, so the same parser serves SPIFFS files, sound bank
+ * payloads and memory buffers (and builds on the host). Never reads past
+ * the given sound length.
+ */
+class WavParser {
+public:
+    /**
+     * @brief Read callback
+     * @param context Caller's data (e.g. an open file)
+     * @param offset Offset relative to the start of the sound
+     * @return Bytes read
+     */
+    typedef size_t (*ReadFn)(void* context, uint32_t offset, uint8_t* buffer, size_t length);
+
+    /**
+     * @brief Parse a WAV header
+     * @param read Read callback
+     * @param context Passed to read
+     * @param size Length of the sound in bytes
+     * @param format Output (zeroed unless WAV_OK)
+     */
+    static WavResult parse(ReadFn read, void* context, uint32_t size, WavFormat& format);
+
+    /**
+     * @brief Parse a WAV file held in memory
+     */
+    static WavResult parse(const uint8_t* data, size_t size, WavFormat& format);
+
+    /**
+     * @brief Play time of the PCM data (0 if unknown)
+     */
+    static uint32_t durationMs(const WavFormat& format);
+
+    /**
+     * @brief Short description of a result for log messages
+     */
+    static const char* describe(WavResult result);
+};
+
+#endif // WAV_PARSER_H
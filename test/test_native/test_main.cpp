@@ -0,0 +1,800 @@
+/**
+ * Host tests for the firmware core (pio test -e native)
+ *
+ * Runs against the HAL stand-ins in hal/native: NVS lives in memory and
+ * SPIFFS in a scratch directory, both reset before every test.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include <esp_system.h>
+#include <unity.h>
+#include "alarm_manager.h"
+#include "alarm_protocol.h"
+#include "alloc_counter.h"
+#include "board_profile.h"
+#include "fixed_string.h"
+#include "frontlight_manager.h"
+#include "hal_native.h"
+#include "loop_monitor.h"
+#include "object_slot.h"
+#include "profile_scheduler.h"
+#include "settings_store.h"
+#include "sound_bank.h"
+#include "task_monitor.h"
+#include "time_manager.h"
+#include "time_zone.h"
+#include "timer_wheel.h"
+#include "wav_parser.h"
+
+// Defined in main.cpp on the device
+SettingsStore settings;
+
+void setUp() {
+    HalNative::resetNvs();
+    HalNative::setFsRoot(".pio/native_fs");
+    HalNative::clearFs();
+}
+
+void tearDown() {}
+
+// ============================================
+// WAV parser
+// ============================================
+
+static size_t putChunk(uint8_t* p, const char* id, uint32_t size) {
+    memcpy(p, id, 4);
+    p[4] = size & 0xFF;
+    p[5] = (size >> 8) & 0xFF;
+    p[6] = (size >> 16) & 0xFF;
+    p[7] = (size >> 24) & 0xFF;
+    return 8;
+}
+
+// RIFF header, a 3-byte LIST chunk (padded), fmt (16 kHz mono 16-bit), data
+static size_t buildWav(uint8_t* wav, uint32_t dataBytes) {
+    size_t n = 0;
+    memset(wav, 0, 128);
+    n += putChunk(wav + n, "RIFF", 0);
+    memcpy(wav + n, "WAVE", 4);
+    n += 4;
+    n += putChunk(wav + n, "LIST", 3);
+    n += 4;
+    n += putChunk(wav + n, "fmt ", 16);
+    const uint8_t fmt[16] = { 1, 0, 1, 0, 0x80, 0x3E, 0, 0, 0x00, 0x7D, 0, 0, 2, 0, 16, 0 };
+    memcpy(wav + n, fmt, sizeof(fmt));
+    n += sizeof(fmt);
+    n += putChunk(wav + n, "data", dataBytes);
+    return n;
+}
+
+void test_wav_skips_unknown_chunks() {
+    uint8_t wav[128];
+    size_t header = buildWav(wav, 64);
+    WavFormat format;
+
+    TEST_ASSERT_EQUAL(WAV_OK, WavParser::parse(wav, header + 64, format));
+    TEST_ASSERT_EQUAL_UINT16(1, format.audioFormat);
+    TEST_ASSERT_EQUAL_UINT8(1, format.channels);
+    TEST_ASSERT_EQUAL_UINT8(16, format.bits);
+    TEST_ASSERT_EQUAL_UINT32(16000, format.sampleRate);
+    TEST_ASSERT_EQUAL_UINT32(header, format.dataOffset);
+    TEST_ASSERT_EQUAL_UINT32(64, format.dataSize);
+    TEST_ASSERT_EQUAL_UINT32(2, WavParser::durationMs(format));
+}
+
+void test_wav_clamps_data_to_sound_length() {
+    uint8_t wav[128];
+    size_t header = buildWav(wav, 1000000);
+    WavFormat format;
+
+    TEST_ASSERT_EQUAL(WAV_OK, WavParser::parse(wav, header + 10, format));
+    TEST_ASSERT_EQUAL_UINT32(10, format.dataSize);
+}
+
+void test_wav_rejects_bad_input() {
+    uint8_t wav[128];
+    size_t header = buildWav(wav, 0);
+    WavFormat format;
+
+    TEST_ASSERT_EQUAL(WAV_NOT_RIFF, WavParser::parse(wav, 8, format));
+    TEST_ASSERT_EQUAL(WAV_NO_DATA, WavParser::parse(wav, header - 8, format));
+    memcpy(wav, "RIFX", 4);
+    TEST_ASSERT_EQUAL(WAV_NOT_RIFF, WavParser::parse(wav, header, format));
+}
+
+// ============================================
+// Alarm protocol
+// ============================================
+
+void test_alarm_json_round_trip() {
+    AlarmData alarm;
+    alarm.id = 3;
+    alarm.hour = 6;
+    alarm.minute = 45;
+    alarm.daysOfWeek = 0x3E;
+    alarm.sound = "birds.mp3";
+    alarm.enabled = true;
+    alarm.label = "Work";
+    alarm.snoozeEnabled = false;
+
+    FixedString<AlarmProtocol::ALARM_JSON_MAX> json;
+    AlarmProtocol::appendAlarm(alarm, json);
+    TEST_ASSERT_FALSE(json.truncated());
+
+    AlarmData parsed;
+    TEST_ASSERT_TRUE(AlarmProtocol::parseAlarm(json.c_str(), parsed));
+    TEST_ASSERT_EQUAL_UINT8(3, parsed.id);
+    TEST_ASSERT_EQUAL_UINT8(6, parsed.hour);
+    TEST_ASSERT_EQUAL_UINT8(45, parsed.minute);
+    TEST_ASSERT_EQUAL_UINT8(0x3E, parsed.daysOfWeek);
+    TEST_ASSERT_EQUAL_STRING("birds.mp3", parsed.sound.c_str());
+    TEST_ASSERT_TRUE(parsed.enabled);
+    TEST_ASSERT_EQUAL_STRING(alarm.label.c_str(), parsed.label.c_str());
+    TEST_ASSERT_FALSE(parsed.snoozeEnabled);
+}
+
+void test_alarm_json_requires_time() {
+    AlarmData alarm;
+    TEST_ASSERT_FALSE(AlarmProtocol::parseAlarm("{\"id\":1,\"hour\":7}", alarm));
+    TEST_ASSERT_TRUE(AlarmProtocol::parseAlarm("{\"id\":1,\"hour\":7,\"minute\":0}", alarm));
+    TEST_ASSERT_EQUAL_STRING("tone1", alarm.sound.c_str());
+    TEST_ASSERT_TRUE(alarm.snoozeEnabled);
+}
+
+// ============================================
+// Fixed strings
+// ============================================
+
+void test_fixed_string_truncates_without_overflow() {
+    FixedString<8> text("alarm");
+    text.appendf("_%u", 12u);
+    TEST_ASSERT_EQUAL_STRING("alarm_12", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+
+    text += "345";
+    TEST_ASSERT_EQUAL_STRING("alarm_12", text.c_str());
+    TEST_ASSERT_TRUE(text.truncated());
+    text.appendf("%s", "x");
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+
+    text = "a,b";
+    TEST_ASSERT_FALSE(text.truncated());
+    FixedString<8> copy(text);
+    TEST_ASSERT_TRUE(copy == "a,b");
+}
+
+void test_string_view_splits_fields() {
+    StringView command("START:birds.mp3:1024");
+    TEST_ASSERT_TRUE(command.startsWith("START:"));
+    int colon = command.indexOf(':', 6);
+    TEST_ASSERT_EQUAL_INT(15, colon);
+    TEST_ASSERT_TRUE(command.substring(6, colon) == "birds.mp3");
+    TEST_ASSERT_EQUAL_UINT32(1024, command.substring(colon + 1).toUInt());
+    TEST_ASSERT_EQUAL_INT(-1, command.indexOf(':', 16));
+    TEST_ASSERT_TRUE(command.substring(40).isEmpty());
+}
+
+// ============================================
+// Object slots
+// ============================================
+
+static int liveObjects = 0;
+
+struct Tracked {
+    explicit Tracked(int value) : value(value) { liveObjects++; }
+    ~Tracked() { liveObjects--; }
+    int value;
+};
+
+void test_object_slot_reuses_storage_without_heap() {
+    ObjectSlot<Tracked> slot;
+    TEST_ASSERT_TRUE(slot.isEmpty());
+
+    uint32_t allocsBefore = AllocCounter::total();
+    Tracked* first = slot.create(1);
+    Tracked* second = slot.create(2);  // Destroys the first
+    TEST_ASSERT_TRUE(first == second);
+    TEST_ASSERT_EQUAL_INT(2, slot.get()->value);
+    TEST_ASSERT_EQUAL_INT(1, liveObjects);
+
+    slot.destroy();
+    slot.destroy();
+    TEST_ASSERT_EQUAL_INT(0, liveObjects);
+    TEST_ASSERT_TRUE(slot.isEmpty());
+    TEST_ASSERT_EQUAL_UINT32(allocsBefore, AllocCounter::total());
+}
+
+// ============================================
+// Board profiles
+// ============================================
+
+void test_board_pins_rejects_conflicts() {
+    TEST_ASSERT_TRUE(BoardCheck::pinsValid(Board::PINS));
+
+    BoardPins pins = Esp32LBoard::PINS;
+    pins.frontlight = pins.i2sDout;  // Shared pin
+    TEST_ASSERT_FALSE(BoardCheck::pinsValid(pins));
+
+    pins = Esp32LBoard::PINS;
+    pins.epdCs = 7;  // Flash pin
+    TEST_ASSERT_FALSE(BoardCheck::pinsValid(pins));
+
+    pins = Esp32LBoard::PINS;
+    pins.i2sDout = 35;  // Input-only pin as an output
+    TEST_ASSERT_FALSE(BoardCheck::pinsValid(pins));
+    pins = Esp32LBoard::PINS;
+    pins.button = 35;  // ...is fine as an input
+    TEST_ASSERT_TRUE(BoardCheck::pinsValid(pins));
+
+    pins.frontlight = PIN_NONE;
+    pins.epdRst = PIN_NONE;  // Unconnected pins never conflict
+    TEST_ASSERT_TRUE(BoardCheck::pinsValid(pins));
+}
+
+// ============================================
+// Settings store
+// ============================================
+
+void test_settings_coalesce_slider_writes() {
+    HalNative::useManualClock(true);
+    settings.begin();
+    SettingsStats before = settings.getStats();
+
+    // Dragging the brightness slider: a new value every 100 ms
+    for (uint8_t level = 12; level <= 62; level += 5) {
+        settings.setBrightness(level);
+        HalNative::advanceMillis(100);
+        settings.update();
+    }
+    settings.setBrightness(62);  // Unchanged, not counted
+    TEST_ASSERT_TRUE(settings.isDirty());
+
+    HalNative::advanceMillis(SETTINGS_COMMIT_DELAY_MS - 200);  // 100 ms short of settling
+    settings.update();
+    TEST_ASSERT_EQUAL_UINT32(before.commits, settings.getStats().commits);
+
+    HalNative::advanceMillis(200);
+    settings.update();
+    const SettingsStats& after = settings.getStats();
+    TEST_ASSERT_FALSE(settings.isDirty());
+    TEST_ASSERT_EQUAL_UINT32(before.changes + 11, after.changes);
+    TEST_ASSERT_EQUAL_UINT32(before.commits + 1, after.commits);
+    TEST_ASSERT_EQUAL_UINT32(before.keyWrites + 1, after.keyWrites);
+
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin(SETTINGS_NAMESPACE, true));
+    TEST_ASSERT_EQUAL_UINT8(62, prefs.getUChar("brightness"));
+    prefs.end();
+
+    HalNative::useManualClock(false);
+}
+
+// ============================================
+// Frontlight
+// ============================================
+
+void test_frontlight_holds_level_during_fade() {
+    HalNative::useManualClock(true);
+    FrontlightManager light;
+    light.begin();
+
+    light.setBrightnessTemporary(100, 800);
+    uint32_t writes = HalNative::ledcWrites(0);
+    light.setBrightnessTemporary(20);       // Would wait on the LEDC fade lock
+    light.setBrightnessTemporary(30, 200);  // Replaces the held level
+    TEST_ASSERT_EQUAL_UINT32(writes, HalNative::ledcWrites(0));
+
+    HalNative::advanceMillis(799);
+    light.update();
+    TEST_ASSERT_EQUAL_UINT32(writes, HalNative::ledcWrites(0));
+    HalNative::advanceMillis(1);
+    light.update();
+    TEST_ASSERT_EQUAL_UINT32(writes + 1, HalNative::ledcWrites(0));
+    TEST_ASSERT_EQUAL_UINT32(200, HalNative::ledcFadeMs(0));
+    TEST_ASSERT_EQUAL_UINT32(128, HalNative::ledcDuty(0));  // L* 30 of 2047
+
+    HalNative::useManualClock(false);
+}
+
+// ============================================
+// Timer wheel
+// ============================================
+
+static int64_t fakeNowUs = 0;
+static int64_t fakeClock() { return fakeNowUs; }
+
+static void advanceTo(TimerWheel& wheel, int64_t ms) {
+    fakeNowUs = ms * 1000;
+    wheel.poll();
+}
+
+static int fireCount = 0;
+static void countFire(void*) { fireCount++; }
+
+void test_timer_wheel_rounds_expiry_up() {
+    MonoClock::setSource(fakeClock);
+    fakeNowUs = 0;
+    fireCount = 0;
+    TimerWheel wheel;
+
+    wheel.schedule(25, countFire);  // 2.5 ticks -> tick 3
+    advanceTo(wheel, 29);
+    TEST_ASSERT_EQUAL_INT(0, fireCount);
+    advanceTo(wheel, 30);
+    TEST_ASSERT_EQUAL_INT(1, fireCount);
+
+    // A zero delay never fires in the tick poll() has already handled
+    TimerHandle handle = wheel.schedule(0, countFire);
+    advanceTo(wheel, 35);
+    TEST_ASSERT_EQUAL_INT(1, fireCount);
+    advanceTo(wheel, 40);
+    TEST_ASSERT_EQUAL_INT(2, fireCount);
+    TEST_ASSERT_FALSE(wheel.isActive(handle));
+
+    MonoClock::setSource(nullptr);
+}
+
+void test_timer_wheel_periodic_stays_phase_locked() {
+    MonoClock::setSource(fakeClock);
+    fakeNowUs = 0;
+    fireCount = 0;
+    TimerWheel wheel;
+
+    TimerHandle handle = wheel.schedule(100, countFire, nullptr, 100);
+    advanceTo(wheel, 135);  // Polled late
+    TEST_ASSERT_EQUAL_INT(1, fireCount);
+    advanceTo(wheel, 199);  // Next expiry is 200, not 235
+    TEST_ASSERT_EQUAL_INT(1, fireCount);
+    advanceTo(wheel, 200);
+    TEST_ASSERT_EQUAL_INT(2, fireCount);
+
+    // A stall of several revolutions fires once, then keeps the original phase
+    wheel.schedule(500, countFire);
+    advanceTo(wheel, 200 + 3 * TIMER_WHEEL_SLOTS * TIMER_WHEEL_TICK_MS + 50);  // 1210 ms
+    TEST_ASSERT_EQUAL_INT(4, fireCount);  // Periodic once, one-shot once
+    advanceTo(wheel, 1299);
+    TEST_ASSERT_EQUAL_INT(4, fireCount);
+    advanceTo(wheel, 1300);
+    TEST_ASSERT_EQUAL_INT(5, fireCount);
+    TEST_ASSERT_TRUE(wheel.isActive(handle));
+
+    MonoClock::setSource(nullptr);
+}
+
+void test_timer_wheel_stale_handle_ignored() {
+    MonoClock::setSource(fakeClock);
+    fakeNowUs = 0;
+    fireCount = 0;
+    TimerWheel wheel;
+
+    TimerHandle first = wheel.schedule(50, countFire);
+    TimerHandle stale = first;
+    wheel.cancel(first);
+    TEST_ASSERT_EQUAL_UINT16(0, first);
+
+    // Same timer slot, new generation
+    TimerHandle second = wheel.schedule(50, countFire);
+    TEST_ASSERT_EQUAL_UINT8(stale & 0xFF, second & 0xFF);
+    TEST_ASSERT_TRUE(second != stale);
+    TEST_ASSERT_FALSE(wheel.isActive(stale));
+    wheel.cancel(stale);
+    TEST_ASSERT_TRUE(wheel.isActive(second));
+    advanceTo(wheel, 50);
+    TEST_ASSERT_EQUAL_INT(1, fireCount);
+
+    MonoClock::setSource(nullptr);
+}
+
+// ============================================
+// Time zone
+// ============================================
+
+void test_time_zone_dst_offsets() {
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("CET-1CEST,M3.5.0,M10.5.0/3"));
+    TEST_ASSERT_TRUE(zone.hasDst());
+    TEST_ASSERT_EQUAL_INT32(3600, zone.offsetAt(1767225600));   // 2026-01-01 00:00 UTC
+    TEST_ASSERT_EQUAL_INT32(7200, zone.offsetAt(1782864000));   // 2026-07-01 00:00 UTC
+    TEST_ASSERT_EQUAL_INT32(3600, zone.offsetAt(1774746000 - 1));  // 2026-03-29 00:59:59 UTC
+    TEST_ASSERT_EQUAL_INT32(7200, zone.offsetAt(1774746000));      // 01:00 UTC, clocks go forward
+    TEST_ASSERT_FALSE(zone.parse("not a zone"));
+}
+
+void test_time_zone_resolves_repeated_and_skipped_hours() {
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+    // 02:30 doesn't exist on 2026-03-29: read with the standard offset (shown as 03:30 CEST)
+    struct tm local = {};
+    local.tm_year = 2026 - 1900;
+    local.tm_mon = 2;
+    local.tm_mday = 29;
+    local.tm_hour = 2;
+    local.tm_min = 30;
+    TEST_ASSERT_EQUAL_UINT32(1774747800, (uint32_t)zone.toUtc(local));  // 01:30 UTC
+
+    // 02:30 happens twice on 2026-10-25: the first (CEST) one is taken
+    local.tm_mon = 9;
+    local.tm_mday = 25;
+    TEST_ASSERT_EQUAL_UINT32(1792888200, (uint32_t)zone.toUtc(local));  // 00:30 UTC
+
+    // Ordinary times round-trip
+    zone.toLocal(1768392000, local);
+    TEST_ASSERT_EQUAL_UINT32(1768392000, (uint32_t)zone.toUtc(local));
+}
+
+void test_time_zone_southern_hemisphere_rule() {
+    // Sydney: DST from the first Sunday of October to the first Sunday of April
+    TimeZone zone;
+    TEST_ASSERT_TRUE(zone.parse("AEST-10AEDT,M10.1.0,M4.1.0/3"));
+    TEST_ASSERT_EQUAL_INT32(39600, zone.offsetAt(1768438800));      // 2026-01-15 01:00 UTC
+    TEST_ASSERT_EQUAL_INT32(36000, zone.offsetAt(1784080800));      // 2026-07-15 02:00 UTC
+    TEST_ASSERT_EQUAL_INT32(39600, zone.offsetAt(1775318400 - 1));  // 2026-04-04 15:59:59 UTC
+    TEST_ASSERT_EQUAL_INT32(36000, zone.offsetAt(1775318400));      // 16:00 UTC, clocks go back
+    TEST_ASSERT_EQUAL_INT32(36000, zone.offsetAt(1791043200 - 1));  // 2026-10-03 15:59:59 UTC
+    TEST_ASSERT_EQUAL_INT32(39600, zone.offsetAt(1791043200));      // 16:00 UTC, clocks go forward
+
+    // 02:30 happens twice on 2026-04-05: the first (AEDT) one is taken
+    struct tm local = {};
+    local.tm_year = 2026 - 1900;
+    local.tm_mon = 3;
+    local.tm_mday = 5;
+    local.tm_hour = 2;
+    local.tm_min = 30;
+    TEST_ASSERT_EQUAL_UINT32(1775316600, (uint32_t)zone.toUtc(local));  // 2026-04-04 15:30 UTC
+}
+
+// ============================================
+// TimeManager
+// ============================================
+
+void test_time_manager_applies_posted_sync_in_loop() {
+    HalNative::useManualClock(true);
+    TimeManager clock;
+    clock.begin();
+
+    // Posted from the BLE task: nothing changes until loop() applies it
+    clock.postTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    clock.postTimestamp(1768392000);  // 2026-01-14 12:00:00 UTC
+    TEST_ASSERT_EQUAL_STRING(TIME_DEFAULT_TZ, clock.getTimeZone());
+    TEST_ASSERT_EQUAL_UINT8(TIME_PENDING_TIMESTAMP | TIME_PENDING_ZONE, clock.applyPending());
+    TEST_ASSERT_EQUAL_STRING("CET-1CEST,M3.5.0,M10.5.0/3", clock.getTimeZone());
+    TEST_ASSERT_EQUAL_INT(13, clock.snapshot().tm.tm_hour);
+    TEST_ASSERT_TRUE(clock.isSynced());
+    TEST_ASSERT_EQUAL_UINT8(0, clock.applyPending());
+
+    HalNative::useManualClock(false);
+}
+
+void test_time_manager_snapshot_marks_rollovers() {
+    HalNative::useManualClock(true);
+    TimeManager clock;
+    clock.begin();
+    clock.setTimestamp(1768431538);  // 2026-01-14 22:58:58 UTC
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_ALL, clock.snapshot().changed);
+
+    HalNative::advanceMillis(1000);
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_SECOND, clock.snapshot().changed);
+
+    HalNative::advanceMillis(1000);
+    const TimeSnapshot& snap = clock.snapshot();
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_SECOND | TIME_CHANGED_MINUTE, snap.changed);
+    TEST_ASSERT_EQUAL_STRING("22:59", snap.time24);
+
+    HalNative::advanceMillis(60 * 1000);
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_SECOND | TIME_CHANGED_MINUTE | TIME_CHANGED_HOUR, clock.snapshot().changed);
+
+    HalNative::advanceMillis(3600 * 1000);
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_ALL, clock.snapshot().changed);
+    TEST_ASSERT_EQUAL_STRING("Jan 15, 2026", clock.snapshot().date);
+
+    // A new zone reformats everything, even within the same second
+    clock.setTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    TEST_ASSERT_EQUAL_UINT8(TIME_CHANGED_ALL, clock.snapshot().changed);
+    TEST_ASSERT_EQUAL_STRING("01:00", clock.snapshot().time24);
+
+    HalNative::useManualClock(false);
+}
+
+void test_time_manager_restore_confidence() {
+    HalNative::useManualClock(true);
+    {
+        TimeManager clock;
+        clock.begin();
+        clock.setTimestamp(1768392000);  // 2026-01-14 12:00:00 UTC, synced
+    }
+
+    // Software reset: the RTC timer kept running
+    HalNative::advanceMillis(5000);
+    TimeManager afterReset;
+    afterReset.begin();
+    TEST_ASSERT_EQUAL_INT(TIME_CONFIDENCE_ESTIMATED, afterReset.getConfidence());
+    TEST_ASSERT_EQUAL_UINT32(1768392005, (uint32_t)afterReset.getTimestamp());
+
+    // Power loss: the RTC timer restarted, only the NVS checkpoint is left
+    HalNative::restartRtcTimer();
+    HalNative::advanceMillis(5000);
+    TimeManager afterPowerLoss;
+    afterPowerLoss.begin();
+    TEST_ASSERT_EQUAL_INT(TIME_CONFIDENCE_UNKNOWN, afterPowerLoss.getConfidence());
+    TEST_ASSERT_EQUAL_UINT32(1768392000, (uint32_t)afterPowerLoss.getTimestamp());
+
+    // A reset before the next sync carries the time, but it stays unknown
+    HalNative::advanceMillis(2000);
+    TimeManager unsyncedReset;
+    unsyncedReset.begin();
+    TEST_ASSERT_EQUAL_INT(TIME_CONFIDENCE_UNKNOWN, unsyncedReset.getConfidence());
+    TEST_ASSERT_EQUAL_UINT32(1768392002, (uint32_t)unsyncedReset.getTimestamp());
+
+    HalNative::useManualClock(false);
+}
+
+// ============================================
+// Profile scheduler
+// ============================================
+
+void test_profile_scheduler_crosses_midnight() {
+    ProfileScheduler scheduler;
+    TEST_ASSERT_TRUE(scheduler.update(NIGHT_START_MINUTE - 1));
+    TEST_ASSERT_EQUAL_STRING("day", scheduler.active().name);
+    TEST_ASSERT_EQUAL_UINT16(NIGHT_START_MINUTE, scheduler.nextBoundary());
+
+    TEST_ASSERT_TRUE(scheduler.update(NIGHT_START_MINUTE));
+    TEST_ASSERT_EQUAL_STRING("night", scheduler.active().name);
+    TEST_ASSERT_EQUAL_UINT16(NIGHT_END_MINUTE, scheduler.nextBoundary());
+
+    // Midnight is not a boundary
+    for (uint16_t minute = NIGHT_START_MINUTE + 1; minute < 24 * 60; minute++) {
+        TEST_ASSERT_FALSE(scheduler.update(minute));
+    }
+    TEST_ASSERT_FALSE(scheduler.update(0));
+    TEST_ASSERT_EQUAL_STRING("night", scheduler.active().name);
+
+    // A clock jump is re-evaluated, but stays within the night
+    TEST_ASSERT_FALSE(scheduler.update(NIGHT_END_MINUTE - 1));
+    TEST_ASSERT_TRUE(scheduler.update(NIGHT_END_MINUTE));
+    TEST_ASSERT_EQUAL_STRING("day", scheduler.active().name);
+    TEST_ASSERT_EQUAL_UINT16(NIGHT_START_MINUTE, scheduler.nextBoundary());
+
+    // Starting after midnight picks up the profile that began the day before
+    ProfileScheduler afterMidnight;
+    TEST_ASSERT_TRUE(afterMidnight.update(30));
+    TEST_ASSERT_EQUAL_STRING("night", afterMidnight.active().name);
+    TEST_ASSERT_EQUAL_UINT16(NIGHT_END_MINUTE, afterMidnight.nextBoundary());
+}
+
+// ============================================
+// AlarmManager
+// ============================================
+
+static uint8_t firedAlarm = 255;
+
+static void onAlarm(uint8_t alarmId) {
+    firedAlarm = alarmId;
+}
+
+void test_alarms_persist_in_nvs() {
+    AlarmData alarm;
+    alarm.id = 2;
+    alarm.hour = 7;
+    alarm.minute = 30;
+    alarm.daysOfWeek = 0x7F;
+    alarm.enabled = true;
+    {
+        AlarmManager manager;
+        TEST_ASSERT_TRUE(manager.begin());
+        TEST_ASSERT_TRUE(manager.setAlarm(alarm));
+    }
+
+    AlarmManager reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    AlarmData loaded;
+    TEST_ASSERT_TRUE(reloaded.getAlarm(2, loaded));
+    TEST_ASSERT_EQUAL_UINT8(7, loaded.hour);
+    TEST_ASSERT_EQUAL_UINT8(30, loaded.minute);
+    TEST_ASSERT_TRUE(loaded.enabled);
+}
+
+void test_alarm_fires_once_per_minute() {
+    AlarmManager manager;
+    TEST_ASSERT_TRUE(manager.begin());
+    AlarmData alarm;
+    alarm.id = 1;
+    alarm.hour = 6;
+    alarm.minute = 0;
+    alarm.daysOfWeek = 0x02;  // Monday
+    alarm.enabled = true;
+    TEST_ASSERT_TRUE(manager.setAlarm(alarm));
+    manager.setAlarmCallback(onAlarm);
+
+    firedAlarm = 255;
+    manager.checkAlarms(6, 0, 0);  // Sunday
+    TEST_ASSERT_EQUAL_UINT8(255, firedAlarm);
+    manager.checkAlarms(5, 59, 1);
+    manager.checkAlarms(6, 0, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, firedAlarm);
+    TEST_ASSERT_TRUE(manager.isAlarmRinging());
+}
+
+// ============================================
+// Filesystem stand-in
+// ============================================
+
+void test_spiffs_lists_files_below_directory() {
+    TEST_ASSERT_TRUE(SPIFFS.begin(true));
+    File file = SPIFFS.open("/alarms/wake.mp3", "w");
+    TEST_ASSERT_TRUE(file);
+    file.write((const uint8_t*)"ID3", 3);
+    file.close();
+    TEST_ASSERT_TRUE(SPIFFS.exists("/alarms/wake.mp3"));
+
+    File dir = SPIFFS.open("/alarms");
+    TEST_ASSERT_TRUE(dir.isDirectory());
+    File entry = dir.openNextFile();
+    TEST_ASSERT_TRUE(entry);
+    TEST_ASSERT_EQUAL_STRING("wake.mp3", entry.name());
+    TEST_ASSERT_EQUAL_UINT32(3, entry.size());
+    TEST_ASSERT_FALSE(dir.openNextFile());
+}
+
+// ============================================
+// Sound bank
+// ============================================
+
+static uint16_t appendSound(SoundBank& bank, const char* name, uint32_t length, uint8_t seed) {
+    uint8_t data[256];
+    TEST_ASSERT_TRUE(bank.beginAppend());
+    for (uint32_t done = 0; done < length; done += sizeof(data)) {
+        size_t n = (length - done < sizeof(data)) ? length - done : sizeof(data);
+        for (size_t i = 0; i < n; i++) {
+            data[i] = (uint8_t)(seed * 31 + done + i);
+        }
+        TEST_ASSERT_EQUAL_UINT32(n, bank.append(data, n));
+    }
+    uint8_t digest[SOUND_DIGEST_LEN] = { seed };
+    SoundProbe probe;
+    return bank.finishAppend(name, SOUND_CODEC_UNKNOWN, digest, probe);
+}
+
+void test_sound_bank_compacts_in_place_on_full_flash() {
+    TEST_ASSERT_TRUE(SPIFFS.begin(true));
+    SoundBank bank;
+    uint16_t a = appendSound(bank, "a.wav", 10000, 1);
+    uint16_t b = appendSound(bank, "b.wav", 20000, 2);
+    uint16_t c = appendSound(bank, "c.wav", 40000, 3);  // Longer than the gap it moves over
+    uint16_t d = appendSound(bank, "d.wav", 9000, 4);
+    uint32_t crcC = bank.payloadCrc(c);
+    uint32_t crcD = bank.payloadCrc(d);
+    SoundLocation first;
+    TEST_ASSERT_TRUE(bank.locate(a, first));
+
+    // Quarantine copies the payload out while there is room...
+    TEST_ASSERT_TRUE(bank.quarantine(a, "/bad/a.wav"));
+    File copy = SPIFFS.open("/bad/a.wav", "r");
+    TEST_ASSERT_EQUAL_UINT32(10000, copy.size());
+    copy.close();
+    TEST_ASSERT_TRUE(bank.remove(b));
+
+    // ...and keeps it in the bank when flash is full
+    HalNative::setFsCapacity(SPIFFS.usedBytes() + 1024);
+    TEST_ASSERT_TRUE(bank.quarantine(d, "/bad/d.wav"));
+    TEST_ASSERT_FALSE(SPIFFS.exists("/bad/d.wav"));
+    TEST_ASSERT_TRUE(bank.find(d) == nullptr);
+
+    // Compaction needs no free space: payloads slide down within the bank
+    TEST_ASSERT_EQUAL_UINT32(12288 + 20480, bank.deadBytes());
+    for (int step = 0; step < 8 && bank.deadBytes() > 0; step++) {
+        TEST_ASSERT_TRUE(bank.compactStep());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, bank.deadBytes());
+    TEST_ASSERT_EQUAL_UINT32(2, bank.count());
+    SoundLocation moved;
+    TEST_ASSERT_TRUE(bank.locate(c, moved));
+    TEST_ASSERT_EQUAL_UINT32(first.offset, moved.offset);
+    TEST_ASSERT_EQUAL_UINT32(crcC, bank.payloadCrc(c));
+    TEST_ASSERT_TRUE(bank.at(1).flags & SOUND_BANK_FLAG_QUARANTINED);
+    TEST_ASSERT_EQUAL_UINT32(first.offset + 40960, bank.at(1).offset);
+    TEST_ASSERT_FALSE(SPIFFS.exists(SOUND_BANK_JOURNAL_PATH));
+
+    SoundBank reloaded;
+    TEST_ASSERT_TRUE(reloaded.load());
+    TEST_ASSERT_EQUAL_UINT32(crcC, reloaded.payloadCrc(c));
+    File bankFile = SPIFFS.open(SOUND_BANK_PATH, "r");
+    TEST_ASSERT_EQUAL_UINT32(crcD, SoundCatalog::computeCrc(bankFile, reloaded.at(1).offset, 9000));
+    bankFile.close();
+
+    HalNative::setFsCapacity(1536 * 1024);
+}
+
+// ============================================
+// Task monitor
+// ============================================
+
+void test_stack_suggestion_keeps_margin() {
+    // Peak plus 25%, never less than the warning threshold, in 256-byte steps
+    TEST_ASSERT_EQUAL_UINT32(5120, TaskMonitor::suggestStackBytes(4000));
+    TEST_ASSERT_EQUAL_UINT32(1792, TaskMonitor::suggestStackBytes(1200));
+    TEST_ASSERT_EQUAL_UINT32(512, TaskMonitor::suggestStackBytes(0));
+    for (uint32_t peak = 0; peak < 16384; peak += 100) {
+        uint32_t suggested = TaskMonitor::suggestStackBytes(peak);
+        TEST_ASSERT_EQUAL_UINT32(0, suggested % 256);
+        TEST_ASSERT_TRUE(suggested - peak >= TASK_STACK_WARN_BYTES);
+    }
+}
+
+// ============================================
+// Loop monitor
+// ============================================
+
+void test_loop_monitor_attributes_stalls() {
+    HalNative::useManualClock(true);
+    LoopMonitor::begin();
+    LoopMonitor::reset();
+    uint32_t feeds = HalNative::taskWdtFeeds();
+
+    for (int i = 0; i < 100; i++) {
+        LoopMonitor::beginIteration();
+        HalNative::advanceMicros(i == 99 ? 150000 : 1000);  // One BLE stall over the 100 ms budget
+        LoopMonitor::endStage(LOOP_STAGE_BLE);
+        HalNative::advanceMicros(500);
+        LoopMonitor::endStage(LOOP_STAGE_DISPLAY);
+        LoopMonitor::endIteration();
+    }
+    const LoopMonitor::StageStats& ble = LoopMonitor::stats(LOOP_STAGE_BLE);
+    TEST_ASSERT_EQUAL_UINT32(100, ble.count);
+    TEST_ASSERT_EQUAL_UINT32(150000, ble.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(1, ble.stalls);
+    TEST_ASSERT_EQUAL_UINT32(1024, LoopMonitor::percentileUs(ble, 99));  // Bucket bound above 1000 us
+    TEST_ASSERT_EQUAL_UINT32(150000, LoopMonitor::percentileUs(ble, 100));
+    TEST_ASSERT_EQUAL_UINT32(0, LoopMonitor::stats(LOOP_STAGE_DISPLAY).stalls);
+    TEST_ASSERT_EQUAL_UINT32(150500, LoopMonitor::stats(LoopMonitor::TOTAL).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(100, HalNative::taskWdtFeeds() - feeds);
+    TEST_ASSERT_EQUAL_UINT32(0, HalNative::taskWdtTimeout());  // Shared watchdog settings left alone
+
+    // The watchdog fires after the timers stage: the next boot blames the alarm stage
+    LoopMonitor::beginIteration();
+    LoopMonitor::endStage(LOOP_STAGE_TIMERS);
+    HalNative::setResetReason(ESP_RST_TASK_WDT);
+    LoopMonitor::begin();
+    TEST_ASSERT_TRUE(LoopMonitor::watchdogStage() == LOOP_STAGE_ALARM);
+    HalNative::setResetReason(ESP_RST_POWERON);
+    LoopMonitor::begin();
+    TEST_ASSERT_TRUE(LoopMonitor::watchdogStage() == LoopMonitor::NO_STAGE);
+
+    LoopMonitor::reset();
+    HalNative::useManualClock(false);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_wav_skips_unknown_chunks);
+    RUN_TEST(test_wav_clamps_data_to_sound_length);
+    RUN_TEST(test_wav_rejects_bad_input);
+    RUN_TEST(test_alarm_json_round_trip);
+    RUN_TEST(test_alarm_json_requires_time);
+    RUN_TEST(test_fixed_string_truncates_without_overflow);
+    RUN_TEST(test_string_view_splits_fields);
+    RUN_TEST(test_object_slot_reuses_storage_without_heap);
+    RUN_TEST(test_board_pins_rejects_conflicts);
+    RUN_TEST(test_settings_coalesce_slider_writes);
+    RUN_TEST(test_frontlight_holds_level_during_fade);
+    RUN_TEST(test_timer_wheel_rounds_expiry_up);
+    RUN_TEST(test_timer_wheel_periodic_stays_phase_locked);
+    RUN_TEST(test_timer_wheel_stale_handle_ignored);
+    RUN_TEST(test_time_zone_dst_offsets);
+    RUN_TEST(test_time_zone_resolves_repeated_and_skipped_hours);
+    RUN_TEST(test_time_zone_southern_hemisphere_rule);
+    RUN_TEST(test_time_manager_applies_posted_sync_in_loop);
+    RUN_TEST(test_time_manager_snapshot_marks_rollovers);
+    RUN_TEST(test_time_manager_restore_confidence);
+    RUN_TEST(test_profile_scheduler_crosses_midnight);
+    RUN_TEST(test_alarms_persist_in_nvs);
+    RUN_TEST(test_alarm_fires_once_per_minute);
+    RUN_TEST(test_spiffs_lists_files_below_directory);
+    RUN_TEST(test_sound_bank_compacts_in_place_on_full_flash);
+    RUN_TEST(test_stack_suggestion_keeps_margin);
+    RUN_TEST(test_loop_monitor_attributes_stalls);
+    return UNITY_END();
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare benchmark output against a stored baseline.
+
+Reads the BENCH lines printed by test/test_bench (from a file or stdin):
+
+    pio test -e native -f test_bench -v | tools/bench_compare.py test/test_bench/baseline_native.json
+
+A benchmark regresses when its ns_per_op grows by more than --tolerance
+(default 25%) or its allocs_per_op grows at all. Exit status is 1 on any
+regression or missing benchmark. --update rewrites the baseline instead.
+"""
+
+import argparse
+import json
+import sys
+
+ALLOC_SLACK = 0.001
+
+
+def read_results(stream):
+    results = {}
+    for line in stream:
+        start = line.find("BENCH {")
+        if start < 0:
+            continue
+        entry = json.loads(line[start + len("BENCH "):])
+        results[entry["name"]] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="baseline JSON file")
+    parser.add_argument("output", nargs="?", help="benchmark output (default: stdin)")
+    parser.add_argument("--tolerance", type=float, default=0.25, help="allowed ns_per_op growth (fraction)")
+    parser.add_argument("--update", action="store_true", help="write the results as the new baseline")
+    args = parser.parse_args()
+
+    if args.output:
+        with open(args.output) as f:
+            results = read_results(f)
+    else:
+        results = read_results(sys.stdin)
+    if not results:
+        print("bench_compare: no BENCH lines found", file=sys.stderr)
+        return 1
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"bench_compare: wrote {len(results)} benchmarks to {args.baseline}")
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    failed = False
+    print(f"{'benchmark':32} {'ns/op':>10} {'base':>10} {'change':>8} {'allocs':>7} {'base':>7}")
+    for name in sorted(set(baseline) | set(results)):
+        base = baseline.get(name)
+        now = results.get(name)
+        if now is None:
+            print(f"{name:32} {'missing':>10}")
+            failed = True
+            continue
+        if base is None:
+            print(f"{name:32} {now['ns_per_op']:10.1f} {'new':>10}")
+            continue
+
+        change = now["ns_per_op"] / base["ns_per_op"] - 1 if base["ns_per_op"] else 0.0
+        flags = []
+        if change > args.tolerance:
+            flags.append("SLOWER")
+        if now["allocs_per_op"] > base["allocs_per_op"] + ALLOC_SLACK:
+            flags.append("MORE ALLOCS")
+        failed = failed or bool(flags)
+        print(f"{name:32} {now['ns_per_op']:10.1f} {base['ns_per_op']:10.1f} {change:+8.1%} "
+              f"{now['allocs_per_op']:7.3f} {base['allocs_per_op']:7.3f} {' '.join(flags)}")
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Convert a "trace dump" serial capture to Chrome trace JSON.
+
+    tools/trace_to_chrome.py capture.txt > trace.json
+
+Open the result in chrome://tracing or https://ui.perfetto.dev. Lines
+not starting with "TRACE" (other serial output) are ignored, so a whole
+monitor log can be passed in; the last complete dump is used.
+"""
+
+import argparse
+import json
+import sys
+
+PHASES = {"B": "B", "E": "E", "I": "i"}
+
+
+def parse_dump(lines):
+    """Return (tasks, names, events) of the last complete dump."""
+    dump = None
+    current = None
+    for line in lines:
+        start = line.find("TRACE ")
+        if start < 0:
+            continue
+        fields = line[start:].split()
+        kind = fields[1]
+        if kind == "begin":
+            current = {"tasks": {}, "names": {}, "events": []}
+        elif current is None:
+            continue
+        elif kind == "task":
+            current["tasks"][int(fields[2])] = " ".join(fields[3:])
+        elif kind == "name":
+            current["names"][int(fields[2])] = fields[3]
+        elif kind == "e":
+            us, phase, task, event_id, arg = fields[2:7]
+            current["events"].append((int(us), phase, int(task), int(event_id), int(arg)))
+        elif kind == "end":
+            dump = current
+            current = None
+    return dump
+
+
+def to_chrome(dump):
+    events = []
+    for task, name in dump["tasks"].items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": task, "args": {"name": name}})
+
+    # Timestamps are the low 32 bits of esp_timer (wrap every ~71 minutes)
+    base = None
+    offset = 0
+    previous = None
+    for us, phase, task, event_id, arg in dump["events"]:
+        if previous is not None and us < previous and previous - us > 1 << 31:
+            offset += 1 << 32
+        previous = us
+        ts = us + offset
+        if base is None:
+            base = ts
+        event = {
+            "name": dump["names"].get(event_id, f"id{event_id}"),
+            "ph": PHASES.get(phase, "i"),
+            "ts": ts - base,
+            "pid": 1,
+            "tid": task,
+        }
+        if phase == "I":
+            event["s"] = "t"
+        if arg or phase != "E":
+            event["args"] = {"arg": arg}
+        events.append(event)
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="serial capture (default: stdin)")
+    args = parser.parse_args()
+
+    if args.capture:
+        with open(args.capture, errors="replace") as f:
+            dump = parse_dump(f)
+    else:
+        dump = parse_dump(sys.stdin)
+    if dump is None:
+        print("trace_to_chrome: no complete TRACE dump found", file=sys.stderr)
+        return 1
+
+    json.dump(to_chrome(dump), sys.stdout)
+    print()
+    print(f"trace_to_chrome: {len(dump['events'])} events, {len(dump['tasks'])} tasks", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())